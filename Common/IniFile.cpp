@@ -0,0 +1,34 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "IniFile.h"
+#include "FileUtil.h"
+#include "StringUtil.h"
+
+namespace IniFile {
+
+namespace {
+
+std::wstring WidenAnsi(const char* str, size_t length)
+{
+	return StringUtil::Widen(str, (int)length);
+}
+
+}  // namespace
+
+bool Read(const std::wstring& path, std::vector<Section>& sections)
+{
+	size_t size = 0;
+	std::unique_ptr<BYTE[]> buffer = FileUtil::ReadFullFile(path, &size);
+	if (!buffer) return false;
+
+	ParseBuffer((const char*)buffer.get(), size, WidenAnsi, sections);
+	return true;
+}
+
+}  // namespace IniFile
@@ -0,0 +1,22 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef RM_COMMON_INIFILE_H_
+#define RM_COMMON_INIFILE_H_
+
+#include <string>
+#include <vector>
+#include "IniFileParser.h"
+
+namespace IniFile {
+
+// Reads and parses |path| with ParseBuffer(). The file can be UTF-16LE or ANSI.
+bool Read(const std::wstring& path, std::vector<Section>& sections);
+
+}  // namespace IniFile
+
+#endif
@@ -0,0 +1,137 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+// Does not use the precompiled header (see IniFileParser.h).
+#include "IniFileParser.h"
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <unordered_set>
+
+namespace IniFile {
+
+namespace {
+
+bool IsSpace(wchar_t ch)
+{
+	// GetPrivateProfileString() also treats the DOS end-of-file character as whitespace.
+	return std::iswspace(ch) || ch == 0x1A;
+}
+
+std::wstring ToUpper(const wchar_t* str, size_t length)
+{
+	std::wstring upper(str, length);
+	for (auto& ch : upper)
+	{
+		ch = (wchar_t)std::towupper(ch);
+	}
+	return upper;
+}
+
+std::wstring DecodeUTF16LE(const char* data, size_t size)
+{
+	std::wstring str(size / 2, L'\0');
+#if WCHAR_MAX <= 0xFFFF
+	if (!str.empty())
+	{
+		memcpy(&str[0], data, str.length() * sizeof(wchar_t));
+	}
+#else
+	// Combine the surrogate pairs for the wider wchar_t.
+	size_t length = 0;
+	for (size_t i = 0; i + 1 < size; i += 2)
+	{
+		const wchar_t unit = (wchar_t)((unsigned char)data[i] | ((unsigned char)data[i + 1] << 8));
+		if (unit >= 0xDC00 && unit <= 0xDFFF && length > 0 && str[length - 1] >= 0xD800 && str[length - 1] <= 0xDBFF)
+		{
+			str[length - 1] = 0x10000 + ((str[length - 1] - 0xD800) << 10) + (unit - 0xDC00);
+		}
+		else
+		{
+			str[length++] = unit;
+		}
+	}
+	str.resize(length);
+#endif
+	return str;
+}
+
+}  // namespace
+
+void Parse(const wchar_t* str, size_t length, std::vector<Section>& sections)
+{
+	std::unordered_set<std::wstring> unique;
+	Section* current = nullptr;  // nullptr before the first section or within a skipped section
+
+	const wchar_t* pos = str;
+	const wchar_t* end = str + length;
+	while (pos < end)
+	{
+		// Find the next line and trim it.
+		const wchar_t* lineEnd = pos;
+		while (lineEnd < end && *lineEnd != L'\n' && *lineEnd != L'\r') ++lineEnd;
+
+		const wchar_t* line = pos;
+		pos = lineEnd + 1;
+
+		while (line < lineEnd && IsSpace(*line)) ++line;
+		while (lineEnd > line && IsSpace(lineEnd[-1])) --lineEnd;
+		if (line == lineEnd || *line == L';') continue;
+
+		if (*line == L'[')
+		{
+			// The section name ends at the first bracket on the line.
+			const wchar_t* name = line + 1;
+			const wchar_t* nameEnd = name;
+			while (nameEnd < lineEnd && *nameEnd != L']') ++nameEnd;
+
+			while (name < nameEnd && IsSpace(*name)) ++name;
+			while (nameEnd > name && IsSpace(nameEnd[-1])) --nameEnd;
+
+			current = nullptr;
+			if (name != nameEnd && unique.insert(ToUpper(name, nameEnd - name)).second)
+			{
+				sections.emplace_back();
+				current = &sections.back();
+				current->name.assign(name, nameEnd - name);
+			}
+			continue;
+		}
+
+		if (!current) continue;
+
+		const wchar_t* sep = line;
+		while (sep < lineEnd && *sep != L'=') ++sep;
+		if (sep == lineEnd) continue;
+
+		const wchar_t* keyEnd = sep;
+		while (keyEnd > line && IsSpace(keyEnd[-1])) --keyEnd;
+		if (keyEnd == line) continue;
+
+		const wchar_t* value = sep + 1;
+		while (value < lineEnd && IsSpace(*value)) ++value;
+
+		current->keys.emplace_back(
+			std::wstring(line, keyEnd - line), std::wstring(value, lineEnd - value));
+	}
+}
+
+void ParseBuffer(const char* data, size_t size, WidenFunc widen, std::vector<Section>& sections)
+{
+	if (size >= 2 && (unsigned char)data[0] == 0xFF && (unsigned char)data[1] == 0xFE)
+	{
+		const std::wstring str = DecodeUTF16LE(data + 2, size - 2);
+		Parse(str.c_str(), str.length(), sections);
+	}
+	else
+	{
+		const std::wstring str = widen(data, size);
+		Parse(str.c_str(), str.length(), sections);
+	}
+}
+
+}  // namespace IniFile
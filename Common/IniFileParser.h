@@ -0,0 +1,44 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef RM_COMMON_INIFILEPARSER_H_
+#define RM_COMMON_INIFILEPARSER_H_
+
+// The parsing core of IniFile. This file and IniFileParser.cpp only use the standard library so
+// that the parser can also be built, tested and benchmarked on other platforms.
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IniFile {
+
+struct Section
+{
+	std::wstring name;
+	std::vector<std::pair<std::wstring, std::wstring>> keys;  // Key names and values in file order
+};
+
+// Converts text in the system code page (i.e. CP_ACP on Windows) to UTF-16.
+typedef std::wstring (*WidenFunc)(const char* str, size_t length);
+
+// Parses the contents of an ini file in a single pass. The result matches what
+// GetPrivateProfileSectionNames() and GetPrivateProfileSection() would return: lines are trimmed,
+// comments (;) and lines without a key are skipped, and only the first occurrence of a section
+// (compared case-insensitively) is used. A section name ends at the first bracket on its line and
+// the keys of a section without a name (e.g. "[]") are skipped. Duplicate keys are kept.
+void Parse(const wchar_t* str, size_t length, std::vector<Section>& sections);
+
+// Decodes and parses the raw contents of an ini file like the profile API does: the file is
+// UTF-16LE if it starts with the UTF-16LE BOM and is converted with |widen| otherwise. A UTF-8 BOM
+// is not recognized, so it is converted along with the first line.
+void ParseBuffer(const char* data, size_t size, WidenFunc widen, std::vector<Section>& sections);
+
+}  // namespace IniFile
+
+#endif
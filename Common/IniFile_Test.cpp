@@ -0,0 +1,280 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "IniFile.h"
+#include "Timer.h"
+#include "UnitTest.h"
+#include <unordered_set>
+
+namespace IniFile {
+
+TEST_CLASS(Common_IniFile_Test)
+{
+public:
+	TEST_METHOD_CLEANUP(Cleanup)
+	{
+		for (const auto& path : m_Files)
+		{
+			DeleteFile(path.c_str());
+		}
+		m_Files.clear();
+	}
+
+	static std::vector<Section> ParseString(const WCHAR* str)
+	{
+		std::vector<Section> sections;
+		Parse(str, wcslen(str), sections);
+		return sections;
+	}
+
+	// Stands in for the system code page on other platforms.
+	static std::wstring WidenLatin1(const char* str, size_t length)
+	{
+		std::wstring wideStr(length, L'\0');
+		for (size_t i = 0; i < length; ++i)
+		{
+			wideStr[i] = (WCHAR)(unsigned char)str[i];
+		}
+		return wideStr;
+	}
+
+	static void AssertEqual(const std::vector<Section>& expected, const std::vector<Section>& actual)
+	{
+		Assert::AreEqual(expected.size(), actual.size());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			Assert::AreEqual(expected[i].name.c_str(), actual[i].name.c_str());
+			Assert::AreEqual(expected[i].keys.size(), actual[i].keys.size());
+			for (size_t j = 0; j < expected[i].keys.size(); ++j)
+			{
+				Assert::AreEqual(expected[i].keys[j].first.c_str(), actual[i].keys[j].first.c_str());
+				Assert::AreEqual(expected[i].keys[j].second.c_str(), actual[i].keys[j].second.c_str());
+			}
+		}
+	}
+
+	std::wstring CreateTempFile(const void* contents, size_t size)
+	{
+		WCHAR dir[MAX_PATH];
+		WCHAR path[MAX_PATH];
+		GetTempPath(_countof(dir), dir);
+		Assert::AreNotEqual(0U, GetTempFileName(dir, L"ini", 0, path));
+		m_Files.push_back(path);
+
+		HANDLE file = CreateFile(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		Assert::IsTrue(file != INVALID_HANDLE_VALUE);
+
+		DWORD written = 0UL;
+		WriteFile(file, contents, (DWORD)size, &written, nullptr);
+		CloseHandle(file);
+		return path;
+	}
+
+	// Reads |path| with the profile API the way ConfigParser did before it used IniFile.
+	static std::vector<Section> ReadProfile(const std::wstring& path)
+	{
+		std::vector<Section> sections;
+		std::vector<WCHAR> names(1024 * 1024);
+		std::vector<WCHAR> keys(1024 * 1024);
+		std::unordered_set<std::wstring> unique;
+
+		const DWORD namesSize = GetPrivateProfileSectionNames(names.data(), (DWORD)names.size(), path.c_str());
+		for (const WCHAR* name = names.data(); name < names.data() + namesSize; name += wcslen(name) + 1)
+		{
+			std::wstring upper = name;
+			if (upper.empty() || !unique.insert(_wcsupr(&upper[0])).second) continue;
+
+			sections.emplace_back();
+			Section& section = sections.back();
+			section.name = name;
+
+			const DWORD keysSize = GetPrivateProfileSection(name, keys.data(), (DWORD)keys.size(), path.c_str());
+			for (const WCHAR* key = keys.data(); key < keys.data() + keysSize; key += wcslen(key) + 1)
+			{
+				const WCHAR* sep = wcschr(key, L'=');
+				if (sep && sep != key && *key != L';')
+				{
+					section.keys.emplace_back(std::wstring(key, sep), std::wstring(sep + 1));
+				}
+			}
+		}
+
+		return sections;
+	}
+
+	TEST_METHOD(TestParse)
+	{
+		const std::vector<Section> sections = ParseString(
+			L"Ignored=before first section\r\n"
+			L"[Rainmeter]\r\n"
+			L"Update=1000\r\n"
+			L"  ; Comment=ignored\r\n"
+			L"   AccurateText  =   1   \r\n"
+			L"NoValue\r\n"
+			L"=NoKey\r\n"
+			L"Empty=\r\n"
+			L"\r\n"
+			L"[  Meter ]  \n"
+			L"Text=\"Quoted=kept\"\n"
+			L"Text=Duplicate\n"
+			L"[rainmeter]\n"
+			L"Update=500\n"
+			L"[]\n"
+			L"Lost=1\n"
+			L"[]]\n"
+			L"Lost=2\n"
+			L"[Last]Ignored]");
+
+		Assert::AreEqual((size_t)3, sections.size());
+
+		Assert::AreEqual(L"Rainmeter", sections[0].name.c_str());
+		Assert::AreEqual((size_t)3, sections[0].keys.size());
+		Assert::AreEqual(L"Update", sections[0].keys[0].first.c_str());
+		Assert::AreEqual(L"1000", sections[0].keys[0].second.c_str());
+		Assert::AreEqual(L"AccurateText", sections[0].keys[1].first.c_str());
+		Assert::AreEqual(L"1", sections[0].keys[1].second.c_str());
+		Assert::AreEqual(L"Empty", sections[0].keys[2].first.c_str());
+		Assert::AreEqual(L"", sections[0].keys[2].second.c_str());
+
+		// Quotes are trimmed by ConfigParser and duplicate keys are kept.
+		Assert::AreEqual(L"Meter", sections[1].name.c_str());
+		Assert::AreEqual((size_t)2, sections[1].keys.size());
+		Assert::AreEqual(L"\"Quoted=kept\"", sections[1].keys[0].second.c_str());
+		Assert::AreEqual(L"Duplicate", sections[1].keys[1].second.c_str());
+
+		// The name ends at the first bracket.
+		Assert::AreEqual(L"Last", sections[2].name.c_str());
+		Assert::IsTrue(sections[2].keys.empty());
+
+		Assert::IsTrue(ParseString(L"").empty());
+		Assert::IsTrue(ParseString(L"Key=Value").empty());
+	}
+
+	TEST_METHOD(TestParseBuffer)
+	{
+		// UTF-16LE with BOM.
+		const char utf16[] = "\xFF\xFE[\0A\0]\0\n\0K\0=\0\x22\x04\n\0";
+		std::vector<Section> sections;
+		ParseBuffer(utf16, sizeof(utf16) - 1, WidenLatin1, sections);
+		Assert::AreEqual((size_t)1, sections.size());
+		Assert::AreEqual(L"A", sections[0].name.c_str());
+		Assert::AreEqual(L"\u0422", sections[0].keys[0].second.c_str());
+
+		// The UTF-8 BOM is part of the first line, so a section on that line is not found. The
+		// other lines are not decoded as UTF-8 either.
+		const char utf8[] = "\xEF\xBB\xBF[A]\nK=1\n[B]\nK=\xD0\xA2\n";
+		sections.clear();
+		ParseBuffer(utf8, sizeof(utf8) - 1, WidenLatin1, sections);
+		Assert::AreEqual((size_t)1, sections.size());
+		Assert::AreEqual(L"B", sections[0].name.c_str());
+		Assert::AreEqual(L"\u00D0\u00A2", sections[0].keys[0].second.c_str());
+	}
+
+	TEST_METHOD(TestProfileParity)
+	{
+		const char contents[] =
+			"Ignored=1\r\n"
+			"[Rainmeter]\r\n"
+			"Update=1000\r\n"
+			"; Comment=1\r\n"
+			"   AccurateText  =   1   \r\n"
+			"NoValue\r\n"
+			"=NoKey\r\n"
+			"Empty=\r\n"
+			"\r\n"
+			"[Meter]Ignored]\r\n"
+			"Text=\"Quoted=kept\"\r\n"
+			"[rainmeter]\r\n"
+			"Update=500\r\n"
+			"[]\r\n"
+			"Lost=1\r\n"
+			"[Last]\r\n"
+			"Value=1";
+
+		// ANSI.
+		std::wstring path = CreateTempFile(contents, sizeof(contents) - 1);
+		std::vector<Section> sections;
+		Assert::IsTrue(Read(path, sections));
+		AssertEqual(ReadProfile(path), sections);
+		Assert::AreEqual((size_t)3, sections.size());
+
+		// UTF-8 with BOM. The section on the first line is not found.
+		std::string utf8 = "\xEF\xBB\xBF[First]\r\nValue=1\r\n";
+		utf8 += contents;
+		utf8 += "\r\n[Utf8]\r\nValue=\xD0\xA2";
+		path = CreateTempFile(utf8.c_str(), utf8.length());
+		sections.clear();
+		Assert::IsTrue(Read(path, sections));
+		AssertEqual(ReadProfile(path), sections);
+		Assert::AreEqual((size_t)4, sections.size());
+		Assert::AreEqual(L"Rainmeter", sections[0].name.c_str());
+
+		// UTF-16LE with BOM.
+		std::wstring utf16 = L"\xFEFF";
+		utf16.append(contents, contents + sizeof(contents) - 1);
+		utf16 += L"\r\n[Utf16]\r\nValue=\u0422";
+		path = CreateTempFile(utf16.c_str(), utf16.length() * sizeof(WCHAR));
+		sections.clear();
+		Assert::IsTrue(Read(path, sections));
+		AssertEqual(ReadProfile(path), sections);
+		Assert::AreEqual((size_t)4, sections.size());
+		Assert::AreEqual(L"\u0422", sections[3].keys[0].second.c_str());
+	}
+
+	TEST_METHOD(TestParseBenchmark)
+	{
+		std::wstring str = L"\xFEFF";
+		for (int i = 0; i < 2000; ++i)
+		{
+			str += L"[Meter";
+			str += std::to_wstring(i);
+			str += L"]\r\nMeter=String\r\nMeasureName=Measure";
+			str += std::to_wstring(i);
+			str += L"\r\nX=0R\r\nY=0r\r\nFontColor=255,255,255,200\r\nText=Value: %1\r\n\r\n";
+		}
+
+		const int iterations = 20;
+
+		Timer timer;
+		timer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			std::vector<Section> sections;
+			Parse(str.c_str() + 1, str.length() - 1, sections);
+			Assert::AreEqual((size_t)2000, sections.size());
+		}
+		timer.Stop();
+		const double parseTime = timer.GetElapsed() / iterations;
+
+		// Reading the file once must be faster than reading it with the profile API, which reads
+		// the file again for each section.
+		const std::wstring path = CreateTempFile(str.c_str(), str.length() * sizeof(WCHAR));
+		std::vector<Section> sections;
+		timer.Start();
+		Assert::IsTrue(Read(path, sections));
+		timer.Stop();
+		const double readTime = timer.GetElapsed();
+
+		timer.Start();
+		const std::vector<Section> profileSections = ReadProfile(path);
+		timer.Stop();
+		const double profileTime = timer.GetElapsed();
+
+		AssertEqual(profileSections, sections);
+		Assert::IsTrue(readTime < profileTime);
+
+		WCHAR buffer[128];
+		_snwprintf_s(buffer, _TRUNCATE, L"Parse (2000 sections): %.2f ms, Read: %.2f ms, profile API: %.2f ms\n",
+			parseTime, readTime, profileTime);
+		Logger::WriteMessage(buffer);
+	}
+
+private:
+	std::vector<std::wstring> m_Files;
+};
+
+}  // namespace IniFile
@@ -202,6 +202,9 @@ static CharType GetCharType(WCHAR ch);
 static BYTE GetFunctionIndex(const WCHAR* str, BYTE len);
 static Operator GetOperator(const WCHAR* str);
 
+static const WCHAR* ApplyOperator(Operator oper, double left, double right, double* result);
+
+// Evaluates the formula while it is being parsed.
 struct Parser
 {
 	Operation opStack[96];
@@ -210,11 +213,55 @@ struct Parser
 	char valTop;
 	int obrDist;
 
-	Parser() : opStack(), numStack(), opTop(0), valTop(-1), obrDist(2) { opStack[0].type = Operator::OpeningBracket; }
+	GetValueFunc getValue;
+	void* getValueContext;
+
+	Parser(GetValueFunc getValue, void* getValueContext) : opStack(), numStack(), opTop(0), valTop(-1), obrDist(2),
+		getValue(getValue), getValueContext(getValueContext) { opStack[0].type = Operator::OpeningBracket; }
+
+	void PushNumber(double value) { numStack[++valTop] = value; }
+	bool PushName(const WCHAR* name, int len);
+	const WCHAR* Calc();
+};
+
+// Value on the compile-time stack. The instructions producing the value start at |start|.
+struct Operand
+{
+	size_t start;
+	bool constant;
+	double value;
+};
+
+// Emits postfix instructions into |program| instead of evaluating the formula. Operations with only
+// constant operands are evaluated immediately and replaced with a single number.
+struct Compiler
+{
+	Operation opStack[96];
+	Operand numStack[64];
+	char opTop;
+	char valTop;
+	int obrDist;
+
+	Program& program;
+	ResolveNameFunc resolveName;
+	void* resolveNameContext;
+
+	Compiler(Program& program, ResolveNameFunc resolveName, void* resolveNameContext) : opStack(), numStack(), opTop(0), valTop(-1), obrDist(2),
+		program(program), resolveName(resolveName), resolveNameContext(resolveNameContext) { opStack[0].type = Operator::OpeningBracket; }
+
+	void PushNumber(double value);
+	bool PushName(const WCHAR* name, int len);
+	const WCHAR* Calc();
+
+	void Emit(Opcode opcode, BYTE index = 0, BYTE count = 0);
+	void Fold(size_t start, double value);
 };
 
-static const WCHAR* CalcToObr(Parser& parser);
-static const WCHAR* Calc(Parser& parser);
+template <typename T>
+static const WCHAR* Run(T& parser, const WCHAR* formula);
+
+template <typename T>
+static const WCHAR* CalcToObr(T& parser);
 
 struct Lexer
 {
@@ -279,15 +326,120 @@ const WCHAR* CheckedParse(const WCHAR* formula, double* result)
 const WCHAR* Parse(
 	const WCHAR* formula, double* result, GetValueFunc getValue, void* getValueContext)
 {
-	static WCHAR errorBuffer[128];
-
 	if (!*formula)
 	{
 		*result = 0.0;
 		return nullptr;
 	}
 
-	Parser parser;
+	Parser parser(getValue, getValueContext);
+	const WCHAR* error = Run(parser, formula);
+	if (!error)
+	{
+		*result = parser.numStack[0];
+	}
+	return error;
+}
+
+/*
+** Compiles the formula into |program|, which can then be repeatedly evaluated with Evaluate()
+** without tokenizing the formula again. Names that are not functions are passed to |resolveName|,
+** which must map them to a slot. On error, |program| is cleared.
+**
+*/
+const WCHAR* Compile(
+	const WCHAR* formula, Program& program, ResolveNameFunc resolveName, void* resolveNameContext)
+{
+	program.Clear();
+
+	if (!*formula)
+	{
+		Instruction zero = {};
+		zero.opcode = Opcode::Number;
+		zero.value = 0.0;
+		program.code.push_back(zero);
+		return nullptr;
+	}
+
+	Compiler compiler(program, resolveName, resolveNameContext);
+	const WCHAR* error = Run(compiler, formula);
+	if (error)
+	{
+		program.Clear();
+	}
+	else
+	{
+		program.code.shrink_to_fit();
+	}
+	return error;
+}
+
+/*
+** Evaluates a program created with Compile().
+**
+*/
+const WCHAR* Evaluate(
+	const Program& program, double* result, GetSlotValueFunc getSlotValue, void* getSlotValueContext)
+{
+	// The stack never grows deeper than the value stack used during compilation.
+	double stack[64];
+	int top = -1;
+
+	for (const auto& instruction : program.code)
+	{
+		switch (instruction.opcode)
+		{
+		case Opcode::Number:
+			stack[++top] = instruction.value;
+			break;
+
+		case Opcode::Slot:
+			if (!getSlotValue) return eInternal;
+			stack[++top] = getSlotValue(instruction.slot, getSlotValueContext);
+			break;
+
+		case Opcode::Unary:
+			stack[top] = (double)(~((long long)stack[top]));
+			break;
+
+		case Opcode::Binary:
+			{
+				const WCHAR* error = ApplyOperator((Operator)instruction.index, stack[top - 1], stack[top], &stack[top - 1]);
+				if (error) return error;
+				--top;
+			}
+			break;
+
+		case Opcode::Function:
+			stack[top] = (*(SingleArgFunction)g_Functions[instruction.index].proc)(stack[top]);
+			break;
+
+		case Opcode::MultiFunction:
+			{
+				top -= instruction.count;
+				double res;
+				const WCHAR* error = (*(MultiArgFunction)g_Functions[instruction.index].proc)(instruction.count, &stack[top + 1], &res);
+				if (error) return error;
+				stack[++top] = res;
+			}
+			break;
+
+		case Opcode::Conditional:
+			top -= 2;
+			stack[top] = stack[top] ? stack[top + 1] : stack[top + 2];
+			break;
+		}
+	}
+
+	*result = (top == 0) ? stack[0] : 0.0;
+	return nullptr;
+}
+
+template <typename T>
+static const WCHAR* Run(T& parser, const WCHAR* formula)
+{
+	static WCHAR errorBuffer[128];
+
 	Lexer lexer(formula);
 
 	const WCHAR* error;
@@ -318,13 +470,12 @@ const WCHAR* Parse(
 			else
 			{
 				// Done!
-				*result = parser.numStack[0];
 				return nullptr;
 			}
 			break;
 
 		case Token::Number:
-			parser.numStack[++parser.valTop] = lexer.value.num;
+			parser.PushNumber(lexer.value.num);
 			break;
 
 		case Token::Operator:
@@ -391,7 +542,7 @@ const WCHAR* Parse(
 
 					while (g_OpPriorities[(int)op.type] <= g_OpPriorities[(int)parser.opStack[parser.opTop].type])
 					{
-						if ((error = Calc(parser)) != nullptr) return error;
+						if ((error = parser.Calc()) != nullptr) return error;
 					}
 					parser.opStack[++parser.opTop] = op;
 				}
@@ -408,11 +559,11 @@ const WCHAR* Parse(
 					switch (op.funcIndex)
 					{
 					case FUNC_E:
-						parser.numStack[++parser.valTop] = M_E;
+						parser.PushNumber(M_E);
 						break;
 
 					case FUNC_PI:
-						parser.numStack[++parser.valTop] = M_PI;
+						parser.PushNumber(M_PI);
 						break;
 
 					case FUNC_ATAN2:
@@ -431,15 +582,8 @@ const WCHAR* Parse(
 						break;
 					}
 				}
-				else
+				else if (!parser.PushName(lexer.name, (int)lexer.nameLen))
 				{
-					double dblval;
-					if (getValue && getValue(lexer.name, (int)lexer.nameLen, &dblval, getValueContext))
-					{
-						parser.numStack[++parser.valTop] = dblval;
-						break;
-					}
-
 					const std::wstring name(lexer.name, lexer.nameLen);
 					_snwprintf_s(errorBuffer, _TRUNCATE, eUnknFunc, name.c_str());
 					return errorBuffer;
@@ -453,10 +597,22 @@ const WCHAR* Parse(
 	}
 }
 
-static const WCHAR* Calc(Parser& parser)
+bool Parser::PushName(const WCHAR* name, int len)
+{
+	double dblval;
+	if (getValue && getValue(name, len, &dblval, getValueContext))
+	{
+		PushNumber(dblval);
+		return true;
+	}
+
+	return false;
+}
+
+const WCHAR* Parser::Calc()
 {
 	double res;
-	Operation op = parser.opStack[parser.opTop--];
+	Operation op = opStack[opTop--];
 
 	// Multi-argument function
 	if (op.type == Operator::Conditional)
@@ -465,22 +621,22 @@ static const WCHAR* Calc(Parser& parser)
 	}
 	else if (op.type == Operator::MultiArgFunction)
 	{
-		int paramcnt = parser.valTop - op.prevTop;
+		int paramcnt = valTop - op.prevTop;
 
-		parser.valTop = op.prevTop;
-		const WCHAR* error = (*(MultiArgFunction)g_Functions[op.funcIndex].proc)(paramcnt, &parser.numStack[parser.valTop + 1], &res);
+		valTop = op.prevTop;
+		const WCHAR* error = (*(MultiArgFunction)g_Functions[op.funcIndex].proc)(paramcnt, &numStack[valTop + 1], &res);
 		if (error) return error;
 
-		parser.numStack[++parser.valTop] = res;
+		numStack[++valTop] = res;
 		return nullptr;
 	}
-	else if (parser.valTop < 0)
+	else if (valTop < 0)
 	{
 		return eExtraOp;
 	}
 
 	// Right arg
-	double right = parser.numStack[parser.valTop--];
+	double right = numStack[valTop--];
 
 	// One arg operations
 	if (op.type == Operator::BitwiseNOT)
@@ -493,144 +649,325 @@ static const WCHAR* Calc(Parser& parser)
 	}
 	else
 	{
-		if (parser.valTop < 0)
+		if (valTop < 0)
 		{
 			return eExtraOp;
 		}
 
 		// Left arg
-		double left = parser.numStack[parser.valTop--];
-		switch (op.type)
+		double left = numStack[valTop--];
+		if (op.type == Operator::ConditionalSeparator)
 		{
-		case Operator::ShiftLeft:
-			res = (double)((long long)left << (long long)right);
-			break;
+			// Needs three arguments
+			if (opTop < 0 || opStack[opTop--].type != Operator::Conditional)
+			{
+				return eLogicErr;
+			}
+			res = numStack[valTop--] ? left : right;
+		}
+		else
+		{
+			const WCHAR* error = ApplyOperator(op.type, left, right, &res);
+			if (error) return error;
+		}
+	}
 
-		case Operator::ShiftRight:
-			res = (double)((long long)left >> (long long)right);
-			break;
+	numStack[++valTop] = res;
+	return nullptr;
+}
 
-		case Operator::Power:
-			res = pow(left, right);
-			break;
+void Compiler::Emit(Opcode opcode, BYTE index, BYTE count)
+{
+	Instruction instruction = {};
+	instruction.opcode = opcode;
+	instruction.index = index;
+	instruction.count = count;
+	program.code.push_back(instruction);
+}
 
-		case Operator::NotEqual:
-			res = left != right;
-			break;
+// Replaces the instructions from |start| onwards with a single number.
+void Compiler::Fold(size_t start, double value)
+{
+	program.code.resize(start);
+	PushNumber(value);
+}
 
-		case Operator::GreatorOrEqual:
-			res = left >= right;
-			break;
+void Compiler::PushNumber(double value)
+{
+	Operand& operand = numStack[++valTop];
+	operand.start = program.code.size();
+	operand.constant = true;
+	operand.value = value;
 
-		case Operator::LessOrEqual:
-			res = left <= right;
-			break;
+	Emit(Opcode::Number);
+	program.code.back().value = value;
+}
 
-		case Operator::LogicalAND:
-			res = left && right;
-			break;
+bool Compiler::PushName(const WCHAR* name, int len)
+{
+	int slot;
+	if (resolveName && resolveName(name, len, &slot, resolveNameContext))
+	{
+		Operand& operand = numStack[++valTop];
+		operand.start = program.code.size();
+		operand.constant = false;
+		operand.value = 0.0;
+
+		Emit(Opcode::Slot);
+		program.code.back().slot = slot;
+		return true;
+	}
 
-		case Operator::LogicalOR:
-			res = left || right;
-			break;
+	return false;
+}
 
-		case Operator::Addition:
-			res = left + right;
-			break;
+const WCHAR* Compiler::Calc()
+{
+	double res;
+	Operation op = opStack[opTop--];
 
-		case Operator::Subtraction:
-			res = left - right;
-			break;
+	if (op.type == Operator::Conditional)
+	{
+		return nullptr;
+	}
+	else if (op.type == Operator::MultiArgFunction)
+	{
+		const int paramcnt = valTop - op.prevTop;
+		const size_t start = (paramcnt > 0) ? numStack[op.prevTop + 1].start : program.code.size();
 
-		case Operator::Multiplication:
-			res = left*  right;
-			break;
+		bool constant = true;
+		double args[_countof(numStack)];
+		for (int i = 0; i < paramcnt; ++i)
+		{
+			const Operand& operand = numStack[op.prevTop + 1 + i];
+			constant = constant && operand.constant;
+			args[i] = operand.value;
+		}
 
-		case Operator::Division:
-			if (right == 0.0)
-			{
-				return eInfinity;
-			}
-			else
-			{
-				res = left / right;
-			}
-			break;
+		valTop = op.prevTop;
+		if (constant)
+		{
+			const WCHAR* error = (*(MultiArgFunction)g_Functions[op.funcIndex].proc)(paramcnt, args, &res);
+			if (error) return error;
 
-		case Operator::Modulo:
-			res = fmod(left, right);
-			break;
+			Fold(start, res);
+		}
+		else
+		{
+			Emit(Opcode::MultiFunction, op.funcIndex, (BYTE)paramcnt);
 
-		case Operator::UNK:
-			if (left <= 0)
-			{
-				res = 0.0;
-			}
-			else if (right == 0.0)
+			Operand& operand = numStack[++valTop];
+			operand.start = start;
+			operand.constant = false;
+		}
+		return nullptr;
+	}
+	else if (valTop < 0)
+	{
+		return eExtraOp;
+	}
+
+	// Right arg
+	const Operand right = numStack[valTop--];
+
+	// One arg operations
+	if (op.type == Operator::BitwiseNOT || op.type == Operator::SingleArgFunction)
+	{
+		if (right.constant)
+		{
+			res = (op.type == Operator::BitwiseNOT) ?
+				(double)(~((long long)right.value)) :
+				(*(SingleArgFunction)g_Functions[op.funcIndex].proc)(right.value);
+			Fold(right.start, res);
+		}
+		else
+		{
+			if (op.type == Operator::BitwiseNOT)
 			{
-				return eInfinity;
+				Emit(Opcode::Unary, (BYTE)op.type);
 			}
 			else
 			{
-				res = ceil(left / right);
+				Emit(Opcode::Function, op.funcIndex);
 			}
-			break;
 
-		case Operator::BitwiseXOR:
-			res = (double)((long long)left ^ (long long)right);
-			break;
+			++valTop;
+		}
+		return nullptr;
+	}
 
-		case Operator::BitwiseAND:
-			res = (double)((long long)left & (long long)right);
-			break;
+	if (valTop < 0)
+	{
+		return eExtraOp;
+	}
 
-		case Operator::BitwiseOR:
-			res = (double)((long long)left | (long long)right);
-			break;
+	// Left arg
+	const Operand left = numStack[valTop--];
+	if (op.type == Operator::ConditionalSeparator)
+	{
+		// Needs three arguments
+		if (opTop < 0 || opStack[opTop--].type != Operator::Conditional || valTop < 0)
+		{
+			return eLogicErr;
+		}
 
-		case Operator::Equal:
-			res = left == right;
-			break;
+		const Operand condition = numStack[valTop--];
+		if (condition.constant && left.constant && right.constant)
+		{
+			Fold(condition.start, condition.value ? left.value : right.value);
+		}
+		else
+		{
+			Emit(Opcode::Conditional);
 
-		case Operator::Greater:
-			res = left > right;
-			break;
+			Operand& operand = numStack[++valTop];
+			operand.start = condition.start;
+			operand.constant = false;
+		}
+		return nullptr;
+	}
 
-		case Operator::Less:
-			res = left < right;
-			break;
+	if (left.constant && right.constant)
+	{
+		const WCHAR* error = ApplyOperator(op.type, left.value, right.value, &res);
+		if (error) return error;
 
-		case Operator::ConditionalSeparator:
-			{
-				// Needs three arguments
-				if (parser.opTop < 0 || parser.opStack[parser.opTop--].type != Operator::Conditional)
-				{
-					return eLogicErr;
-				}
-				res = parser.numStack[parser.valTop--] ? left : right;
-			}
-			break;
+		Fold(left.start, res);
+	}
+	else
+	{
+		Emit(Opcode::Binary, (BYTE)op.type);
 
-		default:
-			return eInternal;
+		Operand& operand = numStack[++valTop];
+		operand.start = left.start;
+		operand.constant = false;
+	}
+	return nullptr;
+}
+
+// Applies a two argument operator.
+static const WCHAR* ApplyOperator(Operator oper, double left, double right, double* result)
+{
+	double res;
+	switch (oper)
+	{
+	case Operator::ShiftLeft:
+		res = (double)((long long)left << (long long)right);
+		break;
+
+	case Operator::ShiftRight:
+		res = (double)((long long)left >> (long long)right);
+		break;
+
+	case Operator::Power:
+		res = pow(left, right);
+		break;
+
+	case Operator::NotEqual:
+		res = left != right;
+		break;
+
+	case Operator::GreatorOrEqual:
+		res = left >= right;
+		break;
+
+	case Operator::LessOrEqual:
+		res = left <= right;
+		break;
+
+	case Operator::LogicalAND:
+		res = left && right;
+		break;
+
+	case Operator::LogicalOR:
+		res = left || right;
+		break;
+
+	case Operator::Addition:
+		res = left + right;
+		break;
+
+	case Operator::Subtraction:
+		res = left - right;
+		break;
+
+	case Operator::Multiplication:
+		res = left*  right;
+		break;
+
+	case Operator::Division:
+		if (right == 0.0)
+		{
+			return eInfinity;
+		}
+		else
+		{
+			res = left / right;
 		}
+		break;
+
+	case Operator::Modulo:
+		res = fmod(left, right);
+		break;
+
+	case Operator::UNK:
+		if (left <= 0)
+		{
+			res = 0.0;
+		}
+		else if (right == 0.0)
+		{
+			return eInfinity;
+		}
+		else
+		{
+			res = ceil(left / right);
+		}
+		break;
+
+	case Operator::BitwiseXOR:
+		res = (double)((long long)left ^ (long long)right);
+		break;
+
+	case Operator::BitwiseAND:
+		res = (double)((long long)left & (long long)right);
+		break;
+
+	case Operator::BitwiseOR:
+		res = (double)((long long)left | (long long)right);
+		break;
+
+	case Operator::Equal:
+		res = left == right;
+		break;
+
+	case Operator::Greater:
+		res = left > right;
+		break;
+
+	case Operator::Less:
+		res = left < right;
+		break;
+
+	default:
+		return eInternal;
 	}
 
-	parser.numStack[++parser.valTop] = res;
+	*result = res;
 	return nullptr;
 }
 
-static const WCHAR* CalcToObr(Parser& parser)
+template <typename T>
+static const WCHAR* CalcToObr(T& parser)
 {
 	while (parser.opStack[parser.opTop].type != Operator::OpeningBracket)
 	{
-		const WCHAR* error = Calc(parser);
+		const WCHAR* error = parser.Calc();
 		if (error) return error;
 	}
 	--parser.opTop;
 	return nullptr;
 }
-
 Token GetNextToken(Lexer& lexer)
 {
 	while (lexer.charType == CharType::Separator)
@@ -11,17 +11,61 @@
 #define RM_COMMON_MATHPARSER_H_
 
 #include <Windows.h>
+#include <vector>
 
 namespace MathParser
 {
 	typedef bool (*GetValueFunc)(const WCHAR* str, int len, double* value, void* context);
 
+	// Used by Compile() to map a name to a slot that is passed to GetSlotValueFunc on evaluation.
+	typedef bool (*ResolveNameFunc)(const WCHAR* str, int len, int* slot, void* context);
+	typedef double (*GetSlotValueFunc)(int slot, void* context);
+
+	enum class Opcode : BYTE
+	{
+		Number,			// Push |value|
+		Slot,			// Push the value of |slot|
+		Unary,			// Apply operator |index| to the top value
+		Binary,			// Apply operator |index| to the two top values
+		Function,		// Call single argument function |index|
+		MultiFunction,	// Call multi argument function |index| with |count| arguments
+		Conditional		// Select between the two top values using the third value
+	};
+
+	struct Instruction
+	{
+		Opcode opcode;
+		BYTE index;
+		BYTE count;
+		union
+		{
+			double value;
+			int slot;
+		};
+	};
+
+	// Formula compiled into postfix form. Constant sub-expressions are folded during Compile().
+	struct Program
+	{
+		bool IsConstant() const { return code.size() == 1 && code[0].opcode == Opcode::Number; }
+		void Clear() { code.clear(); }
+
+		std::vector<Instruction> code;
+	};
+
 	const WCHAR* Check(const WCHAR* formula);
 	const WCHAR* CheckedParse(const WCHAR* formula, double* result);
 	const WCHAR* Parse(
 		const WCHAR* formula, double* result,
 		GetValueFunc getValue = nullptr, void* getValueContext = nullptr);
 
+	const WCHAR* Compile(
+		const WCHAR* formula, Program& program,
+		ResolveNameFunc resolveName = nullptr, void* resolveNameContext = nullptr);
+	const WCHAR* Evaluate(
+		const Program& program, double* result,
+		GetSlotValueFunc getSlotValue = nullptr, void* getSlotValueContext = nullptr);
+
 	bool IsDelimiter(WCHAR ch);
 };
 
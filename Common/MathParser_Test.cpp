@@ -6,6 +6,7 @@
  * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
 
 #include "MathParser.h"
+#include "Timer.h"
 #include "UnitTest.h"
 
 namespace MathParser {
@@ -18,6 +19,13 @@ public:
 		double value = 0.0;
 		Assert::IsNull(Parse(formula, &value));
 		Assert::AreEqual(expected, value);
+
+		// The compiled program must produce the same result.
+		Program program;
+		value = 0.0;
+		Assert::IsNull(Compile(formula, program));
+		Assert::IsNull(Evaluate(program, &value));
+		Assert::AreEqual(expected, value);
 	}
 
 	TEST_METHOD(TestParse)
@@ -86,6 +94,127 @@ public:
 		Assert::AreEqual(30.0, value);
 	}
 
+	TEST_METHOD(TestCompile)
+	{
+		Program program;
+		double value;
+
+		// Constant sub-expressions are folded into a single number.
+		Assert::IsNull(Compile(L"(1 + 2) * sin(0) + max(1, 3) + (1 ? 4 : 5)", program));
+		Assert::IsTrue(program.IsConstant());
+		Assert::IsNull(Evaluate(program, &value));
+		Assert::AreEqual(7.0, value);
+
+		Assert::IsNull(Compile(L"", program));
+		Assert::IsNull(Evaluate(program, &value));
+		Assert::AreEqual(0.0, value);
+
+		Assert::IsNotNull(Compile(L"1 ? 0 ? 4 : 5 : 3", program));
+		Assert::IsNotNull(Compile(L"++1", program));
+		Assert::IsNotNull(Compile(L"((1)", program));
+		Assert::IsNotNull(Compile(L"1 / 0", program));
+		Assert::IsNotNull(Compile(L"1 &&", program));
+		Assert::IsNotNull(Compile(L"a", program));
+		Assert::IsTrue(program.code.empty());
+
+		Assert::IsNull(Compile(L"a + 5", program, ResolveNameHelper));
+		Assert::IsFalse(program.IsConstant());
+		Assert::IsNull(Evaluate(program, &value, GetSlotValueHelper));
+		Assert::AreEqual(15.0, value);
+
+		Assert::IsNull(Compile(L"-bbb * 2 + (3 - 1)", program, ResolveNameHelper));
+		Assert::AreEqual((size_t)6, program.code.size());
+		Assert::IsNull(Evaluate(program, &value, GetSlotValueHelper));
+		Assert::AreEqual(-38.0, value);
+
+		Assert::IsNull(Compile(L"a > 5 ? clamp(bbb, 0, a) + ~a : round(a / 3, 1)", program, ResolveNameHelper));
+		Assert::IsNull(Evaluate(program, &value, GetSlotValueHelper));
+		Assert::AreEqual(-1.0, value);
+
+		// Errors depending on slot values are reported on evaluation.
+		Assert::IsNull(Compile(L"1 / (a - 10)", program, ResolveNameHelper));
+		Assert::IsNotNull(Evaluate(program, &value, GetSlotValueHelper));
+		Assert::IsNotNull(Evaluate(program, &value));
+	}
+
+	TEST_METHOD(TestCompileBenchmark)
+	{
+		const WCHAR* formulas[] =
+		{
+			L"(-5 - 5)",
+			L"-(-5+-5)",
+			L"(1 < 2) && (2 > 1)",
+			L"-sin((25 + 25) * 2)",
+			L"1 ? 2 : 0 ? 4 : 5",
+			L"round(1.555, 2)",
+			L"clamp(6, -2, 3)",
+			L"a + 5",
+			L"(a * 2 + bbb) / 3 % 7",
+			L"a > 5 ? clamp(bbb, 0, a) + ~a : round(a / 3, 1)",
+			L"0?1:(0?1:(0?1:(0?1:(0?1:(0?1:(0?1:(0?1:(0?1:(0?1:a)))))))))"
+		};
+		const int iterations = 20000;
+
+		Program programs[_countof(formulas)];
+		for (int i = 0; i < _countof(formulas); ++i)
+		{
+			Assert::IsNull(Compile(formulas[i], programs[i], ResolveNameHelper));
+		}
+
+		double parseSum = 0.0;
+		Timer parseTimer;
+		parseTimer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			for (int i = 0; i < _countof(formulas); ++i)
+			{
+				double value;
+				Parse(formulas[i], &value, GetValueHelper);
+				parseSum += value;
+			}
+		}
+		parseTimer.Stop();
+
+		double evaluateSum = 0.0;
+		Timer evaluateTimer;
+		evaluateTimer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			for (int i = 0; i < _countof(formulas); ++i)
+			{
+				double value;
+				Evaluate(programs[i], &value, GetSlotValueHelper);
+				evaluateSum += value;
+			}
+		}
+		evaluateTimer.Stop();
+
+		Assert::AreEqual(parseSum, evaluateSum);
+
+		WCHAR buffer[128];
+		_snwprintf_s(buffer, _TRUNCATE, L"Parse: %.2f ms, Evaluate: %.2f ms\n",
+			parseTimer.GetElapsed(), evaluateTimer.GetElapsed());
+		Logger::WriteMessage(buffer);
+	}
+
+	static bool ResolveNameHelper(const WCHAR* str, int len, int* slot, void* context)
+	{
+		double value;
+		if (GetValueHelper(str, len, &value, context))
+		{
+			*slot = (int)value;
+			return true;
+		}
+
+		return false;
+	}
+
+	static double GetSlotValueHelper(int slot, void* context)
+	{
+		// Slots are the values themselves.
+		return (double)slot;
+	}
+
 	static bool GetValueHelper(const WCHAR* str, int len, double* value, void* context)
 	{
 		if (wcsncmp(str, L"a", len) == 0)
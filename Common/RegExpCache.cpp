@@ -0,0 +1,133 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "RegExpCache.h"
+
+RegExp::RegExp(const std::wstring& pattern, int options) :
+	m_Code(),
+	m_Extra(),
+	m_Error(),
+	m_ErrorOffset()
+{
+	m_Code = pcre16_compile(
+		(PCRE_SPTR16)pattern.c_str(),
+		options,
+		&m_Error,
+		&m_ErrorOffset,
+		nullptr);  // Use default character tables.
+	if (m_Code)
+	{
+		// Studying is done once per pattern so it is worth it even for patterns used only a few times.
+		const char* error = nullptr;
+		m_Extra = pcre16_study(m_Code, 0, &error);
+	}
+}
+
+RegExp::~RegExp()
+{
+	if (m_Extra)
+	{
+		pcre16_free_study(m_Extra);
+	}
+
+	if (m_Code)
+	{
+		pcre16_free(m_Code);
+	}
+}
+
+int RegExp::Exec(const WCHAR* subject, int length, int offset, int options, int* ovector, int ovecsize) const
+{
+	if (!m_Code) return PCRE_ERROR_NULL;
+
+	return pcre16_exec(m_Code, m_Extra, (PCRE_SPTR16)subject, length, offset, options, ovector, ovecsize);
+}
+
+RegExpCache::RegExpCache()
+{
+	InitializeCriticalSection(&m_Lock);
+}
+
+RegExpCache::~RegExpCache()
+{
+	DeleteCriticalSection(&m_Lock);
+}
+
+RegExpCache& RegExpCache::GetInstance()
+{
+	static RegExpCache s_Cache;
+	return s_Cache;
+}
+
+RegExpHandle RegExpCache::Get(const std::wstring& pattern, int options)
+{
+	// The options are appended to the pattern to form the key.
+	std::wstring key;
+	key.reserve(pattern.length() + 3);
+	key = pattern;
+	key += L'\0';
+	key += (WCHAR)(options & 0xFFFF);
+	key += (WCHAR)((UINT)options >> 16);
+
+	EnterCriticalSection(&m_Lock);
+
+	auto iter = m_Index.find(key);
+	if (iter != m_Index.end())
+	{
+		// Move to the front of the list.
+		m_Entries.splice(m_Entries.begin(), m_Entries, iter->second);
+		RegExpHandle handle = iter->second->second;
+		LeaveCriticalSection(&m_Lock);
+		return handle;
+	}
+
+	LeaveCriticalSection(&m_Lock);
+
+	// Compile outside of the lock. If another thread compiles the same pattern at the same time,
+	// the first one to finish is kept.
+	RegExpHandle handle(new RegExp(pattern, options));
+
+	EnterCriticalSection(&m_Lock);
+
+	iter = m_Index.find(key);
+	if (iter != m_Index.end())
+	{
+		m_Entries.splice(m_Entries.begin(), m_Entries, iter->second);
+		handle = iter->second->second;
+	}
+	else
+	{
+		if (m_Entries.size() >= c_MaxCount)
+		{
+			m_Index.erase(m_Entries.back().first);
+			m_Entries.pop_back();
+		}
+
+		m_Entries.emplace_front(key, handle);
+		m_Index.emplace(std::move(key), m_Entries.begin());
+	}
+
+	LeaveCriticalSection(&m_Lock);
+	return handle;
+}
+
+void RegExpCache::Clear()
+{
+	EnterCriticalSection(&m_Lock);
+	m_Index.clear();
+	m_Entries.clear();
+	LeaveCriticalSection(&m_Lock);
+}
+
+size_t RegExpCache::GetCount()
+{
+	EnterCriticalSection(&m_Lock);
+	const size_t count = m_Entries.size();
+	LeaveCriticalSection(&m_Lock);
+	return count;
+}
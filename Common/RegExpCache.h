@@ -0,0 +1,82 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef RM_COMMON_REGEXPCACHE_H_
+#define RM_COMMON_REGEXPCACHE_H_
+
+#include <Windows.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "../Library/pcre/config.h"
+#include "../Library/pcre/pcre.h"
+
+// A compiled and studied regular expression. Instances are immutable and can be used by several
+// threads at the same time.
+class RegExp
+{
+public:
+	~RegExp();
+
+	RegExp(const RegExp& other) = delete;
+	RegExp& operator=(RegExp other) = delete;
+
+	// Returns false if the pattern could not be compiled.
+	bool IsValid() const { return m_Code != nullptr; }
+	const char* GetError() const { return m_Error; }
+	int GetErrorOffset() const { return m_ErrorOffset; }
+
+	// Same as pcre16_exec(). Returns PCRE_ERROR_NULL if the pattern is not valid.
+	int Exec(const WCHAR* subject, int length, int offset, int options, int* ovector, int ovecsize) const;
+
+private:
+	friend class RegExpCache;
+
+	RegExp(const std::wstring& pattern, int options);
+
+	pcre16* m_Code;
+	pcre16_extra* m_Extra;
+	const char* m_Error;
+	int m_ErrorOffset;
+};
+
+typedef std::shared_ptr<const RegExp> RegExpHandle;
+
+// Process-wide cache of compiled regular expressions by pattern and compile options. When the
+// cache is full, the least recently used pattern is removed from it. Handles that are still in use
+// keep the removed pattern alive. Thread-safe.
+class RegExpCache
+{
+public:
+	static RegExpCache& GetInstance();
+
+	// Patterns that fail to compile are also cached. Use RegExp::IsValid() to check the result.
+	RegExpHandle Get(const std::wstring& pattern, int options = PCRE_UTF16);
+
+	void Clear();
+	size_t GetCount();
+
+private:
+	RegExpCache();
+	~RegExpCache();
+	RegExpCache(const RegExpCache& other) = delete;
+	RegExpCache& operator=(RegExpCache other) = delete;
+
+	static const size_t c_MaxCount = 256;
+
+	typedef std::list<std::pair<std::wstring, RegExpHandle>> EntryList;
+
+	EntryList m_Entries;	// Most recently used first
+	std::unordered_map<std::wstring, EntryList::iterator> m_Index;	// By pattern and options
+	CRITICAL_SECTION m_Lock;
+};
+
+// Convenience function.
+inline RegExpCache& GetRegExpCache() { return RegExpCache::GetInstance(); }
+
+#endif
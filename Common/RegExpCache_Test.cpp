@@ -0,0 +1,64 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "RegExpCache.h"
+#include "UnitTest.h"
+
+TEST_CLASS(Common_RegExpCache_Test)
+{
+public:
+	TEST_METHOD_INITIALIZE(Initialize)
+	{
+		GetRegExpCache().Clear();
+	}
+
+	TEST_METHOD(TestGet)
+	{
+		RegExpHandle re1 = GetRegExpCache().Get(L"a(b+)c");
+		RegExpHandle re2 = GetRegExpCache().Get(L"a(b+)c");
+		RegExpHandle re3 = GetRegExpCache().Get(L"a(b+)c", PCRE_UTF16 | PCRE_CASELESS);
+		Assert::IsTrue(re1 == re2);
+		Assert::IsTrue(re1 != re3);
+		Assert::AreEqual((size_t)2, GetRegExpCache().GetCount());
+
+		int ovector[30];
+		const WCHAR* subject = L"xxABBc abbc";
+		Assert::AreEqual(2, re1->Exec(subject, 11, 0, 0, ovector, _countof(ovector)));
+		Assert::AreEqual(7, ovector[0]);
+		Assert::AreEqual(8, ovector[2]);
+		Assert::AreEqual(10, ovector[3]);
+		Assert::AreEqual(2, re3->Exec(subject, 11, 0, 0, ovector, _countof(ovector)));
+		Assert::AreEqual(2, ovector[0]);
+	}
+
+	TEST_METHOD(TestInvalid)
+	{
+		RegExpHandle re1 = GetRegExpCache().Get(L"a(b");
+		RegExpHandle re2 = GetRegExpCache().Get(L"a(b");
+		Assert::IsFalse(re1->IsValid());
+		Assert::IsNotNull(re1->GetError());
+		Assert::IsTrue(re1 == re2);
+
+		int ovector[30];
+		Assert::AreEqual(PCRE_ERROR_NULL, re1->Exec(L"ab", 2, 0, 0, ovector, _countof(ovector)));
+	}
+
+	TEST_METHOD(TestEviction)
+	{
+		RegExpHandle first = GetRegExpCache().Get(L"first");
+		for (int i = 0; i < 1000; ++i)
+		{
+			GetRegExpCache().Get(L"p" + std::to_wstring(i));
+		}
+		Assert::IsTrue(GetRegExpCache().GetCount() <= 256);
+
+		// Evicted patterns stay usable while a handle is held.
+		int ovector[30];
+		Assert::AreEqual(1, first->Exec(L"the first", 9, 0, 0, ovector, _countof(ovector)));
+		Assert::IsTrue(first != GetRegExpCache().Get(L"first"));
+	}
+};
@@ -293,13 +293,148 @@ void Internal_DoActivateBang(std::vector<std::wstring>& args, Skin* skin, LPCWST
 	LogErrorF(skin, L"!%s: Invalid parameters", bangName);
 }
 
+// Number of commands in CommandHandler::m_Actions before it is cleared.
+const size_t MAX_CACHED_ACTIONS = 256;
+
+struct BangHandler
+{
+	const BangInfo* info;			// Used with DoGroupBang() if |group| and DoBang() otherwise
+	bool group;
+	const CustomBangInfo* custom;
+};
+
+/*
+** Returns the handler of the bang |name| (case-insensitive) or nullptr if there is none.
+**
+*/
+const BangHandler* FindBangHandler(std::wstring name)
+{
+	static const std::unordered_map<std::wstring, BangHandler> s_Handlers = []()
+	{
+		// Earlier tables take precedence, as they did when the tables were searched in order.
+		std::unordered_map<std::wstring, BangHandler> handlers;
+		auto add = [&](const WCHAR* name, const BangHandler& handler)
+		{
+			std::wstring key = name;
+			std::transform(key.begin(), key.end(), key.begin(), towupper);
+			handlers.emplace(key, handler);
+		};
+
+		for (const auto& bangInfo : s_Bangs) add(bangInfo.name, { &bangInfo, false, nullptr });
+		for (const auto& bangInfo : s_GroupBangs) add(bangInfo.name, { &bangInfo, true, nullptr });
+		for (const auto& bangInfo : s_CustomBangs) add(bangInfo.name, { nullptr, false, &bangInfo });
+		return handlers;
+	}();
+
+	std::transform(name.begin(), name.end(), name.begin(), towupper);
+	auto iter = s_Handlers.find(name);
+	return (iter != s_Handlers.end()) ? &iter->second : nullptr;
+}
+
+void RunBang(const BangHandler* handler, const WCHAR* name, std::vector<std::wstring>& args, Skin* skin)
+{
+	if (!handler)
+	{
+		LogErrorF(skin, L"Invalid bang: !%s", name);
+	}
+	else if (handler->custom)
+	{
+		handler->custom->handlerFunc(args, skin);
+	}
+	else if (handler->group)
+	{
+		DoGroupBang(*handler->info, args, skin);
+	}
+	else
+	{
+		DoBang(*handler->info, args, skin);
+	}
+}
+
 }  // namespace
 
+struct CommandHandler::ActionStep
+{
+	enum class Type : BYTE
+	{
+		Bang,		// Execute |name| with |args|
+		Replace,	// If |text| is replaced, execute it and the rest of the command instead
+		Delay,		// Execute the rest of the command after the delay in |args|
+		Play,		// Play the sound file |text| with |flags|
+		PlayStop,
+		Run			// Run |text|
+	};
+
+	ActionStep(Type type) : type(type), flags(), rest(), handler() {}
+
+	Type type;
+	DWORD flags;
+	size_t rest;		// Offset of the rest of the command for Replace and Delay
+	std::wstring name;
+	const BangHandler* handler;
+	std::vector<std::wstring> args;
+	std::wstring text;
+};
+
+struct CommandHandler::Action
+{
+	std::wstring command;
+	std::vector<ActionStep> steps;
+};
+
 /*
 ** Parses and executes the given command.
 **
 */
 void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi)
+{
+	std::shared_ptr<const Action> action;
+	if (multi)
+	{
+		auto iter = m_Actions.find(command);
+		if (iter != m_Actions.end())
+		{
+			action = iter->second;
+		}
+	}
+
+	if (!action)
+	{
+		auto newAction = std::make_shared<Action>();
+		newAction->command = command;
+		ParseCommand(newAction->command.c_str(), multi, *newAction);
+		action = newAction;
+
+		if (multi)
+		{
+			// Commands built at runtime (e.g. by scripts) could otherwise grow the cache forever.
+			if (m_Actions.size() >= MAX_CACHED_ACTIONS)
+			{
+				m_Actions.clear();
+			}
+
+			m_Actions.emplace(action->command, action);
+		}
+	}
+
+	// |action| is kept alive even if the cache is cleared by a nested command.
+	if (skin)
+	{
+		skin->BeginBatch();
+		RunAction(*action, skin);
+		skin->EndBatch();
+	}
+	else
+	{
+		RunAction(*action, skin);
+	}
+}
+
+/*
+** Splits |command| into the steps of |action|. |command| must point into |action.command|.
+**
+*/
+void CommandHandler::ParseCommand(const WCHAR* command, bool multi, Action& action)
 {
 	// Remove any leading whitespace
 	while (iswspace(command[0])) ++command;
@@ -322,28 +457,29 @@ void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi
 				command += 9;
 			}
 
-			std::wstring bang;
-			std::vector<std::wstring> args;
+			action.steps.emplace_back(ActionStep::Type::Bang);
+			ActionStep& step = action.steps.back();
 
 			// Find the first space
 			const WCHAR* pos = wcschr(command, L' ');
 			if (pos)
 			{
-				bang.assign(command, 0, pos - command);
-				args = ParseString(pos + 1, skin ? &skin->GetParser() : nullptr);
+				step.name.assign(command, 0, pos - command);
+				step.args = ParseString(pos + 1);
 			}
 			else
 			{
-				bang = command;
+				step.name = command;
 			}
 
-			ExecuteBang(bang.c_str(), args, skin);
+			step.handler = FindBangHandler(step.name);
 			return;
 		}
 	}
 
 	if (multi && command[0] == L'[')	// Multi-bang
 	{
+		const size_t offset = command - action.command.c_str();
 		std::wstring bangs = command;
 		std::wstring::size_type start = std::wstring::npos;
 		int count = 0;
@@ -365,25 +501,13 @@ void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi
 				{
 					// !Bang found
 
-					// Pre-parse any "bang replacement variables"
-					if (skin)
+					// "Bang replacement variables" are replaced when executed
+					if (ConfigParser::IsVariableKey(bangs[start + 1]))
 					{
-						std::wstring currentBang = bangs.substr(start, i - start + 1);
-						if (ConfigParser::IsVariableKey(currentBang[1]) &&
-							skin->GetParser().ReplaceMeasures(currentBang))
-						{
-							// Surround the replacement bang with brackets (if needed) since
-							// there could be more trailing bangs from the original
-							if (currentBang[0] != L'[')
-							{
-								currentBang.insert(0, L"[");
-								currentBang.append(L"]");
-							}
-
-							currentBang.append(bangs.substr(i + 1));  // Append trailing bangs
-							ExecuteCommand(currentBang.c_str(), skin, true);
-							return;
-						}
+						action.steps.emplace_back(ActionStep::Type::Replace);
+						ActionStep& step = action.steps.back();
+						step.text = bangs.substr(start, i - start + 1);
+						step.rest = offset + i + 1;
 					}
 
 					// Change ] to nullptr
@@ -393,19 +517,18 @@ void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi
 					start = bangs.find_first_not_of(L" \t\r\n", start + 1, 4);
 
 					const WCHAR* newCommand = bangs.c_str() + start;
-					if (skin && _wcsnicmp(newCommand, L"!Delay ", wcslen(L"!Delay ")) == 0)
+					if (_wcsnicmp(newCommand, L"!Delay ", wcslen(L"!Delay ")) == 0)
 					{
-						auto args = ParseString(newCommand + wcslen(L"!Delay "), &skin->GetParser());
-						if (args.size() == 1)
-						{
-							auto delay = ConfigParser::ParseUInt(args[0].c_str(), 0);
-							skin->DoDelayedCommand(bangs.c_str() + i + 1, delay);
-							return;
-						}
+						action.steps.emplace_back(ActionStep::Type::Delay);
+						ActionStep& step = action.steps.back();
+						step.name.assign(newCommand + 1, wcslen(L"Delay"));
+						step.args = ParseString(newCommand + wcslen(L"!Delay "));
+						step.rest = offset + i + 1;
+						step.handler = FindBangHandler(step.name);
 					}
 					else
 					{
-						ExecuteCommand(newCommand, skin, false);
+						ParseCommand(newCommand, false, action);
 					}
 				}
 			}
@@ -442,57 +565,147 @@ void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi
 				++command;	// Skip the space
 				if (command[0] != L'\0')
 				{
-					std::wstring sound = command;
+					action.steps.emplace_back(ActionStep::Type::Play);
+					ActionStep& step = action.steps.back();
+					step.flags = flags;
+					step.text = command;
 
 					// Strip the quotes
+					std::wstring& sound = step.text;
 					std::wstring::size_type len = sound.length();
 					if (len >= 2 && sound[0] == L'"' && sound[len - 1] == L'"')
 					{
 						len -= 2;
 						sound.assign(sound, 1, len);
 					}
-
-					if (skin)
-					{
-						skin->GetParser().ReplaceMeasures(sound);
-						skin->MakePathAbsolute(sound);
-					}
-
-					PlaySound(sound.c_str(), nullptr, flags);
 				}
 				return;
 			}
 			else if (_wcsnicmp(L"STOP", &command[4], 4) == 0)  // PLAYSTOP
 			{
-				PlaySound(nullptr, nullptr, SND_PURGE);
+				action.steps.emplace_back(ActionStep::Type::PlayStop);
 				return;
 			}
 		}
 
 		// Run command
-		std::wstring tmpSz = command;
-		if (skin)
+		action.steps.emplace_back(ActionStep::Type::Run);
+		action.steps.back().text = command;
+	}
+}
+
+/*
+** Executes the steps of |action|.
+**
+*/
+void CommandHandler::RunAction(const Action& action, Skin* skin)
+{
+	for (const auto& step : action.steps)
+	{
+		switch (step.type)
 		{
-			// If the command is a section variable or a new style variable,
-			// surround the command with brackets and replace it with the variable.
-			// This allows for section variables to completely replace a bang sequence.
-			// ex. LeftMouseUpAction=[SomeMeasureName]  or  LeftMouseUpAction=[#NewStyleVar]
-			// Note: This assumes the |command| does not start with a variable key (&, #, $, \)
-			bool isVar = (ConfigParser::IsVariableKey(tmpSz[0]) || skin->GetMeasure(tmpSz));
-			if (isVar)
+		case ActionStep::Type::Replace:
+			if (skin)
 			{
-				tmpSz.insert(0, L"[");
-				tmpSz.append(L"]");
+				std::wstring currentBang = step.text;
+				if (skin->GetParser().ReplaceMeasures(currentBang))
+				{
+					// Surround the replacement bang with brackets (if needed) since
+					// there could be more trailing bangs from the original
+					if (currentBang[0] != L'[')
+					{
+						currentBang.insert(0, L"[");
+						currentBang.append(L"]");
+					}
+
+					currentBang.append(action.command, step.rest, std::wstring::npos);  // Append trailing bangs
+					ExecuteCommand(currentBang.c_str(), skin, true);
+					return;
+				}
 			}
+			break;
 
-			if (skin->GetParser().ReplaceMeasures(tmpSz) && isVar)
+		case ActionStep::Type::Delay:
+			if (skin)
 			{
-				ExecuteCommand(tmpSz.c_str(), skin, true);
-				return;
+				std::vector<std::wstring> args = step.args;
+				for (auto& arg : args)
+				{
+					skin->GetParser().ReplaceMeasures(arg);
+				}
+
+				if (args.size() == 1)
+				{
+					auto delay = ConfigParser::ParseUInt(args[0].c_str(), 0);
+					skin->DoDelayedCommand(action.command.c_str() + step.rest, delay);
+					return;
+				}
+				break;
 			}
-		}
 
-		RunCommand(tmpSz);
+			// Without a skin, !Delay is handled (and rejected) like any other bang.
+			// Fall through
+
+		case ActionStep::Type::Bang:
+			{
+				std::vector<std::wstring> args = step.args;
+				if (skin)
+				{
+					for (auto& arg : args)
+					{
+						skin->GetParser().ReplaceMeasures(arg);
+					}
+				}
+
+				RunBang(step.handler, step.name.c_str(), args, skin);
+			}
+			break;
+
+		case ActionStep::Type::Play:
+			{
+				std::wstring sound = step.text;
+				if (skin)
+				{
+					skin->GetParser().ReplaceMeasures(sound);
+					skin->MakePathAbsolute(sound);
+				}
+
+				PlaySound(sound.c_str(), nullptr, step.flags);
+			}
+			break;
+
+		case ActionStep::Type::PlayStop:
+			PlaySound(nullptr, nullptr, SND_PURGE);
+			break;
+
+		case ActionStep::Type::Run:
+			{
+				std::wstring tmpSz = step.text;
+				if (skin)
+				{
+					// If the command is a section variable or a new style variable,
+					// surround the command with brackets and replace it with the variable.
+					// This allows for section variables to completely replace a bang sequence.
+					// ex. LeftMouseUpAction=[SomeMeasureName]  or  LeftMouseUpAction=[#NewStyleVar]
+					// Note: This assumes the |command| does not start with a variable key (&, #, $, \)
+					bool isVar = (ConfigParser::IsVariableKey(tmpSz[0]) || skin->GetMeasure(tmpSz));
+					if (isVar)
+					{
+						tmpSz.insert(0, L"[");
+						tmpSz.append(L"]");
+					}
+
+					if (skin->GetParser().ReplaceMeasures(tmpSz) && isVar)
+					{
+						ExecuteCommand(tmpSz.c_str(), skin, true);
+						break;
+					}
+				}
+
+				RunCommand(tmpSz);
+			}
+			break;
+		}
 	}
 }
 
@@ -502,34 +715,7 @@ void CommandHandler::ExecuteCommand(const WCHAR* command, Skin* skin, bool multi
 */
 void CommandHandler::ExecuteBang(const WCHAR* name, std::vector<std::wstring>& args, Skin* skin)
 {
-	for (const auto& bangInfo : s_Bangs)
-	{
-		if (_wcsicmp(bangInfo.name, name) == 0)
-		{
-			DoBang(bangInfo, args, skin);
-			return;
-		}
-	}
-
-	for (const auto& bangInfo : s_GroupBangs)
-	{
-		if (_wcsicmp(bangInfo.name, name) == 0)
-		{
-			DoGroupBang(bangInfo, args, skin);
-			return;
-		}
-	}
-
-	for (const auto& bangInfo : s_CustomBangs)
-	{
-		if (_wcsicmp(bangInfo.name, name) == 0)
-		{
-			bangInfo.handlerFunc(args, skin);
-			return;
-		}
-	}
-
-	LogErrorF(skin, L"Invalid bang: !%s", name);
+	RunBang(FindBangHandler(name), name, args, skin);
 }
 
 /*
@@ -9,7 +9,9 @@
 #define RM_LIBRARY_COMMANDHANDLER_H_
 
 #include <Windows.h>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class ConfigParser;
@@ -154,6 +156,18 @@ public:
 	static void DoSetWindowPositionBang(std::vector<std::wstring>& args, Skin* skin);
 
 	static void DoLsBoxHookBang(std::vector<std::wstring>& args, Skin* skin);
+
+private:
+	// A command split into bangs and arguments once. Variables and measures are substituted in the
+	// arguments each time the command is executed.
+	struct ActionStep;
+	struct Action;
+
+	static void ParseCommand(const WCHAR* command, bool multi, Action& action);
+	void RunAction(const Action& action, Skin* skin);
+
+	// Commands executed with |multi|, e.g. OnUpdateAction, by command string.
+	std::unordered_map<std::wstring, std::shared_ptr<const Action>> m_Actions;
 };
 
 #endif
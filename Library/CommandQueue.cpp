@@ -0,0 +1,60 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "CommandQueue.h"
+
+CommandQueue::CommandQueue() :
+	m_Scheduled(0L)
+{
+	InitializeSListHead(&m_Pushed);
+}
+
+CommandQueue::~CommandQueue()
+{
+	TakePushed();
+	for (Entry* entry : m_Pending)
+	{
+		DeleteEntry(entry);
+	}
+}
+
+bool CommandQueue::Push(const WCHAR* command, Skin* skin, UINT delay)
+{
+	// SLIST_ENTRY requires MEMORY_ALLOCATION_ALIGNMENT.
+	void* memory = _aligned_malloc(sizeof(Entry), MEMORY_ALLOCATION_ALIGNMENT);
+	if (!memory) return false;
+
+	Entry* entry = new (memory) Entry;
+	entry->skin = skin;
+	entry->delay = delay;
+	entry->command = command;
+	InterlockedPushEntrySList(&m_Pushed, &entry->link);
+
+	return InterlockedExchange(&m_Scheduled, 1L) == 0L;
+}
+
+void CommandQueue::DeleteEntry(Entry* entry)
+{
+	entry->~Entry();
+	_aligned_free(entry);
+}
+
+void CommandQueue::TakePushed()
+{
+	PSLIST_ENTRY link = InterlockedFlushSList(&m_Pushed);
+	if (!link) return;
+
+	// The list is in reverse order of pushing.
+	const size_t oldSize = m_Pending.size();
+	for ( ; link; link = link->Next)
+	{
+		m_Pending.push_back(CONTAINING_RECORD(link, Entry, link));
+	}
+
+	std::reverse(m_Pending.begin() + oldSize, m_Pending.end());
+}
@@ -0,0 +1,74 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __COMMANDQUEUE_H__
+#define __COMMANDQUEUE_H__
+
+#include <windows.h>
+#include <string>
+#include <deque>
+
+class Skin;
+
+// Commands waiting to be executed on the main thread. Any thread can add commands without
+// blocking; only the main thread runs them. The queue only tells the producer when the consumer
+// needs to be woken up so that a burst of commands results in a single wakeup message.
+class CommandQueue
+{
+public:
+	CommandQueue();
+	~CommandQueue();
+
+	CommandQueue(const CommandQueue& other) = delete;
+	CommandQueue& operator=(CommandQueue other) = delete;
+
+	// Returns true if the consumer was idle and needs to be woken up to run the command. |delay|
+	// is passed on to the consumer, which is expected to run the command that much later.
+	bool Push(const WCHAR* command, Skin* skin, UINT delay = 0U);
+
+	// Calls |func(command, skin, delay)| for at most |maxCount| commands in the order they were added.
+	// Returns true if commands remain and the consumer needs to be woken up again.
+	template<typename Func>
+	bool Run(size_t maxCount, Func func)
+	{
+		// Producers that add commands from now on wake up the consumer again.
+		InterlockedExchange(&m_Scheduled, 0L);
+		TakePushed();
+
+		for (size_t i = 0; i < maxCount && !m_Pending.empty(); ++i)
+		{
+			// Removed before running since the command might run a nested message loop.
+			Entry* entry = m_Pending.front();
+			m_Pending.pop_front();
+
+			func(entry->command.c_str(), entry->skin, entry->delay);
+			DeleteEntry(entry);
+		}
+
+		return !m_Pending.empty() && InterlockedExchange(&m_Scheduled, 1L) == 0L;
+	}
+
+private:
+	struct Entry
+	{
+		SLIST_ENTRY link;	// Must be first
+		Skin* skin;
+		UINT delay;
+		std::wstring command;
+	};
+
+	static void DeleteEntry(Entry* entry);
+
+	// Moves the commands added by producers to |m_Pending|.
+	void TakePushed();
+
+	SLIST_HEADER m_Pushed;				// Last pushed first
+	std::deque<Entry*> m_Pending;		// Only used by the consumer
+	volatile LONG m_Scheduled;			// 1 if the consumer has been asked to run the queue
+};
+
+#endif
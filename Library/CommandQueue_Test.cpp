@@ -0,0 +1,112 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "CommandQueue.h"
+#include <functional>
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_CommandQueue_Test)
+{
+public:
+	TEST_METHOD(TestOrder)
+	{
+		CommandQueue queue;
+		Assert::IsTrue(queue.Push(L"A", nullptr));
+		Assert::IsFalse(queue.Push(L"B", nullptr));
+		Assert::IsFalse(queue.Push(L"C", nullptr));
+
+		std::wstring result;
+		auto run = [&](const WCHAR* command, Skin* skin, UINT delay) { result += command; };
+
+		// Remaining commands ask for another wakeup.
+		Assert::IsTrue(queue.Run(2, run));
+		Assert::AreEqual(L"AB", result.c_str());
+
+		Assert::IsFalse(queue.Push(L"D", nullptr, 100U));
+		Assert::IsFalse(queue.Run(10, [&](const WCHAR* command, Skin* skin, UINT delay)
+		{
+			result += command;
+			Assert::AreEqual(command[0] == L'D' ? 100U : 0U, delay);
+		}));
+		Assert::AreEqual(L"ABCD", result.c_str());
+
+		// The consumer is idle again.
+		Assert::IsTrue(queue.Push(L"E", nullptr));
+		Assert::IsFalse(queue.Run(10, run));
+		Assert::AreEqual(L"ABCDE", result.c_str());
+	}
+
+	TEST_METHOD(TestNestedRun)
+	{
+		CommandQueue queue;
+		queue.Push(L"A", nullptr);
+		queue.Push(L"B", nullptr);
+		queue.Push(L"C", nullptr);
+
+		std::wstring result;
+		std::function<void(const WCHAR*, Skin*, UINT)> run = [&](const WCHAR* command, Skin* skin, UINT delay)
+		{
+			result += command;
+			if (command[0] == L'A')
+			{
+				// e.g. a modal message loop started by a command
+				queue.Push(L"D", nullptr);
+				queue.Run(1, run);
+			}
+		};
+
+		Assert::IsFalse(queue.Run(10, run));
+		Assert::AreEqual(L"ABCD", result.c_str());
+	}
+
+	TEST_METHOD(TestThreads)
+	{
+		CommandQueue queue;
+
+		const int threadCount = 4;
+		const int commandCount = 1000;
+		std::vector<HANDLE> threads;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.push_back(CreateThread(nullptr, 0, [](LPVOID param) -> DWORD
+			{
+				CommandQueue* queue = (CommandQueue*)param;
+				for (int j = 0; j < commandCount; ++j)
+				{
+					queue->Push(std::to_wstring(j).c_str(), nullptr);
+				}
+				return 0;
+			}, &queue, 0, nullptr));
+		}
+
+		WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+		for (HANDLE thread : threads) CloseHandle(thread);
+
+		// Commands from each thread are run in the order they were added.
+		int count = 0;
+		int next[threadCount] = {};
+		queue.Run(threadCount * commandCount, [&](const WCHAR* command, Skin* skin, UINT delay)
+		{
+			const int value = _wtoi(command);
+			bool found = false;
+			for (int i = 0; i < threadCount && !found; ++i)
+			{
+				if (next[i] == value)
+				{
+					++next[i];
+					found = true;
+				}
+			}
+
+			Assert::IsTrue(found);
+			++count;
+		});
+
+		Assert::AreEqual(threadCount * commandCount, count);
+	}
+};
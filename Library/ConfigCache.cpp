@@ -0,0 +1,175 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "ConfigCache.h"
+#include "Rainmeter.h"
+
+namespace ConfigCache {
+
+File GetFile(const std::wstring& path)
+{
+	File file = { path, c_MissingFile, 0ULL };
+
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &data) &&
+		(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+	{
+		file.size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+		file.lastWrite = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+	}
+
+	return file;
+}
+
+bool IsUnchanged(const File& file)
+{
+	const File current = GetFile(file.path);
+	return current.size == file.size && current.lastWrite == file.lastWrite;
+}
+
+static std::wstring GetCacheFolder()
+{
+	std::wstring path = GetRainmeter().GetSettingsPath();
+	path += L"Cache\\";
+	return path;
+}
+
+static std::wstring GetCacheFileName(const std::wstring& iniFile)
+{
+	// 64-bit FNV-1a of the lowercase path
+	uint64_t hash = 14695981039346656037ULL;
+	for (WCHAR ch : iniFile)
+	{
+		hash ^= (uint64_t)towlower(ch);
+		hash *= 1099511628211ULL;
+	}
+
+	WCHAR buffer[32];
+	_snwprintf_s(buffer, _TRUNCATE, L"%016llX.cache", hash);
+	return buffer;
+}
+
+std::wstring GetCacheFile(const std::wstring& iniFile)
+{
+	return GetCacheFolder() + GetCacheFileName(iniFile);
+}
+
+void PruneCacheFiles(const std::vector<std::wstring>& iniFiles)
+{
+	std::unordered_set<std::wstring> keep;
+	for (const auto& iniFile : iniFiles)
+	{
+		keep.insert(GetCacheFileName(iniFile));
+	}
+
+	const std::wstring folder = GetCacheFolder();
+	WIN32_FIND_DATA fileData;
+	HANDLE search = FindFirstFileEx(
+		(folder + L'*').c_str(),
+		FindExInfoBasic,
+		&fileData,
+		FindExSearchNameMatch,
+		nullptr,
+		0);
+	if (search == INVALID_HANDLE_VALUE) return;
+
+	// Cache files of skins that were removed or renamed (and leftover temporary files) are never
+	// read again.
+	do
+	{
+		if ((fileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0 &&
+			keep.find(fileData.cFileName) == keep.end())
+		{
+			DeleteFile((folder + fileData.cFileName).c_str());
+		}
+	}
+	while (FindNextFile(search, &fileData));
+
+	FindClose(search);
+}
+
+void Writer::WriteUInt(uint64_t value)
+{
+	// Variable-length encoding: 7 bits per byte, high bit set if more bytes follow.
+	do
+	{
+		BYTE byte = (BYTE)(value & 0x7F);
+		value >>= 7;
+		if (value != 0ULL) byte |= 0x80;
+		m_Data.push_back(byte);
+	}
+	while (value != 0ULL);
+}
+
+void Writer::WriteString(const std::wstring& str)
+{
+	WriteUInt(str.length());
+	const BYTE* data = (const BYTE*)str.data();
+	m_Data.insert(m_Data.end(), data, data + str.length() * sizeof(WCHAR));
+}
+
+bool Writer::Save(const std::wstring& path) const
+{
+	const size_t pos = path.find_last_of(L'\\');
+	if (pos != std::wstring::npos)
+	{
+		CreateDirectory(path.substr(0, pos).c_str(), nullptr);
+	}
+
+	// Write to a temporary file first so that a partially written cache is never read.
+	const std::wstring tempPath = path + L".tmp";
+	HANDLE file = CreateFile(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	DWORD written = 0UL;
+	const BOOL result = WriteFile(file, m_Data.data(), (DWORD)m_Data.size(), &written, nullptr);
+	CloseHandle(file);
+
+	if (!result || written != (DWORD)m_Data.size() ||
+		!MoveFileEx(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		DeleteFile(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool Reader::ReadUInt(uint64_t& value)
+{
+	value = 0ULL;
+	for (int shift = 0; !m_Failed && shift < 64; shift += 7)
+	{
+		if (m_Pos >= m_Size) break;
+
+		const BYTE byte = m_Data[m_Pos++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+
+	m_Failed = true;
+	return false;
+}
+
+bool Reader::ReadString(std::wstring& str)
+{
+	uint64_t length = 0ULL;
+	if (!ReadUInt(length)) return false;
+
+	if (length > (m_Size - m_Pos) / sizeof(WCHAR))
+	{
+		m_Failed = true;
+		return false;
+	}
+
+	str.assign((const WCHAR*)(m_Data + m_Pos), (size_t)length);
+	m_Pos += (size_t)length * sizeof(WCHAR);
+	return true;
+}
+
+}  // namespace ConfigCache
@@ -0,0 +1,76 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __CONFIGCACHE_H__
+#define __CONFIGCACHE_H__
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Helpers for the on-disk cache of skin files after @Include files have been read. The cache
+// is only used when none of the files that were read have changed.
+namespace ConfigCache {
+
+struct File
+{
+	std::wstring path;
+	uint64_t size;			// c_MissingFile if the file does not exist
+	uint64_t lastWrite;
+};
+
+const uint64_t c_MissingFile = (uint64_t)-1;
+
+// Returns the size and modification time of |path|.
+File GetFile(const std::wstring& path);
+
+// Returns true if |file| still has the same size and modification time.
+bool IsUnchanged(const File& file);
+
+// Returns the path of the cache file for |iniFile|.
+std::wstring GetCacheFile(const std::wstring& iniFile);
+
+// Deletes the cache files that do not belong to any of |iniFiles|.
+void PruneCacheFiles(const std::vector<std::wstring>& iniFiles);
+
+class Writer
+{
+public:
+	void WriteUInt(uint64_t value);
+	void WriteString(const std::wstring& str);
+
+	bool Save(const std::wstring& path) const;
+
+	const std::vector<BYTE>& GetData() const { return m_Data; }
+
+private:
+	std::vector<BYTE> m_Data;
+};
+
+// Reads the values written by Writer. Once a read fails, all following reads fail.
+class Reader
+{
+public:
+	Reader(const BYTE* data, size_t size) : m_Data(data), m_Size(size), m_Pos(), m_Failed(false) {}
+
+	bool ReadUInt(uint64_t& value);
+	bool ReadString(std::wstring& str);
+
+	// Returns true if all reads succeeded and all of the data has been read.
+	bool IsComplete() const { return !m_Failed && m_Pos == m_Size; }
+
+private:
+	const BYTE* m_Data;
+	size_t m_Size;
+	size_t m_Pos;
+	bool m_Failed;
+};
+
+}  // namespace ConfigCache
+
+#endif
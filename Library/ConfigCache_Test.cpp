@@ -0,0 +1,64 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "ConfigCache.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_ConfigCache_Test)
+{
+public:
+	TEST_METHOD(TestReadWrite)
+	{
+		ConfigCache::Writer writer;
+		writer.WriteUInt(0ULL);
+		writer.WriteUInt(127ULL);
+		writer.WriteUInt(128ULL);
+		writer.WriteUInt(ConfigCache::c_MissingFile);
+		writer.WriteString(L"");
+		writer.WriteString(L"[Meter]\nText=abc");
+
+		const auto& data = writer.GetData();
+		ConfigCache::Reader reader(data.data(), data.size());
+
+		uint64_t value = 1ULL;
+		std::wstring str = L"x";
+		Assert::IsTrue(reader.ReadUInt(value));
+		Assert::AreEqual(0ULL, value);
+		Assert::IsTrue(reader.ReadUInt(value));
+		Assert::AreEqual(127ULL, value);
+		Assert::IsTrue(reader.ReadUInt(value));
+		Assert::AreEqual(128ULL, value);
+		Assert::IsTrue(reader.ReadUInt(value));
+		Assert::IsTrue(value == ConfigCache::c_MissingFile);
+		Assert::IsTrue(reader.ReadString(str));
+		Assert::AreEqual(L"", str.c_str());
+		Assert::IsFalse(reader.IsComplete());
+		Assert::IsTrue(reader.ReadString(str));
+		Assert::AreEqual(L"[Meter]\nText=abc", str.c_str());
+		Assert::IsTrue(reader.IsComplete());
+
+		// Reading past the end fails.
+		Assert::IsFalse(reader.ReadUInt(value));
+		Assert::IsFalse(reader.IsComplete());
+	}
+
+	TEST_METHOD(TestTruncated)
+	{
+		ConfigCache::Writer writer;
+		writer.WriteString(L"abcdef");
+
+		const auto& data = writer.GetData();
+		ConfigCache::Reader reader(data.data(), data.size() - 1);
+
+		std::wstring str;
+		uint64_t value = 0ULL;
+		Assert::IsFalse(reader.ReadString(str));
+		Assert::IsFalse(reader.ReadUInt(value));
+		Assert::IsFalse(reader.IsComplete());
+	}
+};
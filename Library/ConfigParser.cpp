@@ -6,9 +6,12 @@
  * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
 
 #include "StdAfx.h"
+#include "../Common/FileUtil.h"
+#include "../Common/IniFile.h"
 #include "../Common/MathParser.h"
 #include "../Common/PathUtil.h"
 #include "ConfigParser.h"
+#include "IniFileCache.h"
 #include "Util.h"
 #include "Rainmeter.h"
 #include "System.h"
@@ -38,9 +41,13 @@ const std::unordered_map<PairedPunctuation, PairInfo> s_PairedPunct =
 	{ PairedPunctuation::Guillemet,   { L'<', L'>' } }
 };
 
+const uint64_t c_CacheMagic = 0x43434D52ULL;  // "RMCC"
+const uint64_t c_CacheVersion = 1ULL;
+
 }  // namespace
 
 std::unordered_map<std::wstring, std::wstring> ConfigParser::c_MonitorVariables;
+UINT ConfigParser::c_MonitorVariableGeneration = 0U;
 std::unordered_map<ConfigParser::VariableType, WCHAR> ConfigParser::c_VariableMap;
 
 ConfigParser::ConfigParser() :
@@ -48,6 +55,11 @@ ConfigParser::ConfigParser() :
 	m_LastDefaultUsed(false),
 	m_LastValueDefined(false),
 	m_CurrentSection(),
+	m_MeasureReferences(),
+	m_OptionReferences(),
+	m_CacheFiles(),
+	m_VariableGeneration(),
+	m_VariableDepth(),
 	m_Skin()
 {
 	if (c_VariableMap.empty())
@@ -67,12 +79,19 @@ void ConfigParser::Initialize(const std::wstring& filename, Skin* skin, LPCTSTR
 {
 	m_Skin = skin;
 
-	m_Measures.clear();
+	m_Measures.Clear();
 	m_Sections.clear();
-	m_Values.clear();
+	m_Options.Clear();
 	m_BuiltInVariables.clear();
 	m_Variables.clear();
 	m_OriginalVariableNames.clear();
+	m_OptionTemplates.clear();
+	m_VariableSections.clear();
+	m_FormulaMemo.Clear();
+	m_ColorMemo.Clear();
+	m_RectMemo.Clear();
+	m_RECTMemo.Clear();
+	m_FloatsMemo.Clear();
 
 	m_StyleTemplate.clear();
 	m_LastReplaced = false;
@@ -88,7 +107,31 @@ void ConfigParser::Initialize(const std::wstring& filename, Skin* skin, LPCTSTR
 
 	System::UpdateIniFileMappingList();
 
-	ReadIniFile(filename, skinSection);
+	if (skin && !skinSection)
+	{
+		// Skin files (and their @Include files) are read from the cache unless one of them has changed
+		if (!ReadCache(filename))
+		{
+			const auto userVariables = m_Variables;
+			std::vector<ConfigCache::File> files;
+			OptionReferences references = { };
+			m_CacheFiles = &files;
+			OptionReferences* prevReferences = SetOptionReferences(&references);
+
+			ReadIniFile(filename, skinSection);
+
+			SetOptionReferences(prevReferences);
+			if (m_CacheFiles)
+			{
+				m_CacheFiles = nullptr;
+				WriteCache(filename, files, references.variables, userVariables);
+			}
+		}
+	}
+	else
+	{
+		ReadIniFile(filename, skinSection);
+	}
 	ReadVariables();
 
 	// Clear and minimize
@@ -150,7 +193,12 @@ void ConfigParser::SetVariable(std::wstring strVariable, const std::wstring& str
 	std::wstring original = strVariable;
 
 	StrToUpperC(strVariable);
-	m_Variables[strVariable] = strValue;
+	auto result = m_Variables.emplace(strVariable, strValue);
+	if (result.second || result.first->second != strValue)
+	{
+		result.first->second = strValue;
+		SetVariableChanged(strVariable);
+	}
 
 	if (m_OriginalVariableNames.find(strVariable) == m_OriginalVariableNames.end())
 	{
@@ -160,7 +208,56 @@ void ConfigParser::SetVariable(std::wstring strVariable, const std::wstring& str
 
 void ConfigParser::SetBuiltInVariable(const std::wstring& strVariable, const std::wstring& strValue)
 {
-	m_BuiltInVariables[strVariable] = strValue;
+	auto result = m_BuiltInVariables.emplace(strVariable, strValue);
+	if (result.second || result.first->second != strValue)
+	{
+		result.first->second = strValue;
+		SetVariableChanged(strVariable);
+	}
+}
+
+/*
+** Invalidates the cached option templates and marks the sections that reference the
+** given (uppercase) variable so that their options are read again.
+**
+*/
+void ConfigParser::SetVariableChanged(const std::wstring& strVariable)
+{
+	++m_VariableGeneration;
+
+	auto iter = m_VariableSections.find(strVariable);
+	if (iter != m_VariableSections.end())
+	{
+		for (Section* section : (*iter).second)
+		{
+			section->SetOptionsDirty();
+		}
+	}
+}
+
+void ConfigParser::AddVariableReferences(Section* section, const std::vector<std::wstring>& variables)
+{
+	for (const auto& variable : variables)
+	{
+		m_VariableSections[variable].push_back(section);
+	}
+}
+
+void ConfigParser::RemoveVariableReferences(Section* section, const std::vector<std::wstring>& variables)
+{
+	for (const auto& variable : variables)
+	{
+		auto iter = m_VariableSections.find(variable);
+		if (iter != m_VariableSections.end())
+		{
+			std::vector<Section*>& sections = (*iter).second;
+			sections.erase(std::remove(sections.begin(), sections.end(), section), sections.end());
+			if (sections.empty())
+			{
+				m_VariableSections.erase(iter);
+			}
+		}
+	}
 }
 
 /*
@@ -171,6 +268,8 @@ const std::wstring* ConfigParser::GetVariable(const std::wstring& strVariable)
 {
 	const std::wstring strTmp = StrToUpper(strVariable);
 
+	if (m_OptionReferences) m_OptionReferences->variables.push_back(strTmp);
+
 	// #1: Built-in variables
 	std::unordered_map<std::wstring, std::wstring>::const_iterator iter = m_BuiltInVariables.find(strTmp);
 	if (iter != m_BuiltInVariables.end())
@@ -182,6 +281,8 @@ const std::wstring* ConfigParser::GetVariable(const std::wstring& strVariable)
 	iter = c_MonitorVariables.find(strTmp);
 	if (iter != c_MonitorVariables.end())
 	{
+		// Monitor variables are shared by all skins and are not tracked
+		if (m_OptionReferences) m_OptionReferences->isVolatile = true;
 		return &(*iter).second;
 	}
 
@@ -225,6 +326,8 @@ bool ConfigParser::GetSectionVariable(std::wstring& strVariable, std::wstring& s
 		return false;
 	}
 
+	if (m_OptionReferences) m_OptionReferences->isVolatile = true;
+
 	const std::wstring selector = strVariable.substr(colonPos + 1);
 	const WCHAR* selectorSz = selector.c_str();
 	strVariable.resize(colonPos);
@@ -382,6 +485,8 @@ bool ConfigParser::GetSectionVariable(std::wstring& strVariable, std::wstring& s
 	Measure* measure = m_Skin->GetMeasure(strVariable);
 	if (measure)
 	{
+		RefreshMeasure(measure);
+
 		if (valueType == ValueType::EscapeRegExp)
 		{
 			const WCHAR* tmp = measure->GetStringValue();
@@ -505,6 +610,8 @@ void ConfigParser::SetMultiMonitorVariables(bool reset)
 		c_MonitorVariables[variable] = value;
 	};
 
+	++c_MonitorVariableGeneration;
+
 	if (!reset && c_MonitorVariables.empty())
 	{
 		reset = true;  // Set all variables
@@ -827,6 +934,8 @@ bool ConfigParser::ReplaceMeasures(std::wstring& result)
 				Measure* measure = GetMeasure(var);
 				if (measure)
 				{
+					AddMeasureReference(measure);
+
 					const WCHAR* value = measure->GetStringOrFormattedValue(AUTOSCALE_OFF, 1.0, -1, false);
 					size_t valueLen = wcslen(value);
 
@@ -869,6 +978,11 @@ bool ConfigParser::ReplaceMeasures(std::wstring& result)
 /*
 ** Replaces nested measure/section variables, regular variables, and mouse variables in the given string.
 **
+** The string is read once from left to right. The positions of the '[' characters are kept on a
+** stack so that each ']' is matched with the innermost '[' that forms a known variable. The value
+** of a replaced variable is read again as if it had been part of the string, which replaces any
+** variables that the value itself contains (or that the value completes, e.g. [#Var[#Index]]).
+**
 */
 bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Meter* meter)
 {
@@ -885,32 +999,75 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 		}
 	}
 
-	// It is possible for a variable to be reset when calling a custom function in a plugin or lua.
-	// Copy the result here, and replace it before returning.
-	std::wstring result = str;
-	bool replaced = false;
+	// It is possible for a variable to be reset when calling a custom function in a plugin or lua,
+	// which may also parse variables. Each level of recursion uses its own buffers.
+	if (m_VariableBuffers.size() <= m_VariableDepth)
+	{
+		m_VariableBuffers.emplace_back(new VariableBuffers());
+	}
+	VariableBuffers& buffers = *m_VariableBuffers[m_VariableDepth++];
 
-	size_t previousStart = 0ULL;
-	std::wstring previousVariable;
+	std::vector<WCHAR>& input = buffers.input;
+	input.assign(str.rbegin(), str.rend());
+
+	std::wstring& result = buffers.result;
+	result.clear();
+
+	std::vector<size_t>& starts = buffers.starts;
+	starts.clear();
+
+	std::wstring& variable = buffers.variable;
+	std::wstring& foundValue = buffers.value;
+	// The previous variable is kept as a position in |result| and only copied when that part of
+	// |result| is about to change.
+	std::wstring& previousVariable = buffers.previous;
+	size_t previousStart = std::wstring::npos;
+	size_t previousLength = 0ULL;
+	bool isPreviousCopied = true;
+	auto copyPrevious = [&](size_t pos)
+	{
+		if (!isPreviousCopied && previousStart + 1ULL + previousLength > pos)
+		{
+			previousVariable.assign(result, previousStart + 1ULL, previousLength);
+			isPreviousCopied = true;
+		}
+	};
+
+	bool replaced = false;
 
 	Logger::Entry delayedLogEntry = { Logger::Level::Debug, L"", L"", L"" };
 
-	// Because each nested variable needs to be re-parsed from the beginning of the replaced string,
-	// self-references can be detected multiple times during the variable replacement process.
-	// In these cases, provide a warning to the user before returning.
+	// Because the value of a nested variable is parsed again, self-references can be detected
+	// multiple times during the variable replacement process. In these cases, provide a warning to
+	// the user before returning.
 	std::wstring selfReferencedVariable;
 
 	// Max number of variable replacements for |str|
 	static const size_t maxReplacements = 1000ULL;
-
-	// Find the innermost section variable(s) first, then move outward (working left to right)
-	size_t end = 0ULL;
 	size_t counter = 0ULL;
-	while ((end = result.find(L']', end)) != std::wstring::npos)
+
+	const WCHAR typeKey = c_VariableMap.find(type)->second;
+	const WCHAR variableKey = c_VariableMap[VariableType::Variable];
+
+	while (!input.empty())
 	{
+		const WCHAR ch = input.back();
+		input.pop_back();
+
+		if (ch == L'[')
+		{
+			starts.push_back(result.length());
+		}
+
+		result.push_back(ch);
+		if (ch != L']') continue;
+
 		// Restrict the number of variable replacements to a reseasonable amount
 		if (++counter >= maxReplacements)
 		{
+			result.append(input.rbegin(), input.rend());
+			input.clear();
+
 			LogErrorSF(m_Skin, m_CurrentSection->c_str(),
 				L"Parsing Error: Maximum number of variable replacements reached (%llu) in string: %s", maxReplacements, str.c_str());
 			if (GetRainmeter().GetDebug())
@@ -920,14 +1077,14 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 			break;
 		}
 
-		bool found = false;
-
+		const size_t end = result.length() - 1ULL;
 		const size_t ei = end - 1ULL;
-		size_t start = ei;
+		bool found = false;
 
-		while ((start = result.rfind(L'[', start)) != std::wstring::npos)
+		// Try the innermost starting bracket first, then move outward
+		for (size_t i = starts.size(); i-- > 0ULL; )
 		{
-			found = false;
+			const size_t start = starts[i];
 			size_t si = start + 2ULL;  // Start index where escaped variable "should" be: [ *   *]
 
 			// Check for escaped variables first, if found, skip to the next variable
@@ -938,38 +1095,46 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 				// are parsed. So we need to leave the escape *'s when called from the mouse parser.
 				if (type != VariableType::Mouse)
 				{
+					copyPrevious(si);
 					result.erase(ei, 1ULL);
 					result.erase(si, 1ULL);
+
+					// Move the starting brackets after the removed '*'
+					for (size_t j = i + 1ULL; j < starts.size(); ++j)
+					{
+						if (starts[j] > si) --starts[j];
+					}
 				}
-				break;		// Break out of inner "start" loop and continue to the next nested variable
+				break;		// Continue to the next nested variable
 			}
 
 			--si;  // Move index to the "key" character (if it exists)
 
 			// Avoid empty commands
-			std::wstring original = result.substr(si, end - si);
-			if (original.empty())
+			const size_t length = end - si;
+			if (length == 0ULL)
 			{
-				break;		// Break out of inner "start" loop and continue to the next nested variable
+				break;		// Continue to the next nested variable
 			}
 
 			// Avoid self references
-			if (previousStart == start && _wcsicmp(original.c_str(), previousVariable.c_str()) == 0)
+			if (previousStart == start && previousLength == length &&
+				(!isPreviousCopied || _wcsnicmp(previousVariable.c_str(), &result[si], length) == 0))
 			{
 				LogErrorSF(m_Skin, m_CurrentSection->c_str(),
-					L"Cannot replace variable with itself: \"%s\"", original.c_str());
-				break;		// Break out of inner "start" loop and continue to the next nested variable
+					L"Cannot replace variable with itself: \"%s\"", result.substr(si, length).c_str());
+				break;		// Continue to the next nested variable
 			}
 
-			previousVariable = original;
 			previousStart = start;
+			previousLength = length;
+			isPreviousCopied = false;
 
 			// Separate "key" character from variable
-			const WCHAR key = result.substr(si, 1ULL).c_str()[0];
-			std::wstring variable = result.substr(si + 1ULL, end - si - 1ULL);
-			if (variable.empty())
+			const WCHAR key = result[si];
+			if (length == 1ULL)
 			{
-				break; // Break out of inner "start" loop and continue to the next nested variable
+				break;		// Continue to the next nested variable
 			}
 
 			// Find "type" of key
@@ -985,15 +1150,14 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 				}
 			}
 
-			// |key| is invalid or variable name is empty ([#], [&], [$], [\])
+			// |key| is invalid ([#], [&], [$], [\])
 			if (!isValid)
 			{
-				if (start == 0ULL) break;	// Already at beginning of string, try next ending bracket
-
-				--start;		// Check for any "starting" brackets in string prior to the current starting position
-				continue;		// This is not a valid nested variable, check the next starting bracket
+				continue;	// This is not a valid nested variable, check the next starting bracket
 			}
 
+			variable.assign(result, si + 1ULL, length - 1ULL);
+
 			// Since regular variables are replaced just before section variables in most cases, we replace
 			// both types at the same time in case nesting of the different types occurs. The only side effect
 			// is new-style regular variables located in an action will now be "dynamic" just like section
@@ -1004,11 +1168,9 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 			//    parsed afterward. One example is when "@Include" is parsed.
 			//  Special case 3: Always process escaped character references.
 
-			std::wstring foundValue;
-
-			if ((key == c_VariableMap.find(type)->second) ||										// Special cases 1, 2
-				(kType == VariableType::CharacterReference) ||										// Special case 3
-				(type == VariableType::Section && key == c_VariableMap[VariableType::Variable]))	// Most cases
+			if ((key == typeKey) ||													// Special cases 1, 2
+				(kType == VariableType::CharacterReference) ||						// Special case 3
+				(type == VariableType::Section && key == variableKey))				// Most cases
 			{
 				switch (kType)
 				{
@@ -1017,6 +1179,8 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 						Measure* measure = GetMeasure(variable);
 						if (measure)
 						{
+							AddMeasureReference(measure);
+
 							const WCHAR* value = measure->GetStringOrFormattedValue(AUTOSCALE_OFF, 1.0, -1, false);
 							foundValue.assign(value, wcslen(value));
 							found = true;
@@ -1075,46 +1239,44 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 
 			if (found)
 			{
-				// Look for any potential self-references in the "found" value
-				auto findVariable = [&](WCHAR postfix) -> void
+				// Look for any potential self-references in the "found" value. Only check for
+				// self-references if none have been found.
+				if (selfReferencedVariable.empty() && foundValue.find(L'[') != std::wstring::npos)
 				{
-					// Only check for self-references if none have been found
-					if (selfReferencedVariable.empty())
+					std::wstring var(result, start, end - start);
+					var += L']';  // Look for any nested variables.  ex. [#Variable]
+					bool isSelfReference = StringUtil::CaseInsensitiveFind(foundValue, var) != -1;
+					if (!isSelfReference)
 					{
-						const std::wstring var = L"[" + original + postfix;
-						if (StringUtil::CaseInsensitiveFind(foundValue, var) != -1)
-						{
-							selfReferencedVariable = original;  // Reports only the first self-reference
-						}
+						var.back() = L':';  // Look for any section variables with parameters.  ex. [&Measure:
+						isSelfReference = StringUtil::CaseInsensitiveFind(foundValue, var) != -1;
 					}
-				};
 
-				findVariable(L']');  // Look for any nested variables.  ex. [#Variable]
-				findVariable(L':');  // Look for any section variables with parameters.  ex. [&Measure:
+					if (isSelfReference)
+					{
+						selfReferencedVariable.assign(result, si, length);  // Reports only the first self-reference
+					}
+				}
 
-				result.replace(start, end - start + 1ULL, foundValue);
+				// Replace the variable and read its value next
+				copyPrevious(start);
+				result.resize(start);
+				starts.resize(i);
+				input.insert(input.end(), foundValue.rbegin(), foundValue.rend());
 				replaced = true;
-
-				end = start - 1ULL;
-				break;		// Break out of inner "start" loop and continue to the next nested variable
+				break;		// Continue to the next nested variable
 			}
 
-			// No variable found
-
-			if (start == 0ULL) break;	// Already at beginning of string, try next ending bracket
-
-			--start;		// Check for any "starting" brackets in string prior to the current starting position
+			// No variable found, check the next starting bracket
 		}
 
-		if (!delayedLogEntry.message.empty() && found && start == previousStart)
+		if (!delayedLogEntry.message.empty() && found)
 		{
 			// Since custom script/plugin functions can accept single brackets as parameters, it is possible that
 			// the nested variable parser can produce errors when determining function names. Reset any delayed
 			// messages if the variable at the starting position was found.
-			delayedLogEntry = { Logger::Level::Debug, L"", L"", L"" }; 
+			delayedLogEntry = { Logger::Level::Debug, L"", L"", L"" };
 		}
-
-		++end;	// Check for the next "end" bracket after the current ending bracket
 	}
 
 	if (!delayedLogEntry.message.empty())
@@ -1139,7 +1301,8 @@ bool ConfigParser::ParseVariables(std::wstring& str, const VariableType type, Me
 		m_CurrentSection->clear();
 	}
 
-	str = result;
+	str.assign(result);
+	--m_VariableDepth;
 	return replaced;
 }
 
@@ -1164,6 +1327,8 @@ std::wstring ConfigParser::GetMouseVariable(const std::wstring& variable, Meter*
 	LPCWSTR var = variable.c_str();
 	WCHAR buffer[32] = { 0 };
 
+	if (m_OptionReferences) m_OptionReferences->isVolatile = true;
+
 	POINT pt = { 0 };
 	GetCursorPos(&pt);
 
@@ -1207,75 +1372,72 @@ std::wstring ConfigParser::GetMouseVariable(const std::wstring& variable, Meter*
 
 const std::wstring& ConfigParser::ReadString(LPCTSTR section, LPCTSTR key, LPCTSTR defValue, bool bReplaceMeasures)
 {
-	static std::wstring result;
+	std::wstring& result = m_Result;
 
 	// Clear last status
 	m_LastReplaced = false;
 	m_LastDefaultUsed = false;
 	m_LastValueDefined = false;
 
-	const std::wstring strSection = section;
-	const std::wstring strKey = key;
-	const std::wstring strDefault = defValue;
+	const size_t sectionLength = wcslen(section);
+	const UINT keyId = m_Options.FindKey(key, wcslen(key));
 
-	const std::wstring& strValue = GetValue(strSection, strKey, strDefault);
-	if (&strValue == &strDefault)
+	const std::wstring* strValue = m_Options.GetValue(m_Options.FindSection(section, sectionLength), keyId);
+	if (!strValue)
 	{
-		bool foundStyleValue = false;
-
 		// If the template is defined read the value from there.
 		std::vector<std::wstring>::const_reverse_iterator iter = m_StyleTemplate.rbegin();
 		for ( ; iter != m_StyleTemplate.rend(); ++iter)
 		{
-			const std::wstring& strStyleValue = GetValue((*iter), strKey, strDefault);
-
-			//LogDebugF(L"StyleTemplate: [%s] %s (from [%s]) : strDefault=%s (0x%p), strStyleValue=%s (0x%p)",
-			//	section, key, (*iter).c_str(), strDefault.c_str(), &strDefault, strStyleValue.c_str(), &strStyleValue);
-
-			if (&strStyleValue != &strDefault)
-			{
-				result = strStyleValue;
-				foundStyleValue = true;
-				break;
-			}
+			strValue = m_Options.GetValue(m_Options.FindSection(*iter), keyId);
+			if (strValue) break;
 		}
 
-		if (!foundStyleValue)
+		if (!strValue)
 		{
-			result = strDefault;
+			result = defValue;
 			m_LastDefaultUsed = true;
 			return result;
 		}
 	}
-	else
-	{
-		result = strValue;
-	}
+
+	result = *strValue;
 
 	if (!result.empty())
 	{
-		m_CurrentSection->assign(strSection);  // Set temporarily
+		m_CurrentSection->assign(section, sectionLength);  // Set temporarily
 		m_LastValueDefined = true;
 
-		if (result.size() >= 3)
+		if (result.size() >= 3 && result.find_first_of(L"#[%") != std::wstring::npos)
 		{
-			if (result.find(L'#') != std::wstring::npos)
+			const bool isVariables = wcscmp(section, L"Variables") == 0;
+			if (bReplaceMeasures && !isVariables)
 			{
-				// Make sure new-style variables are processed for the [Variables] section
-				bool runNewStyle = strSection == L"Variables" ? true : false;
-				if (ReplaceVariables(result, runNewStyle))
+				const uint64_t id = ((uint64_t)m_Options.AddSection(section, sectionLength) << 32) | keyId;
+				if (ReplaceWithTemplate(id, result))
 				{
 					m_LastReplaced = true;
 				}
 			}
 			else
 			{
-				PathUtil::ExpandEnvironmentVariables(result);
-			}
+				if (result.find(L'#') != std::wstring::npos)
+				{
+					// Make sure new-style variables are processed for the [Variables] section
+					if (ReplaceVariables(result, isVariables))
+					{
+						m_LastReplaced = true;
+					}
+				}
+				else
+				{
+					PathUtil::ExpandEnvironmentVariables(result);
+				}
 
-			if (bReplaceMeasures && ReplaceMeasures(result))
-			{
-				m_LastReplaced = true;
+				if (bReplaceMeasures && ReplaceMeasures(result))
+				{
+					m_LastReplaced = true;
+				}
 			}
 		}
 		m_CurrentSection->clear();  // Reset
@@ -1284,6 +1446,258 @@ const std::wstring& ConfigParser::ReadString(LPCTSTR section, LPCTSTR key, LPCTS
 	return result;
 }
 
+/*
+** Replaces the variables and measures in the value of the given option. The value is parsed into
+** a template the first time, and the template is used until the value or any variable changes.
+**
+*/
+bool ConfigParser::ReplaceWithTemplate(uint64_t id, std::wstring& result)
+{
+	OptionTemplate& tmpl = m_OptionTemplates[id];
+
+	if (tmpl.variableGeneration != m_VariableGeneration ||
+		tmpl.monitorVariableGeneration != c_MonitorVariableGeneration ||
+		tmpl.raw != result)
+	{
+		tmpl.raw = result;
+		tmpl.variableGeneration = m_VariableGeneration;
+		tmpl.monitorVariableGeneration = c_MonitorVariableGeneration;
+
+		// Record the variables used to build the template so that they can be reported on every read
+		OptionReferences references = {};
+		OptionReferences* previousReferences = SetOptionReferences(&references);
+
+		std::wstring str = result;
+		if (str.find(L'#') != std::wstring::npos)
+		{
+			tmpl.replaced = ReplaceVariables(str);
+		}
+		else
+		{
+			PathUtil::ExpandEnvironmentVariables(str);
+			tmpl.replaced = false;
+		}
+
+		tmpl.dynamic = !BuildOptionTemplate(tmpl, str);
+		tmpl.rendered = false;
+
+		SetOptionReferences(previousReferences);
+		tmpl.variables.swap(references.variables);
+		tmpl.isVolatile = references.isVolatile;
+	}
+
+	if (m_OptionReferences)
+	{
+		m_OptionReferences->variables.insert(
+			m_OptionReferences->variables.end(), tmpl.variables.cbegin(), tmpl.variables.cend());
+		if (tmpl.isVolatile) m_OptionReferences->isVolatile = true;
+	}
+
+	if (tmpl.dynamic || !RenderOptionTemplate(tmpl))
+	{
+		bool replaced = false;
+		if (result.find(L'#') != std::wstring::npos)
+		{
+			replaced = ReplaceVariables(result);
+		}
+		else
+		{
+			PathUtil::ExpandEnvironmentVariables(result);
+		}
+
+		if (ReplaceMeasures(result))
+		{
+			replaced = true;
+		}
+
+		return replaced;
+	}
+
+	result = tmpl.result;
+	return tmpl.replaced;
+}
+
+/*
+** Splits |str|, which has its regular variables replaced, into literal text and measure
+** references. Returns false if |str| contains anything that must be parsed every time it is read
+** (e.g. section variables that may call Lua or plugin functions).
+**
+*/
+bool ConfigParser::BuildOptionTemplate(OptionTemplate& tmpl, const std::wstring& str)
+{
+	tmpl.parts.clear();
+	tmpl.parts.emplace_back();
+
+	size_t pos = 0ULL;
+	while (pos < str.length())
+	{
+		const size_t start = str.find(L'[', pos);
+		const size_t end = str.find(L']', pos);
+		if (end < start)
+		{
+			return false;  // Unbalanced closing bracket
+		}
+
+		if (end == std::wstring::npos)
+		{
+			tmpl.parts.back().text.append(str, pos, std::wstring::npos);
+			break;
+		}
+
+		if (str.find(L'[', start + 1ULL) < end)
+		{
+			return false;  // Nested variable
+		}
+
+		tmpl.parts.back().text.append(str, pos, start - pos);
+		pos = end + 1ULL;
+
+		const std::wstring name = str.substr(start + 1ULL, end - start - 1ULL);
+		if (name.find_first_of(L"*:") != std::wstring::npos)
+		{
+			return false;  // Escaped variable or section variable
+		}
+
+		if (name.empty())
+		{
+			tmpl.parts.back().text.append(str, start, pos - start);
+			continue;
+		}
+
+		Measure* measure = GetMeasure(name);
+		if (!measure)
+		{
+			switch (name[0])
+			{
+			case L'&':
+				measure = GetMeasure(name.c_str() + 1, name.length() - 1ULL);
+				break;
+
+			case L'#':
+				{
+					const std::wstring* value = GetVariable(name.substr(1ULL));
+					if (value)
+					{
+						// The replaced value is parsed again for nested variables
+						if (value->find_first_of(L"[]") != std::wstring::npos) return false;
+
+						tmpl.parts.back().text.append(*value);
+						tmpl.replaced = true;
+						continue;
+					}
+				}
+				break;
+
+			case L'\\':
+				return false;  // Character reference
+			}
+		}
+		else if (name[0] == L'&' || name[0] == L'#' || name[0] == L'\\')
+		{
+			return false;  // The measure name could be parsed as a new-style variable first
+		}
+
+		if (measure)
+		{
+			tmpl.parts.back().measure = measure;
+			tmpl.parts.emplace_back();
+			tmpl.replaced = true;
+		}
+		else
+		{
+			tmpl.parts.back().text.append(str, start, pos - start);
+		}
+	}
+
+	return true;
+}
+
+/*
+** Updates the result of |tmpl| with the current measure values. Returns false if a value must be
+** parsed for nested variables.
+**
+*/
+bool ConfigParser::RenderOptionTemplate(OptionTemplate& tmpl)
+{
+	bool changed = !tmpl.rendered;
+	for (auto& part : tmpl.parts)
+	{
+		if (!part.measure) continue;
+
+		AddMeasureReference(part.measure);
+
+		const WCHAR* value = part.measure->GetStringOrFormattedValue(AUTOSCALE_OFF, 1.0, -1, false);
+		if (wcspbrk(value, L"[]")) return false;
+
+		if (!changed && part.value == value) continue;
+
+		part.value = value;
+		changed = true;
+	}
+
+	if (changed)
+	{
+		tmpl.result.clear();
+		for (const auto& part : tmpl.parts)
+		{
+			tmpl.result += part.text;
+			tmpl.result += part.value;
+		}
+		tmpl.rendered = true;
+	}
+
+	return true;
+}
+
+void ConfigParser::AddMeasureReference(Measure* measure)
+{
+	if (m_MeasureReferences) m_MeasureReferences->push_back(measure);
+
+	// Measure values can change on every update
+	if (m_OptionReferences) m_OptionReferences->isVolatile = true;
+
+	RefreshMeasure(measure);
+}
+
+/*
+** The value of |measure| is about to be read, so update the measure if it was skipped
+** (LazyMeasures=1). Updating it may read options with this parser (e.g. with DynamicVariables=1),
+** so the state of the current read is kept.
+**
+*/
+void ConfigParser::RefreshMeasure(Measure* measure)
+{
+	if (m_OptionReferences) m_OptionReferences->measures.push_back(measure);
+
+	if (!m_Skin || !measure->IsStale()) return;
+
+	const std::wstring result = m_Result;
+	const std::wstring currentSection = *m_CurrentSection;
+	const bool lastReplaced = m_LastReplaced;
+	const bool lastDefaultUsed = m_LastDefaultUsed;
+	const bool lastValueDefined = m_LastValueDefined;
+
+	// The options of the measure are not read with the style template of the current meter and
+	// their references are not recorded for the current section.
+	std::vector<std::wstring> styleTemplate;
+	styleTemplate.swap(m_StyleTemplate);
+	OptionReferences* optionReferences = SetOptionReferences(nullptr);
+	std::vector<Measure*>* measureReferences = m_MeasureReferences;
+	m_MeasureReferences = nullptr;
+
+	m_Skin->RefreshMeasure(measure);
+
+	m_MeasureReferences = measureReferences;
+	SetOptionReferences(optionReferences);
+	m_StyleTemplate.swap(styleTemplate);
+
+	m_LastValueDefined = lastValueDefined;
+	m_LastDefaultUsed = lastDefaultUsed;
+	m_LastReplaced = lastReplaced;
+	m_CurrentSection->assign(currentSection);
+	m_Result.assign(result);
+}
+
 bool ConfigParser::IsKeyDefined(LPCTSTR section, LPCTSTR key)
 {
 	ReadString(section, key, L"", false);
@@ -1300,19 +1714,21 @@ void ConfigParser::AddMeasure(Measure* pMeasure)
 {
 	if (pMeasure)
 	{
-		m_Measures[StrToUpper(pMeasure->GetOriginalName())] = pMeasure;
+		m_Measures.Add(pMeasure);
+
+		// Text such as [Name] in a cached template may now refer to this measure
+		m_OptionTemplates.clear();
 	}
 }
 
 Measure* ConfigParser::GetMeasure(const std::wstring& name)
 {
-	std::unordered_map<std::wstring, Measure*>::const_iterator iter = m_Measures.find(StrToUpper(name));
-	if (iter != m_Measures.end())
-	{
-		return (*iter).second;
-	}
+	return m_Measures.Find(name);
+}
 
-	return nullptr;
+Measure* ConfigParser::GetMeasure(const WCHAR* name, size_t length)
+{
+	return m_Measures.Find(name, length);
 }
 
 std::vector<FLOAT> ConfigParser::ReadFloats(LPCTSTR section, LPCTSTR key)
@@ -1321,6 +1737,11 @@ std::vector<FLOAT> ConfigParser::ReadFloats(LPCTSTR section, LPCTSTR key)
 	const std::wstring& str = ReadString(section, key, L"");
 	if (!str.empty())
 	{
+		if (const std::vector<FLOAT>* memo = m_FloatsMemo.Find(str))
+		{
+			return *memo;
+		}
+
 		// Tokenize and parse the floats
 		const WCHAR delimiter = L';';
 		size_t lastPos = 0ULL, pos = 0ULL;
@@ -1337,6 +1758,8 @@ std::vector<FLOAT> ConfigParser::ReadFloats(LPCTSTR section, LPCTSTR key)
 			++pos;
 		}
 		while (true);
+
+		m_FloatsMemo.Insert(str, result);
 	}
 	return result;
 }
@@ -1351,7 +1774,7 @@ int ConfigParser::ReadInt(LPCTSTR section, LPCTSTR key, int defValue)
 		if (*str == L'(')
 		{
 			double dblValue = 0.0;
-			const WCHAR* errMsg = MathParser::CheckedParse(str, &dblValue);
+			const WCHAR* errMsg = CheckedParseFormula(result, &dblValue);
 			if (!errMsg)
 			{
 				return (int)dblValue;
@@ -1383,7 +1806,7 @@ uint32_t ConfigParser::ReadUInt(LPCTSTR section, LPCTSTR key, uint32_t defValue)
 		if (*str == L'(')
 		{
 			double dblValue = 0.0;
-			const WCHAR* errMsg = MathParser::CheckedParse(str, &dblValue);
+			const WCHAR* errMsg = CheckedParseFormula(result, &dblValue);
 			if (!errMsg)
 			{
 				return (uint32_t)dblValue;
@@ -1415,7 +1838,7 @@ uint64_t ConfigParser::ReadUInt64(LPCTSTR section, LPCTSTR key, uint64_t defValu
 		if (*str == L'(')
 		{
 			double dblValue = 0.0;
-			const WCHAR* errMsg = MathParser::CheckedParse(str, &dblValue);
+			const WCHAR* errMsg = CheckedParseFormula(result, &dblValue);
 			if (!errMsg)
 			{
 				return (uint64_t)dblValue;
@@ -1447,7 +1870,7 @@ double ConfigParser::ReadFloat(LPCTSTR section, LPCTSTR key, double defValue)
 		const WCHAR* str = result.c_str();
 		if (*str == L'(')
 		{
-			const WCHAR* errMsg = MathParser::CheckedParse(str, &value);
+			const WCHAR* errMsg = CheckedParseFormula(result, &value);
 			if (!errMsg)
 			{
 				return value;
@@ -1517,31 +1940,49 @@ std::wstring ConfigParser::ParseFormulaWithModifiers(const std::wstring& formula
 D2D1_COLOR_F ConfigParser::ReadColor(LPCTSTR section, LPCTSTR key, const D2D1_COLOR_F& defValue)
 {
 	const std::wstring& result = ReadString(section, key, L"");
+	if (m_LastDefaultUsed || result.empty()) return defValue;
 
-	return (m_LastDefaultUsed || result.empty()) ? defValue : ParseColor(result.c_str());
+	const D2D1_COLOR_F* memo = m_ColorMemo.Find(result);
+	return memo ? *memo : m_ColorMemo.Insert(result, ParseColor(result.c_str()));
 }
 
 D2D1_RECT_F ConfigParser::ReadRect(LPCTSTR section, LPCTSTR key, const D2D1_RECT_F& defValue)
 {
 	const std::wstring& result = ReadString(section, key, L"");
+	if (m_LastDefaultUsed) return defValue;
 
-	return (m_LastDefaultUsed) ? defValue : ParseRect(result.c_str());
+	const D2D1_RECT_F* memo = m_RectMemo.Find(result);
+	return memo ? *memo : m_RectMemo.Insert(result, ParseRect(result.c_str()));
 }
 
 RECT ConfigParser::ReadRECT(LPCTSTR section, LPCTSTR key, const RECT& defValue)
 {
 	const std::wstring& result = ReadString(section, key, L"");
+	if (m_LastDefaultUsed) return defValue;
 
-	RECT r = { 0 };
-	if (m_LastDefaultUsed)
+	const RECT* memo = m_RECTMemo.Find(result);
+	return memo ? *memo : m_RECTMemo.Insert(result, ParseRECT(result.c_str()));
+}
+
+/*
+** Evaluates the formula or returns the result of an earlier evaluation of the same formula.
+** Formulas with errors are not memoized so that the error is logged every time.
+**
+*/
+const WCHAR* ConfigParser::CheckedParseFormula(const std::wstring& formula, double* value)
+{
+	if (const double* memo = m_FormulaMemo.Find(formula))
 	{
-		r = defValue;
+		*value = *memo;
+		return nullptr;
 	}
-	else
+
+	const WCHAR* errMsg = MathParser::CheckedParse(formula.c_str(), value);
+	if (!errMsg)
 	{
-		r = ParseRECT(result.c_str());
+		m_FormulaMemo.Insert(formula, *value);
 	}
-	return r;
+	return errMsg;
 }
 
 /*
@@ -1918,97 +2359,74 @@ RECT ConfigParser::ParseRECT(LPCTSTR str)
 }
 
 /*
-** Reads the given ini file and fills the m_Values and m_Keys maps.
+** Reads the given ini file and fills the option store.
 **
 */
 void ConfigParser::ReadIniFile(const std::wstring& iniFile, LPCTSTR skinSection, int depth)
 {
 	if (depth > 100)	// Is 100 enough to assume the include loop never ends?
 	{
+		m_CacheFiles = nullptr;  // Do not cache the result
 		GetRainmeter().ShowMessage(nullptr, GetString(ID_STR_INCLUDEINFINITELOOP), MB_OK | MB_ICONERROR);
 		return;
 	}
 
+	// Get the file time before reading so that a change while reading invalidates the caches
+	const ConfigCache::File file = ConfigCache::GetFile(iniFile);
+	if (m_CacheFiles)
+	{
+		m_CacheFiles->push_back(file);
+	}
+
 	// Verify whether the file exists
-	if (_waccess_s(iniFile.c_str(), 0) != 0)
+	if (file.size == ConfigCache::c_MissingFile)
 	{
 		LogErrorF(m_Skin, L"Unable to read file: %s", iniFile.c_str());
 		return;
 	}
 
-	// Avoid "IniFileMapping"
-	std::wstring iniRead = System::GetTemporaryFile(iniFile);
-	bool temporary = (!iniRead.empty() && (iniRead.size() != 1 || iniRead[0] != L'?'));
+	if (GetRainmeter().GetDebug()) LogDebugF(m_Skin, L"Reading file: %s", iniFile.c_str());
 
-	if (temporary)
+	// The file is read and parsed once. Unlike GetPrivateProfileSection(), this is not affected
+	// by "IniFileMapping" so there is no need to copy the file first. Included files are often
+	// shared by many skins, so they are parsed once for all skins.
+	IniFileSections sharedSections;
+	if (depth > 0)
 	{
-		if (GetRainmeter().GetDebug()) LogDebugF(m_Skin, L"Reading file: %s (Temp: %s)", iniFile.c_str(), iniRead.c_str());
+		sharedSections = GetIniFileCache().Get(file);
 	}
 	else
 	{
-		if (GetRainmeter().GetDebug()) LogDebugF(m_Skin, L"Reading file: %s", iniFile.c_str());
-		iniRead = iniFile;
+		auto fileSections = std::make_shared<std::vector<IniFile::Section>>();
+		if (IniFile::Read(iniFile, *fileSections))
+		{
+			sharedSections = fileSections;
+		}
+	}
+
+	if (!sharedSections)
+	{
+		return;
 	}
 
+	const std::vector<IniFile::Section>& iniSections = *sharedSections;
+
 	// Get all the sections (i.e. different meters)
-	std::list<std::wstring> sections;
+	std::vector<const IniFile::Section*> sections;
 	std::unordered_set<std::wstring> unique;
 	std::wstring key, value;  // buffer
 
-	DWORD itemsSize = MAX_LINE_LENGTH;
-	WCHAR* items = new WCHAR[itemsSize];
-	WCHAR* pos = nullptr;
-	WCHAR* epos = nullptr;
-
 	if (skinSection == nullptr)
 	{
-		// Get all the sections
-		do
+		// Section names are already unique within the file
+		for (const auto& section : iniSections)
 		{
-			items[0] = 0;
-			DWORD res = GetPrivateProfileSectionNames(items, itemsSize, iniRead.c_str());
-			if (res == 0)		// File not found
+			StrToUpperC(key.assign(section.name));
+			if (m_FoundSections.insert(key).second)
 			{
-				delete [] items;
-				items = nullptr;
-				if (temporary) System::RemoveFile(iniRead);
-				return;
-			}
-			if (res < itemsSize - 2)		// Fits in the buffer
-			{
-				epos = items + res;
-				break;
-			}
-
-			delete [] items;
-			items = nullptr;
-			itemsSize *= 2UL;
-			items = new WCHAR[itemsSize];
-		}
-		while (true);
-
-		// Read the sections
-		pos = items;
-		while (pos < epos)
-		{
-			if (*pos)
-			{
-				value = pos;  // section name
-				StrToUpperC(key.assign(value));
-				if (unique.insert(key).second)
-				{
-					if (m_FoundSections.insert(key).second)
-					{
-						m_Sections.insert(m_SectionInsertPos, value);
-					}
-					sections.push_back(value);
-				}
-				pos += value.size() + 1;
-			}
-			else  // Empty string
-			{
-				++pos;
+				m_Sections.insert(m_SectionInsertPos, section.name);
 			}
+			sections.push_back(&section);
 		}
 	}
 	else
@@ -2017,8 +2435,17 @@ void ConfigParser::ReadIniFile(const std::wstring& iniFile, LPCTSTR skinSection,
 		const std::wstring strRainmeter = L"Rainmeter";
 		const std::wstring strFolder = skinSection;
 
-		sections.push_back(strRainmeter);
-		sections.push_back(strFolder);
+		for (const auto& section : iniSections)
+		{
+			if (_wcsicmp(section.name.c_str(), strRainmeter.c_str()) == 0)
+			{
+				sections.insert(sections.begin(), &section);
+			}
+			else if (_wcsicmp(section.name.c_str(), strFolder.c_str()) == 0)
+			{
+				sections.push_back(&section);
+			}
+		}
 
 		if (depth == 0)  // Add once
 		{
@@ -2032,165 +2459,292 @@ void ConfigParser::ReadIniFile(const std::wstring& iniFile, LPCTSTR skinSection,
 	{
 		unique.clear();
 
-		const WCHAR* sectionName = (*it).c_str();
+		const std::wstring& section = (*it)->name;
+		const WCHAR* sectionName = section.c_str();
 		bool isVariables = (_wcsicmp(sectionName, L"Variables") == 0);
 		bool isMetadata = (skinSection == nullptr && !isVariables && _wcsicmp(sectionName, L"Metadata") == 0);
 		bool resetInsertPos = true;
 
 		// Read all "key=value" from the section
-		do
+		for (const auto& item : (*it)->keys)
 		{
-			items[0] = 0;
-			DWORD res = GetPrivateProfileSection(sectionName, items, itemsSize, iniRead.c_str());
-			if (res < itemsSize - 2UL)		// Fits in the buffer
+			key = item.first;
+			std::wstring original = key;
+			StrToUpperC(key);
+			if (unique.insert(key).second)
 			{
-				epos = items + res;
-				break;
-			}
+				const WCHAR* sep = item.second.c_str();
+				size_t clen = item.second.length();  // value's length
 
-			delete [] items;
-			items = nullptr;
-			itemsSize *= 2UL;
-			items = new WCHAR[itemsSize];
-		}
-		while (true);
-
-		pos = items;
-		while (pos < epos)
-		{
-			if (*pos)
-			{
-				size_t len = wcslen(pos);
-				WCHAR* sep = wmemchr(pos, L'=', len);
-				if (sep != nullptr && sep != pos)
+				// Trim surrounded quotes from value
+				if (clen >= 2 && (sep[0] == L'"' || sep[0] == L'\'') && sep[clen - 1] == sep[0])
 				{
-					size_t clen = sep - pos;  // key's length
+					clen -= 2;
+					++sep;
+				}
 
-					key.assign(pos, clen);
-					std::wstring original = key;
-					StrToUpperC(key);
-					if (unique.insert(key).second)
+				if (wcsncmp(key.c_str(), L"@INCLUDE", 8) == 0)
+				{
+					if (clen > 0)
 					{
-						++sep;
-						clen = len - (clen + 1);  // value's length
-
-						// Trim surrounded quotes from value
-						if (clen >= 2 && (sep[0] == L'"' || sep[0] == L'\'') && sep[clen - 1] == sep[0])
+						value.assign(sep, clen);
+						ReadVariables();
+						ReplaceVariables(value, true);
+						if (!PathUtil::IsAbsolute(value))
 						{
-							clen -= 2;
-							++sep;
+							// Relative to the ini folder
+							value.insert(0, PathUtil::GetFolderFromFilePath(iniFile));
 						}
 
-						if (wcsncmp(key.c_str(), L"@INCLUDE", 8) == 0)
+						if (resetInsertPos)
 						{
-							if (clen > 0)
+							if (it + 1 == sections.cend())  // Special case: @include was used in the last section of the current file
 							{
-								value.assign(sep, clen);
-								ReadVariables();
-								ReplaceVariables(value, true);
-								if (!PathUtil::IsAbsolute(value))
-								{
-									// Relative to the ini folder
-									value.insert(0, PathUtil::GetFolderFromFilePath(iniFile));
-								}
-
-								if (resetInsertPos)
+								// Set the insertion place to the last
+								m_SectionInsertPos = m_Sections.end();
+								resetInsertPos = false;
+							}
+							else
+							{
+								// Find the appropriate insertion place
+								for (auto jt = m_Sections.cbegin(); jt != m_Sections.cend(); ++jt)
 								{
-									std::list<std::wstring>::const_iterator jt = it;
-									if (++jt == sections.end())  // Special case: @include was used in the last section of the current file
+									if (_wcsicmp((*jt).c_str(), sectionName) == 0)
 									{
-										// Set the insertion place to the last
-										m_SectionInsertPos = m_Sections.end();
+										m_SectionInsertPos = ++jt;
 										resetInsertPos = false;
-									}
-									else
-									{
-										// Find the appropriate insertion place
-										for (jt = m_Sections.cbegin(); jt != m_Sections.cend(); ++jt)
-										{
-											if (_wcsicmp((*jt).c_str(), sectionName) == 0)
-											{
-												m_SectionInsertPos = ++jt;
-												resetInsertPos = false;
-												break;
-											}
-										}
+										break;
 									}
 								}
+							}
+						}
 
-								// Save the section insertion position in case the included file also uses an @Include
-								std::list<std::wstring>::const_iterator prevInsertPos = m_SectionInsertPos;
+						// Save the section insertion position in case the included file also uses an @Include
+						std::list<std::wstring>::const_iterator prevInsertPos = m_SectionInsertPos;
 
-								ReadIniFile(value, skinSection, depth + 1);
+						ReadIniFile(value, skinSection, depth + 1);
 
-								// Reset the section insertion position to previous position
-								m_SectionInsertPos = prevInsertPos;
-							}
-						}
-						else
-						{
-							if (!isMetadata)  // Uncache Metadata's key-value pair in the skin
-							{
-								value.assign(sep, clen);
-								SetValue((*it), key, value);
+						// Reset the section insertion position to previous position
+						m_SectionInsertPos = prevInsertPos;
+					}
+				}
+				else
+				{
+					if (!isMetadata)  // Uncache Metadata's key-value pair in the skin
+					{
+						value.assign(sep, clen);
+						SetValue(section, key, value);
 
-								if (isVariables)
-								{
-									m_ListVariables.push_back(key);
-									m_OriginalVariableNames[key] = original;
-								}
-							}
+						if (isVariables)
+						{
+							m_ListVariables.push_back(key);
+							m_OriginalVariableNames[key] = original;
 						}
 					}
 				}
-				pos += len + 1ULL;
-			}
-			else  // Empty string
-			{
-				++pos;
 			}
 		}
 	}
+}
+
+/*
+** Reads the sections and values of the skin file from the cache. Returns false if there is no
+** cache or if any of the files or built-in variables used to create it have changed.
+**
+*/
+bool ConfigParser::ReadCache(const std::wstring& iniFile)
+{
+	size_t size = 0;
+	auto data = FileUtil::ReadFullFile(ConfigCache::GetCacheFile(iniFile), &size);
+	if (!data) return false;
+
+	ConfigCache::Reader reader(data.get(), size);
+	uint64_t magic = 0ULL, version = 0ULL, count = 0ULL;
+	std::wstring path, name, value;
+	if (!reader.ReadUInt(magic) || magic != c_CacheMagic ||
+		!reader.ReadUInt(version) || version != c_CacheVersion ||
+		!reader.ReadString(path) || _wcsicmp(path.c_str(), iniFile.c_str()) != 0)
+	{
+		return false;
+	}
+
+	// Files that were read (or were missing)
+	std::vector<std::wstring> missingFiles;
+	ConfigCache::File file;
+	reader.ReadUInt(count);
+	while (count-- > 0ULL && reader.ReadString(file.path) && reader.ReadUInt(file.size) && reader.ReadUInt(file.lastWrite))
+	{
+		if (!ConfigCache::IsUnchanged(file)) return false;
+		if (file.size == ConfigCache::c_MissingFile) missingFiles.push_back(file.path);
+	}
 
-	delete [] items;
-	items = nullptr;
-	if (temporary) System::RemoveFile(iniRead);
+	// User-defined variables set before the file was read
+	reader.ReadUInt(count);
+	if (count != m_Variables.size()) return false;
+	while (count-- > 0ULL && reader.ReadString(name) && reader.ReadString(value))
+	{
+		auto iter = m_Variables.find(name);
+		if (iter == m_Variables.end() || iter->second != value) return false;
+	}
+
+	// Variables used in @Include paths
+	reader.ReadUInt(count);
+	while (count-- > 0ULL && reader.ReadString(name) && reader.ReadString(value))
+	{
+		if (GetCacheVariable(name) != value) return false;
+	}
+
+	std::list<std::wstring> sections;
+	reader.ReadUInt(count);
+	while (count-- > 0ULL && reader.ReadString(name))
+	{
+		sections.push_back(name);
+	}
+
+	std::wstring key;
+	reader.ReadUInt(count);
+	while (count-- > 0ULL && reader.ReadString(name) && reader.ReadString(key) && reader.ReadString(value))
+	{
+		m_Options.SetValue(name, key, value);
+	}
+
+	std::list<std::wstring> listVariables;
+	std::vector<std::wstring> originalNames;
+	reader.ReadUInt(count);
+	while (count-- > 0ULL && reader.ReadString(name) && reader.ReadString(value))
+	{
+		listVariables.push_back(name);
+		originalNames.push_back(value);
+	}
+
+	if (!reader.IsComplete())
+	{
+		m_Options.Clear();
+		return false;
+	}
+
+	if (GetRainmeter().GetDebug()) LogDebugF(m_Skin, L"Reading cached file: %s", iniFile.c_str());
+
+	for (const auto& missingFile : missingFiles)
+	{
+		LogErrorF(m_Skin, L"Unable to read file: %s", missingFile.c_str());
+	}
+
+	m_Sections.swap(sections);
+	m_ListVariables.swap(listVariables);
+
+	auto jt = originalNames.cbegin();
+	for (auto it = m_ListVariables.cbegin(); it != m_ListVariables.cend(); ++it, ++jt)
+	{
+		m_OriginalVariableNames[*it] = *jt;
+	}
+
+	return true;
 }
 
 /*
-** Sets the value for the key under the given section.
+** Writes the sections and values read by ReadIniFile to the cache along with the files and
+** variables they depend on.
 **
 */
-void ConfigParser::SetValue(const std::wstring& strSection, const std::wstring& strKey, const std::wstring& strValue)
+void ConfigParser::WriteCache(const std::wstring& iniFile, const std::vector<ConfigCache::File>& files,
+	const std::vector<std::wstring>& variables, const std::unordered_map<std::wstring, std::wstring>& userVariables)
 {
-	// LogDebugF(L"[%s] %s=%s (size: %i)", strSection.c_str(), strKey.c_str(), strValue.c_str(), (int)m_Values.size());
+	ConfigCache::Writer writer;
+	writer.WriteUInt(c_CacheMagic);
+	writer.WriteUInt(c_CacheVersion);
+	writer.WriteString(iniFile);
 
-	std::wstring strTmp;
-	strTmp.reserve(strSection.size() + 1 + strKey.size());
-	strTmp = strSection;
-	strTmp += L'~';
-	strTmp += strKey;
+	writer.WriteUInt(files.size());
+	for (const auto& file : files)
+	{
+		writer.WriteString(file.path);
+		writer.WriteUInt(file.size);
+		writer.WriteUInt(file.lastWrite);
+	}
+
+	writer.WriteUInt(userVariables.size());
+	for (const auto& variable : userVariables)
+	{
+		writer.WriteString(variable.first);
+		writer.WriteString(variable.second);
+	}
 
-	m_Values[StrToUpperC(strTmp)] = strValue;
+	std::unordered_set<std::wstring> unique(variables.cbegin(), variables.cend());
+	writer.WriteUInt(unique.size());
+	for (const auto& name : unique)
+	{
+		writer.WriteString(name);
+		writer.WriteString(GetCacheVariable(name));
+	}
+
+	writer.WriteUInt(m_Sections.size());
+	for (const auto& section : m_Sections)
+	{
+		writer.WriteString(section);
+	}
+
+	writer.WriteUInt(m_Options.GetCount());
+	m_Options.ForEachValue([&](const std::wstring& section, const std::wstring& key, const std::wstring& value)
+	{
+		writer.WriteString(section);
+		writer.WriteString(key);
+		writer.WriteString(value);
+	});
+
+	writer.WriteUInt(m_ListVariables.size());
+	for (const auto& variable : m_ListVariables)
+	{
+		writer.WriteString(variable);
+		writer.WriteString(m_OriginalVariableNames[variable]);
+	}
+
+	if (!writer.Save(ConfigCache::GetCacheFile(iniFile)))
+	{
+		LogDebugF(m_Skin, L"Unable to write cache for: %s", iniFile.c_str());
+	}
 }
 
 /*
-** Deletes the value for the key under the given section.
+** Returns the value of a built-in or monitor variable prefixed with its kind, or an empty string
+** for user-defined and unknown variables. Values of the latter come from the cached files.
 **
 */
-void ConfigParser::DeleteValue(const std::wstring& strSection, const std::wstring& strKey)
+std::wstring ConfigParser::GetCacheVariable(const std::wstring& name) const
 {
-	std::wstring strTmp;
-	strTmp.reserve(strSection.size() + 1ULL + strKey.size());
-	strTmp = strSection;
-	strTmp += L'~';
-	strTmp += strKey;
+	auto iter = m_BuiltInVariables.find(name);
+	if (iter != m_BuiltInVariables.end())
+	{
+		return L'B' + iter->second;
+	}
 
-	std::unordered_map<std::wstring, std::wstring>::const_iterator iter = m_Values.find(StrToUpperC(strTmp));
-	if (iter != m_Values.end())
+	iter = c_MonitorVariables.find(name);
+	if (iter != c_MonitorVariables.end())
 	{
-		m_Values.erase(iter);
+		return L'M' + iter->second;
 	}
+
+	return std::wstring();
+}
+
+/*
+** Sets the value for the key under the given section.
+**
+*/
+void ConfigParser::SetValue(const std::wstring& strSection, const std::wstring& strKey, const std::wstring& strValue)
+{
+	// LogDebugF(L"[%s] %s=%s (size: %i)", strSection.c_str(), strKey.c_str(), strValue.c_str(), (int)m_Options.GetCount());
+
+	m_Options.SetValue(strSection, strKey, strValue);
+}
+
+/*
+** Deletes the value for the key under the given section.
+**
+*/
+void ConfigParser::DeleteValue(const std::wstring& strSection, const std::wstring& strKey)
+{
+	m_Options.DeleteValue(strSection, strKey);
 }
 
 /*
@@ -2199,12 +2753,6 @@ void ConfigParser::DeleteValue(const std::wstring& strSection, const std::wstrin
 */
 const std::wstring& ConfigParser::GetValue(const std::wstring& strSection, const std::wstring& strKey, const std::wstring& strDefault)
 {
-	std::wstring strTmp;
-	strTmp.reserve(strSection.size() + 1ULL + strKey.size());
-	strTmp = strSection;
-	strTmp += L'~';
-	strTmp += strKey;
-
-	std::unordered_map<std::wstring, std::wstring>::const_iterator iter = m_Values.find(StrToUpperC(strTmp));
-	return (iter != m_Values.end()) ? (*iter).second : strDefault;
+	const std::wstring* value = m_Options.GetValue(m_Options.FindSection(strSection), m_Options.FindKey(strKey));
+	return value ? *value : strDefault;
 }
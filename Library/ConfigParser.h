@@ -11,12 +11,16 @@
 #pragma warning(disable: 4503)
 
 #include <windows.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
 #include <cstdint>
 #include <d2d1.h>
+#include "ConfigCache.h"
+#include "OptionStore.h"
+#include "SectionIndex.h"
 
 class Rainmeter;
 class Skin;
@@ -56,6 +60,24 @@ public:
 
 	void AddMeasure(Measure* pMeasure);
 	Measure* GetMeasure(const std::wstring& name);
+	Measure* GetMeasure(const WCHAR* name, size_t length);
+
+	// While set, measures whose values are substituted into read strings are appended to |references|.
+	void SetMeasureReferences(std::vector<Measure*>* references) { m_MeasureReferences = references; }
+
+	struct OptionReferences
+	{
+		std::vector<std::wstring> variables;	// Uppercase names of the variables looked up
+		bool isVolatile;						// Also depends on measure values, section variables, etc.
+		std::vector<Measure*> measures;			// Measures whose values were read
+	};
+
+	// While set, the references of read strings are recorded in |references|. Returns the previous value.
+	OptionReferences* SetOptionReferences(OptionReferences* references) { std::swap(m_OptionReferences, references); return references; }
+
+	// Sections whose options are marked as changed when one of the |variables| is set.
+	void AddVariableReferences(Section* section, const std::vector<std::wstring>& variables);
+	void RemoveVariableReferences(Section* section, const std::vector<std::wstring>& variables);
 
 	const std::wstring* GetVariable(const std::wstring& strVariable);
 	const std::wstring* GetVariableOriginalName(const std::wstring& strVariable);
@@ -114,7 +136,7 @@ public:
 	static D2D1_RECT_F ParseRect(LPCTSTR str);
 	static RECT ParseRECT(LPCTSTR str);
 
-	static void ClearMultiMonitorVariables() { c_MonitorVariables.clear(); }
+	static void ClearMultiMonitorVariables() { c_MonitorVariables.clear(); ++c_MonitorVariableGeneration; }
 	static void UpdateWorkareaVariables() { SetMultiMonitorVariables(false); }
 	static bool IsVariableKey(const WCHAR ch) { for (auto& k : c_VariableMap) { if (k.second == ch) return true; } return false; }
 
@@ -125,20 +147,101 @@ private:
 
 	void ReadIniFile(const std::wstring& iniFile, LPCTSTR skinSection = nullptr, int depth = 0);
 
+	bool ReadCache(const std::wstring& iniFile);
+	void WriteCache(const std::wstring& iniFile, const std::vector<ConfigCache::File>& files,
+		const std::vector<std::wstring>& variables, const std::unordered_map<std::wstring, std::wstring>& userVariables);
+	std::wstring GetCacheVariable(const std::wstring& name) const;
+
 	void SetAutoSelectedMonitorVariables(Skin* skin);
 
 	bool GetSectionVariable(std::wstring& strVariable, std::wstring& strValue, void* logEntry = nullptr);
 
+	void AddMeasureReference(Measure* measure);
+	void RefreshMeasure(Measure* measure);
+	void SetVariableChanged(const std::wstring& strVariable);
+
+	// An option value with its variables replaced, split into literal text and the measures whose
+	// values are substituted into it. Re-reading the option with DynamicVariables=1 only concatenates
+	// the parts (and only when a measure value has changed) instead of parsing the value again.
+	struct OptionTemplate
+	{
+		struct Part
+		{
+			std::wstring text;		// Literal text before |measure|
+			Measure* measure;		// nullptr for the trailing text
+			std::wstring value;		// Value of |measure| in |result|
+		};
+
+		std::wstring raw;			// Value before any replacements
+		UINT variableGeneration;
+		UINT monitorVariableGeneration;
+		bool dynamic;				// Contains section variables, nested or escaped variables, etc.
+		bool isVolatile;			// Contains monitor variables
+		bool replaced;
+		bool rendered;
+		std::vector<Part> parts;
+		std::wstring result;
+		std::vector<std::wstring> variables;	// Variables used to build the template
+	};
+
+	bool ReplaceWithTemplate(uint64_t id, std::wstring& result);
+	bool BuildOptionTemplate(OptionTemplate& tmpl, const std::wstring& str);
+	bool RenderOptionTemplate(OptionTemplate& tmpl);
+
+	// Maps option values to their parsed values so that re-reading an unchanged value (e.g. with
+	// DynamicVariables=1) does not parse it again. The memo is emptied when it is full.
+	template <typename T>
+	class ParseMemo
+	{
+	public:
+		const T* Find(const std::wstring& str) const
+		{
+			auto iter = m_Values.find(str);
+			return (iter != m_Values.end()) ? &iter->second : nullptr;
+		}
+
+		const T& Insert(const std::wstring& str, const T& value)
+		{
+			if (m_Values.size() >= c_MaxSize) m_Values.clear();
+			return m_Values.emplace(str, value).first->second;
+		}
+
+		void Clear() { m_Values.clear(); }
+
+	private:
+		static const size_t c_MaxSize = 256;
+
+		std::unordered_map<std::wstring, T> m_Values;
+	};
+
+	const WCHAR* CheckedParseFormula(const std::wstring& formula, double* value);
+
+	// Buffers reused by ParseVariables. Each level of recursion (e.g. a script function called to
+	// get a section variable that parses variables again) has its own buffers.
+	struct VariableBuffers
+	{
+		std::vector<WCHAR> input;		// Text to be parsed, in reverse order
+		std::wstring result;
+		std::vector<size_t> starts;		// Positions of the unmatched '[' characters in |result|
+		std::wstring variable;
+		std::wstring value;
+		std::wstring previous;
+	};
+
 	static void SetMultiMonitorVariables(bool reset);
 
 	static std::wstring StrToUpper(const std::wstring& str) { std::wstring strTmp(str); StrToUpperC(strTmp); return strTmp; }
 	static std::wstring StrToUpper(const WCHAR* str) { std::wstring strTmp(str); StrToUpperC(strTmp); return strTmp; }
 	static std::wstring& StrToUpperC(std::wstring& str) { _wcsupr(&str[0]); return str; }
 
-	std::unordered_map<std::wstring, Measure*> m_Measures;
+	SectionIndex<Measure> m_Measures;
+	std::vector<Measure*>* m_MeasureReferences;
+	OptionReferences* m_OptionReferences;
+	std::vector<ConfigCache::File>* m_CacheFiles;	// While set, the files read by ReadIniFile are appended
 
 	std::vector<std::wstring> m_StyleTemplate;
 
+	std::wstring m_Result;	// Returned by ReadString()
 	bool m_LastReplaced;
 	bool m_LastDefaultUsed;
 	bool m_LastValueDefined;
@@ -146,7 +249,7 @@ private:
 	std::wstring* m_CurrentSection;
 
 	std::list<std::wstring> m_Sections;		// Ordered section
-	std::unordered_map<std::wstring, std::wstring> m_Values;
+	OptionStore m_Options;
 
 	std::unordered_set<std::wstring> m_FoundSections;
 	std::list<std::wstring> m_ListVariables;
@@ -155,10 +258,24 @@ private:
 	std::unordered_map<std::wstring, std::wstring> m_BuiltInVariables;
 	std::unordered_map<std::wstring, std::wstring> m_Variables;
 	std::unordered_map<std::wstring, std::wstring> m_OriginalVariableNames;
+	UINT m_VariableGeneration;	// Incremented when a variable is set
+
+	std::unordered_map<uint64_t, OptionTemplate> m_OptionTemplates;	// By section and key id
+
+	ParseMemo<double> m_FormulaMemo;
+	ParseMemo<D2D1_COLOR_F> m_ColorMemo;
+	ParseMemo<D2D1_RECT_F> m_RectMemo;
+	ParseMemo<RECT> m_RECTMemo;
+	ParseMemo<std::vector<FLOAT>> m_FloatsMemo;
+
+	std::vector<std::unique_ptr<VariableBuffers>> m_VariableBuffers;
+	size_t m_VariableDepth;
+	std::unordered_map<std::wstring, std::vector<Section*>> m_VariableSections;
 
 	Skin* m_Skin;
 
 	static std::unordered_map<std::wstring, std::wstring> c_MonitorVariables;
+	static UINT c_MonitorVariableGeneration;
 	static std::unordered_map<VariableType, WCHAR> c_VariableMap;
 };
 
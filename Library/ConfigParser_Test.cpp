@@ -7,6 +7,7 @@
 
 #include "StdAfx.h"
 #include "ConfigParser.h"
+#include "../Common/Timer.h"
 #include "../Common/UnitTest.h"
 #include "../Common/Gfx/Util/D2DUtil.h"
 
@@ -67,6 +68,43 @@ public:
 		Assert::IsTrue(parser.ReadFloats(L"A", L"FloatsNA").empty());
 	}
 
+	TEST_METHOD(TestParseMemo)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");
+
+		// Values read again must be parsed the same way and changed values must be parsed again.
+		const D2D1_COLOR_F transparent = D2D1::ColorF(0, 0.0f);
+		parser.SetValue(L"A", L"Color", L"255,0,0");
+		Assert::IsTrue(Gfx::Util::ColorFEquals(parser.ReadColor(L"A", L"Color", transparent), D2D1::ColorF(1.0f, 0.0f, 0.0f)));
+		Assert::IsTrue(Gfx::Util::ColorFEquals(parser.ReadColor(L"A", L"Color", transparent), D2D1::ColorF(1.0f, 0.0f, 0.0f)));
+		parser.SetValue(L"A", L"Color", L"0,255,0");
+		Assert::IsTrue(Gfx::Util::ColorFEquals(parser.ReadColor(L"A", L"Color", transparent), D2D1::ColorF(0.0f, 1.0f, 0.0f)));
+
+		parser.SetValue(L"A", L"Formula", L"(2 * 3)");
+		Assert::AreEqual(6, parser.ReadInt(L"A", L"Formula", 0));
+		Assert::AreEqual(6.0, parser.ReadFloat(L"A", L"Formula", 0.0));
+		parser.SetValue(L"A", L"Formula", L"(2 * 4)");
+		Assert::AreEqual(8, parser.ReadInt(L"A", L"Formula", 0));
+
+		// Default values are not memoized.
+		Assert::AreEqual(5, parser.ReadInt(L"A", L"FormulaNA", 5));
+		Assert::AreEqual(7, parser.ReadInt(L"A", L"FormulaNA", 7));
+
+		parser.SetValue(L"A", L"Rect", L"(1 + 1),2,3,4");
+		const RECT defRect = {};
+		Assert::AreEqual(2L, parser.ReadRECT(L"A", L"Rect", defRect).left);
+		Assert::AreEqual(4L, parser.ReadRECT(L"A", L"Rect", defRect).bottom);
+		Assert::AreEqual(4.0f, parser.ReadRect(L"A", L"Rect", D2D1::RectF()).bottom - 2.0f);
+
+		// The memo is bounded.
+		for (int i = 0; i < 1000; ++i)
+		{
+			parser.SetValue(L"A", L"Floats", std::to_wstring(i) + L";1");
+			Assert::AreEqual((FLOAT)i, parser.ReadFloats(L"A", L"Floats")[0]);
+		}
+	}
+
 	TEST_METHOD(TestVariables)
 	{
 		ConfigParser parser;
@@ -103,4 +141,192 @@ public:
 		parser.SetValue(L"A", L"String", L"#Var#");
 		Assert::AreNotEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"BuiltIn");
 	}
+
+	TEST_METHOD(TestOptionTemplates)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		parser.SetVariable(L"Var", L"abc");
+		parser.SetValue(L"A", L"String", L"#Var# [#Var] [Text] [#NA]");
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"abc abc [Text] [#NA]");
+		Assert::IsTrue(parser.GetLastReplaced());
+
+		// Re-reading uses the template until a variable or the value changes.
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"abc abc [Text] [#NA]");
+
+		parser.SetVariable(L"Var", L"def");
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"def def [Text] [#NA]");
+
+		parser.SetValue(L"A", L"String", L"[Text]");
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"[Text]");
+		Assert::IsFalse(parser.GetLastReplaced());
+
+		// Nested and escaped variables are parsed every time.
+		parser.SetVariable(L"Name", L"Var");
+		parser.SetValue(L"A", L"String", L"[#[#Name]] [#*Var*]");
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"def [#Var]");
+		Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"def [#Var]");
+	}
+
+	TEST_METHOD(TestOptionReferences)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		parser.SetVariable(L"Var", L"abc");
+		parser.SetValue(L"A", L"String", L"#Var# [#Other]");
+
+		// The variables are also reported when the cached template is used.
+		for (int i = 0; i < 2; ++i)
+		{
+			ConfigParser::OptionReferences references = {};
+			parser.SetOptionReferences(&references);
+			Assert::AreEqual(parser.ReadString(L"A", L"String", L"").c_str(), L"abc [#Other]");
+			parser.SetOptionReferences(nullptr);
+
+			const auto& variables = references.variables;
+			Assert::IsTrue(std::find(variables.cbegin(), variables.cend(), L"VAR") != variables.cend());
+			Assert::IsTrue(std::find(variables.cbegin(), variables.cend(), L"OTHER") != variables.cend());
+			Assert::IsFalse(references.isVolatile);
+		}
+	}
+
+	TEST_METHOD(TestNestedVariables)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		parser.SetVariable(L"Var", L"abc");
+		parser.SetVariable(L"Index", L"1");
+		parser.SetVariable(L"Var1", L"one");
+		parser.SetVariable(L"Name", L"Var");
+		parser.SetVariable(L"Self", L"[#Self]");
+		parser.SetVariable(L"Open", L"[#");
+		parser.SetVariable(L"Close", L"]");
+		parser.SetVariable(L"Escaped", L"[#*Var*]");
+		parser.SetVariable(L"Deep1", L"[#Deep2]");
+		parser.SetVariable(L"Deep2", L"[#Deep3]");
+		parser.SetVariable(L"Deep3", L"end");
+
+		const WCHAR* corpus[][2] =
+		{
+			{ L"", L"" },
+			{ L"abc", L"abc" },
+			{ L"[#Var]", L"abc" },
+			{ L"[#VAR] [#var]", L"abc abc" },
+			{ L"[#NA]", L"[#NA]" },
+			{ L"[#Var[#Index]]", L"one" },
+			{ L"[#[#Name]]", L"abc" },
+			{ L"[#[#Name][#Index]]", L"one" },
+			{ L"[#Var1 [#Index]]", L"[#Var1 1]" },
+			{ L"[#*Var*]", L"[#Var]" },
+			{ L"[#*Var*] [#Var]", L"[#Var] abc" },
+			{ L"[*Var*]", L"[*Var*]" },
+			{ L"[]", L"[]" },
+			{ L"[#]", L"[#]" },
+			{ L"[x]", L"[x]" },
+			{ L"[[#Var]]", L"[abc]" },
+			{ L"[#Var]]", L"abc]" },
+			{ L"[[#Var]", L"[abc" },
+			{ L"[#Self]", L"[#Self]" },
+			{ L"[#Open]Var]", L"abc" },
+			{ L"[#Var[#Close]", L"abc" },
+			{ L"[#Escaped]", L"[#Var]" },
+			{ L"[#Deep1]", L"end" },
+			{ L"[\\65][\\x42][\\x][\\0][\\abc]", L"AB[\\x][\\0][\\abc]" },
+			{ L"[Measure] [#Var] [&Measure:X]", L"[Measure] abc [&Measure:X]" },
+			{ L"[#Var] [NotAVar] [#Var]", L"abc [NotAVar] abc" },
+			{ L"text [#Var] text [#VAR1] [", L"text abc text one [" }
+		};
+
+		for (const auto& item : corpus)
+		{
+			std::wstring str = item[0];
+			parser.ParseVariables(str, ConfigParser::VariableType::Section);
+			Assert::AreEqual(item[1], str.c_str());
+		}
+
+		// Mouse variables are parsed before the other variables so escaped variables are kept.
+		std::wstring str = L"[#*Var*] [#Var]";
+		Assert::IsFalse(parser.ParseVariables(str, ConfigParser::VariableType::Mouse));
+		Assert::AreEqual(L"[#*Var*] [#Var]", str.c_str());
+
+		// Only regular variables are parsed when parsing variables (e.g. for @Include).
+		str = L"[#Var] [\\65] [&Measure]";
+		Assert::IsTrue(parser.ParseVariables(str, ConfigParser::VariableType::Variable));
+		Assert::AreEqual(L"abc A [&Measure]", str.c_str());
+	}
+
+	TEST_METHOD(TestReadBenchmark)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		const WCHAR* keys[] = { L"Meter", L"MeasureName", L"X", L"Y", L"W", L"H", L"FontColor", L"Text" };
+		const WCHAR* values[] = { L"String", L"MeasureCPU", L"0r", L"20R", L"200", L"20", L"255,255,255,200", L"CPU: %1" };
+
+		std::vector<std::wstring> sections;
+		for (int i = 0; i < 2000; ++i)
+		{
+			sections.push_back(L"Meter" + std::to_wstring(i));
+			for (int j = 0; j < _countof(keys); ++j)
+			{
+				parser.SetValue(sections.back(), keys[j], values[j]);
+			}
+		}
+
+		const int iterations = 10;
+
+		Timer timer;
+		timer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			for (const auto& section : sections)
+			{
+				for (int j = 0; j < _countof(keys); ++j)
+				{
+					Assert::AreEqual(values[j], parser.ReadString(section.c_str(), keys[j], L"").c_str());
+				}
+			}
+		}
+		timer.Stop();
+
+		WCHAR buffer[128];
+		_snwprintf_s(buffer, _TRUNCATE, L"ReadString (2000 sections, 8 options): %.2f ms\n", timer.GetElapsed() / iterations);
+		Logger::WriteMessage(buffer);
+	}
+
+	TEST_METHOD(TestParseVariablesBenchmark)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		std::wstring str;
+		for (int i = 0; i < 100; ++i)
+		{
+			const std::wstring index = std::to_wstring(i);
+			parser.SetVariable(L"Var" + index, L"value" + index);
+			parser.SetVariable(L"Index" + index, index);
+			str += L"text [#Var[#Index" + index + L"]] [NotAVar] ";
+		}
+
+		const int iterations = 100;
+
+		std::wstring result;
+		Timer timer;
+		timer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			result = str;
+			parser.ParseVariables(result, ConfigParser::VariableType::Section);
+		}
+		timer.Stop();
+
+		Assert::AreEqual(0, result.compare(0, 25, L"text value0 [NotAVar] tex"));
+
+		WCHAR buffer[128];
+		_snwprintf_s(buffer, _TRUNCATE, L"ParseVariables (100 nested variables): %.3f ms\n", timer.GetElapsed() / iterations);
+		Logger::WriteMessage(buffer);
+	}
 };
@@ -148,6 +148,23 @@ void __stdcall RmExecute(void* skin, LPCWSTR command)
 	}
 }
 
+void __stdcall RmExecuteAsync(void* skin, LPCWSTR command)
+{
+	if (command)
+	{
+		// Queued without waiting for the main thread
+		GetRainmeter().DelayedExecuteCommand(command, (Skin*)skin);
+	}
+}
+
+void __stdcall RmExecuteDelayed(void* skin, LPCWSTR command, UINT delay)
+{
+	if (command)
+	{
+		GetRainmeter().DelayedExecuteCommand(command, (Skin*)skin, delay);
+	}
+}
+
 BOOL LSLog(int level, LPCWSTR unused, LPCWSTR message)
 {
 	NULLCHECK(message);
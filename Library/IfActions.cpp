@@ -10,8 +10,7 @@
 #include "IfActions.h"
 #include "Rainmeter.h"
 #include "../Common/MathParser.h"
-#include "pcre/config.h"
-#include "pcre/pcre.h"
+#include "../Common/RegExpCache.h"
 
 IfActions::IfActions() :
 	m_AboveValue(0.0),
@@ -46,8 +45,11 @@ void IfActions::ReadOptions(ConfigParser& parser, const WCHAR* section)
 	m_EqualValue = (int64_t)parser.ReadFloat(section, L"IfEqualValue", 0.0);
 }
 
-void IfActions::ReadConditionOptions(ConfigParser& parser, const WCHAR* section)
+bool IfActions::ReadConditionOptions(ConfigParser& parser, const WCHAR* section)
 {
+	const size_t oldConditionCount = m_Conditions.size();
+	bool conditionsChanged = false;
+
 	// IfCondition options
 	m_ConditionMode = parser.ReadBool(section, L"IfConditionMode", false);
 
@@ -63,7 +65,10 @@ void IfActions::ReadConditionOptions(ConfigParser& parser, const WCHAR* section)
 			{
 				if (m_Conditions.size() > (i - 1))
 				{
-					m_Conditions[i - 1].Set(condition, tAction, fAction);
+					if (m_Conditions[i - 1].Set(condition, tAction, fAction))
+					{
+						conditionsChanged = true;
+					}
 				}
 				else
 				{
@@ -94,6 +99,11 @@ void IfActions::ReadConditionOptions(ConfigParser& parser, const WCHAR* section)
 		m_Conditions.clear();
 	}
 
+	if (m_Conditions.size() != oldConditionCount)
+	{
+		conditionsChanged = true;
+	}
+
 	// IfMatch options
 	m_MatchMode = parser.ReadBool(section, L"IfMatchMode", false);
 
@@ -138,6 +148,23 @@ void IfActions::ReadConditionOptions(ConfigParser& parser, const WCHAR* section)
 	{
 		m_Matches.clear();
 	}
+
+	return conditionsChanged;
+}
+
+/*
+** Appends the measures referenced in the IfCondition formulas to |dependencies|.
+**
+*/
+void IfActions::GetDependencies(Skin* skin, std::vector<Measure*>& dependencies)
+{
+	for (const auto& item : m_Conditions)
+	{
+		if (!item.value.empty())
+		{
+			Measure::FindMeasureReferences(skin, item.value.c_str(), dependencies);
+		}
+	}
 }
 
 void IfActions::DoIfActions(Measure& measure, double value)
@@ -200,9 +227,36 @@ void IfActions::DoIfActions(Measure& measure, double value)
 		++i;
 		if (!item.value.empty() && (!item.tAction.empty() || !item.fAction.empty()))
 		{
-			double result = 0.0;
-			const WCHAR* errMsg = MathParser::Parse(
-				item.value.c_str(), &result, measure.GetCurrentMeasureValue, &measure);
+			const WCHAR* errMsg = nullptr;
+			if (!item.compiled)
+			{
+				item.compiled = true;
+				item.evaluated = false;
+				item.slots.clear();
+
+				std::pair<Measure*, IfState*> context(&measure, &item);
+				errMsg = MathParser::Compile(item.value.c_str(), item.program, ResolveName, &context);
+				item.generations.assign(item.slots.size(), 0U);
+			}
+
+			// Evaluate the condition again only if a referenced measure has changed.
+			bool changed = !item.evaluated;
+			for (size_t j = 0, jsize = item.slots.size(); j < jsize; ++j)
+			{
+				const UINT generation = item.slots[j]->GetValueGeneration();
+				if (generation != item.generations[j])
+				{
+					item.generations[j] = generation;
+					changed = true;
+				}
+			}
+
+			if (changed && errMsg == nullptr && !item.program.code.empty())
+			{
+				errMsg = MathParser::Evaluate(item.program, &item.result, GetSlotValue, &item);
+				item.evaluated = errMsg == nullptr;
+			}
+
 			if (errMsg != nullptr)
 			{
 				if (!item.parseError)
@@ -218,11 +272,11 @@ void IfActions::DoIfActions(Measure& measure, double value)
 					item.parseError = true;
 				}
 			}
-			else
+			else if (item.evaluated)
 			{
 				item.parseError = false;
 
-				if (result == 1.0)			// "True"
+				if (item.result == 1.0)			// "True"
 				{
 					item.fCommitted = false;
 
@@ -232,7 +286,7 @@ void IfActions::DoIfActions(Measure& measure, double value)
 						GetRainmeter().ExecuteActionCommand(item.tAction.c_str(), &measure);
 					}
 				}
-				else if (result == 0.0)	// "False"
+				else if (item.result == 0.0)	// "False"
 				{
 					item.tCommitted = false;
 
@@ -253,27 +307,18 @@ void IfActions::DoIfActions(Measure& measure, double value)
 		++i;
 		if (!item.value.empty() && (!item.tAction.empty() || !item.fAction.empty()))
 		{
-			const char* error;
-			int errorOffset;
-
-			pcre16* re = pcre16_compile(
-				(PCRE_SPTR16)item.value.c_str(),
-				PCRE_UTF16,
-				&error,
-				&errorOffset,
-				nullptr);
-
-			if (!re)
+			RegExpHandle re = GetRegExpCache().Get(item.value);
+			if (!re->IsValid())
 			{
 				if (!item.parseError)
 				{
 					if (i == 1)
 					{
-						LogErrorF(&measure, L"Error: \"%S\" in IfMatch=%s", error, item.value.c_str());
+						LogErrorF(&measure, L"Error: \"%S\" in IfMatch=%s", re->GetError(), item.value.c_str());
 					}
 					else
 					{
-						LogErrorF(&measure, L"Error: \"%S\" in IfMatch%i=%s", error, i, item.value.c_str());
+						LogErrorF(&measure, L"Error: \"%S\" in IfMatch%i=%s", re->GetError(), i, item.value.c_str());
 					}
 
 					item.parseError = true;
@@ -286,10 +331,8 @@ void IfActions::DoIfActions(Measure& measure, double value)
 				const WCHAR* str = measure.GetStringValue();
 				int strLen = str ? (int)wcslen(str) : 0;
 				int ovector[300];
-				int rc = pcre16_exec(
-					re,
-					nullptr,
-					(PCRE_SPTR16)str,
+				int rc = re->Exec(
+					str,
 					(int)strLen,
 					0,
 					0,
@@ -317,13 +360,33 @@ void IfActions::DoIfActions(Measure& measure, double value)
 					}
 				}
 			}
-
-			// Release memory used for the compiled pattern
-			pcre16_free(re);
 		}
 	}
 }
 
+/*
+** Maps a measure name in an IfCondition formula to a slot in |IfState::slots|.
+**
+*/
+bool IfActions::ResolveName(const WCHAR* str, int len, int* slot, void* context)
+{
+	auto ctx = (std::pair<Measure*, IfState*>*)context;
+	Measure* measure = ctx->first->GetSkin()->GetParser().GetMeasure(str, (size_t)len);
+	if (measure)
+	{
+		*slot = (int)ctx->second->slots.size();
+		ctx->second->slots.push_back(measure);
+		return true;
+	}
+
+	return false;
+}
+
+double IfActions::GetSlotValue(int slot, void* context)
+{
+	return ((IfState*)context)->slots[slot]->GetValue();
+}
+
 void IfActions::SetState(double& value)
 {
 	// Set IfAction committed state to false if condition is not met with value = 0
@@ -11,6 +11,7 @@
 #include <windows.h>
 #include <string>
 #include <vector>
+#include "../Common/MathParser.h"
 
 class ConfigParser;
 class Measure;
@@ -26,16 +27,27 @@ public:
 		fAction(),
 		parseError(false),
 		tCommitted(false),
-		fCommitted(false)
+		fCommitted(false),
+		result(0.0),
+		compiled(false),
+		evaluated(false)
 	{
 		Set(value, trueAction, falseAction);
 	}
 
-	inline void Set(std::wstring value, std::wstring trueAction, std::wstring falseAction)
+	// Returns true if the condition changed.
+	inline bool Set(std::wstring value, std::wstring trueAction, std::wstring falseAction)
 	{
+		const bool changed = value != this->value;
+		if (changed)
+		{
+			compiled = false;
+		}
+
 		this->value = value;
 		this->tAction = trueAction;
 		this->fAction = falseAction;
+		return changed;
 	}
 
 	std::wstring value;			// IfCondition/IfMatch
@@ -44,6 +56,15 @@ public:
 	bool parseError;
 	bool tCommitted;
 	bool fCommitted;
+
+	// Only used by IfCondition. The formula is compiled once and evaluated again only when one of
+	// the referenced measures has changed.
+	MathParser::Program program;
+	std::vector<Measure*> slots;		// Measures referenced by |program|
+	std::vector<UINT> generations;		// Generations of |slots| when |result| was evaluated
+	double result;
+	bool compiled;
+	bool evaluated;
 };
 
 class IfActions
@@ -56,11 +77,27 @@ public:
 	IfActions& operator=(IfActions other) = delete;
 
 	void ReadOptions(ConfigParser& parser, const WCHAR* section);
-	void ReadConditionOptions(ConfigParser& parser, const WCHAR* section);
+
+	// Returns true if the IfCondition formulas changed.
+	bool ReadConditionOptions(ConfigParser& parser, const WCHAR* section);
 	void DoIfActions(Measure& measure, double value);
 	void SetState(double& value);
 
+	void GetDependencies(Skin* skin, std::vector<Measure*>& dependencies);
+
+	// Returns true if actions are executed on every update rather than only on changes.
+	bool IsRepeating() const { return m_ConditionMode || m_MatchMode; }
+
+	bool HasActions() const
+	{
+		return !m_AboveAction.empty() || !m_BelowAction.empty() || !m_EqualAction.empty() ||
+			!m_Conditions.empty() || !m_Matches.empty();
+	}
+
 private:
+	static bool ResolveName(const WCHAR* str, int len, int* slot, void* context);
+	static double GetSlotValue(int slot, void* context);
+
 	double m_AboveValue;
 	double m_BelowValue;
 	int64_t m_EqualValue;
@@ -0,0 +1,73 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "IniFileCache.h"
+
+IniFileCachePool::IniFileCachePool()
+{
+}
+
+IniFileCachePool::~IniFileCachePool()
+{
+}
+
+IniFileCachePool& IniFileCachePool::GetInstance()
+{
+	static IniFileCachePool s_CachePool;
+	return s_CachePool;
+}
+
+IniFileSections IniFileCachePool::Get(const ConfigCache::File& file)
+{
+	std::wstring key = file.path;
+	_wcsupr(&key[0]);
+
+	auto iter = m_Index.find(key);
+	if (iter != m_Index.end())
+	{
+		const Entry& entry = *iter->second;
+		if (file.size != ConfigCache::c_MissingFile &&
+			entry.size == file.size && entry.lastWrite == file.lastWrite)
+		{
+			// Move to the front of the list.
+			m_Entries.splice(m_Entries.begin(), m_Entries, iter->second);
+			return entry.sections;
+		}
+
+		m_Entries.erase(iter->second);
+		m_Index.erase(iter);
+	}
+
+	if (file.size == ConfigCache::c_MissingFile)
+	{
+		return nullptr;
+	}
+
+	auto sections = std::make_shared<std::vector<IniFile::Section>>();
+	if (!IniFile::Read(file.path, *sections))
+	{
+		return nullptr;
+	}
+
+	if (m_Entries.size() >= c_MaxCount)
+	{
+		m_Index.erase(m_Entries.back().key);
+		m_Entries.pop_back();
+	}
+
+	Entry entry = { key, file.size, file.lastWrite, sections };
+	m_Entries.push_front(std::move(entry));
+	m_Index.emplace(std::move(key), m_Entries.begin());
+	return sections;
+}
+
+void IniFileCachePool::Clear()
+{
+	m_Index.clear();
+	m_Entries.clear();
+}
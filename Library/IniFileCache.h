@@ -0,0 +1,61 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __INIFILECACHE_H__
+#define __INIFILECACHE_H__
+
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Common/IniFile.h"
+#include "ConfigCache.h"
+
+typedef std::shared_ptr<const std::vector<IniFile::Section>> IniFileSections;
+
+// Parsed @Include files shared by all skins so that a file included by many skins is read once
+// when they are loaded or refreshed together. Entries are replaced when the file changes. When the
+// pool is full, the least recently used file is removed from it.
+class IniFileCachePool
+{
+public:
+	static IniFileCachePool& GetInstance();
+
+	// Returns the sections of |file|, which must have been returned by ConfigCache::GetFile() just
+	// before. Returns nullptr if the file could not be read.
+	IniFileSections Get(const ConfigCache::File& file);
+
+	void Clear();
+	size_t GetCount() const { return m_Entries.size(); }
+
+	static const size_t c_MaxCount = 256;
+
+private:
+	IniFileCachePool();
+	~IniFileCachePool();
+	IniFileCachePool(const IniFileCachePool& other) = delete;
+	IniFileCachePool& operator=(IniFileCachePool other) = delete;
+
+	struct Entry
+	{
+		std::wstring key;
+		uint64_t size;
+		uint64_t lastWrite;
+		IniFileSections sections;
+	};
+
+	typedef std::list<Entry> EntryList;
+
+	EntryList m_Entries;	// Most recently used first
+	std::unordered_map<std::wstring, EntryList::iterator> m_Index;	// By uppercase path
+};
+
+// Convenience function.
+inline IniFileCachePool& GetIniFileCache() { return IniFileCachePool::GetInstance(); }
+
+#endif
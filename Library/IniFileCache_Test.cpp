@@ -0,0 +1,124 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "IniFileCache.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_IniFileCache_Test)
+{
+public:
+	TEST_METHOD_INITIALIZE(Initialize)
+	{
+		GetIniFileCache().Clear();
+	}
+
+	TEST_METHOD_CLEANUP(Cleanup)
+	{
+		for (const auto& path : m_Files)
+		{
+			DeleteFile(path.c_str());
+		}
+		m_Files.clear();
+		GetIniFileCache().Clear();
+	}
+
+	std::wstring CreateTempFile()
+	{
+		WCHAR dir[MAX_PATH];
+		WCHAR path[MAX_PATH];
+		GetTempPath(_countof(dir), dir);
+		Assert::AreNotEqual(0U, GetTempFileName(dir, L"ini", 0, path));
+		m_Files.push_back(path);
+		return path;
+	}
+
+	static void WriteTempFile(const std::wstring& path, const char* contents)
+	{
+		HANDLE file = CreateFile(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		Assert::IsTrue(file != INVALID_HANDLE_VALUE);
+
+		DWORD written = 0UL;
+		WriteFile(file, contents, (DWORD)strlen(contents), &written, nullptr);
+		CloseHandle(file);
+	}
+
+	TEST_METHOD(TestInvalidation)
+	{
+		const std::wstring path = CreateTempFile();
+		WriteTempFile(path, "[A]\r\nKey=1\r\n");
+
+		const ConfigCache::File file = ConfigCache::GetFile(path);
+		IniFileSections sections = GetIniFileCache().Get(file);
+		Assert::IsTrue(sections != nullptr);
+		Assert::AreEqual(L"A", (*sections)[0].name.c_str());
+
+		// Unchanged files are not read again.
+		Assert::IsTrue(GetIniFileCache().Get(file) == sections);
+		Assert::AreEqual((size_t)1, GetIniFileCache().GetCount());
+
+		// A different size replaces the entry.
+		WriteTempFile(path, "[B]\r\nKey=22\r\n");
+		const ConfigCache::File resized = ConfigCache::GetFile(path);
+		Assert::IsTrue(resized.size != file.size);
+		IniFileSections resizedSections = GetIniFileCache().Get(resized);
+		Assert::IsTrue(resizedSections != sections);
+		Assert::AreEqual(L"B", (*resizedSections)[0].name.c_str());
+		Assert::AreEqual((size_t)1, GetIniFileCache().GetCount());
+
+		// So does a different modification time with the same size.
+		WriteTempFile(path, "[C]\r\nKey=33\r\n");
+		ULARGE_INTEGER time;
+		time.QuadPart = resized.lastWrite + 10000000ULL;  // 1 second later
+		FILETIME lastWrite = { time.LowPart, time.HighPart };
+		HANDLE handle = CreateFile(path.c_str(), FILE_WRITE_ATTRIBUTES, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		Assert::IsTrue(handle != INVALID_HANDLE_VALUE);
+		SetFileTime(handle, nullptr, nullptr, &lastWrite);
+		CloseHandle(handle);
+
+		const ConfigCache::File touched = ConfigCache::GetFile(path);
+		Assert::IsTrue(touched.size == resized.size);
+		Assert::IsTrue(touched.lastWrite != resized.lastWrite);
+		IniFileSections touchedSections = GetIniFileCache().Get(touched);
+		Assert::IsTrue(touchedSections != resizedSections);
+		Assert::AreEqual(L"C", (*touchedSections)[0].name.c_str());
+
+		// Missing files are removed.
+		DeleteFile(path.c_str());
+		const ConfigCache::File missing = ConfigCache::GetFile(path);
+		Assert::IsTrue(missing.size == ConfigCache::c_MissingFile);
+		Assert::IsTrue(GetIniFileCache().Get(missing) == nullptr);
+		Assert::AreEqual((size_t)0, GetIniFileCache().GetCount());
+	}
+
+	TEST_METHOD(TestEviction)
+	{
+		std::vector<ConfigCache::File> files;
+		std::vector<IniFileSections> sections;
+		for (size_t i = 0; i <= IniFileCachePool::c_MaxCount; ++i)
+		{
+			const std::wstring path = CreateTempFile();
+			WriteTempFile(path, "[Section]\r\n");
+			files.push_back(ConfigCache::GetFile(path));
+
+			// Keep the first file in use so that the second one is the least recently used.
+			GetIniFileCache().Get(files[0]);
+			sections.push_back(GetIniFileCache().Get(files.back()));
+		}
+
+		const size_t maxCount = IniFileCachePool::c_MaxCount;
+		Assert::AreEqual(maxCount, GetIniFileCache().GetCount());
+		Assert::IsTrue(GetIniFileCache().Get(files[0]) == sections[0]);
+		Assert::IsTrue(GetIniFileCache().Get(files.back()) == sections.back());
+
+		// The least recently used file is read again.
+		Assert::IsTrue(GetIniFileCache().Get(files[1]) != sections[1]);
+	}
+
+private:
+	std::vector<std::wstring> m_Files;
+};
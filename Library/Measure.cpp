@@ -32,8 +32,8 @@
 #include "MeasureWifiStatus.h"
 #include "Rainmeter.h"
 #include "Util.h"
-#include "pcre/config.h"
-#include "pcre/pcre.h"
+#include "../Common/MathParser.h"
+#include "../Common/RegExpCache.h"
 
 #define OVECCOUNT 300	// Should be a multiple of 3
 
@@ -60,6 +60,37 @@ static const double g_TblScale[2][4] = {
 
 const int MEDIAN_SIZE = 3;
 
+// Number of formatted values cached per measure.
+const size_t MAX_FORMATTED_VALUES = 4;
+
+/*
+** Formats |value| with |decimals| decimals like "%.*f". The format strings for the common numbers
+** of decimals are not built on each call. Returns the length of the result.
+**
+*/
+static int FormatFixed(double value, int decimals, WCHAR* buffer, size_t sizeInWords)
+{
+	static const WCHAR* const c_Formats[] =
+	{
+		L"%.0f", L"%.1f", L"%.2f", L"%.3f", L"%.4f", L"%.5f", L"%.6f", L"%.7f", L"%.8f", L"%.9f"
+	};
+
+	if (decimals >= 0 && decimals < (int)_countof(c_Formats))
+	{
+		return _snwprintf_s(buffer, sizeInWords, _TRUNCATE, c_Formats[decimals], value);
+	}
+
+	WCHAR format[32];
+	_snwprintf_s(format, _TRUNCATE, L"%%.%if", decimals);
+	return _snwprintf_s(buffer, sizeInWords, _TRUNCATE, format, value);
+}
+
+// Returns true if formatting |a| and |b| produces the same result.
+static bool IsSameValue(double a, double b)
+{
+	return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
 Measure::Measure(Skin* skin, const WCHAR* name) : Section(skin, name),
 	m_Value(0.0),
 	m_Invert(false),
@@ -69,14 +100,22 @@ Measure::Measure(Skin* skin, const WCHAR* name) : Section(skin, name),
 	m_MinValueDefined(false),
 	m_MaxValueDefined(false),
 	m_RegExpSubstitute(false),
-	m_MedianPos(),
-	m_AveragePos(),
+	m_NextFormattedValue(),
 	m_AverageSize(),
 	m_Disabled(false),
 	m_Paused(false),
 	m_Initialized(false),
+	m_Observed(true),
+	m_Stale(false),
+	m_UpdatePending(false),
 	m_OldValue(),
-	m_ValueAssigned(false)
+	m_ValueAssigned(false),
+	m_ValueGeneration(),
+	m_GenerationStale(false),
+	m_GenerationValue(0.0),
+	m_GenerationMinValue(0.0),
+	m_GenerationMaxValue(1.0),
+	m_GenerationHasString(false)
 {
 }
 
@@ -133,6 +172,15 @@ void Measure::ReadOptions(ConfigParser& parser, const WCHAR* section)
 		m_Substitute.clear();
 	}
 
+	// The substitutes may change.
+	m_FormattedValues.clear();
+	m_NextFormattedValue = 0;
+
+	// Options may have changed the value even if the dependencies have not. The generation only
+	// changes if the value (e.g. its substitutes) actually has.
+	m_DependencyGenerations.clear();
+	m_GenerationStale = true;
+
 	m_Invert = parser.ReadBool(section, L"InvertMeasure", false);
 
 	m_Disabled = parser.ReadBool(section, L"Disabled", false);
@@ -174,6 +222,15 @@ void Measure::ReadOptions(ConfigParser& parser, const WCHAR* section)
 		}
 	}
 
+	if (!m_RegExpSubstitute)
+	{
+		m_PlainSubstitute.Compile(m_Substitute);
+	}
+	else
+	{
+		m_PlainSubstitute.Clear();
+	}
+
 	if (m_Initialized &&
 		oldOnChangeActionEmpty && !m_OnChangeAction.empty())
 	{
@@ -184,6 +241,8 @@ void Measure::ReadOptions(ConfigParser& parser, const WCHAR* section)
 void Measure::Disable()
 {
 	m_Disabled = true;
+	m_UpdatePending = false;
+	m_DependencyGenerations.clear();
 
 	// Change the option as well to avoid reset in ReadOptions().
 	m_Skin->GetParser().SetValue(m_Name, L"Disabled", L"1");
@@ -192,6 +251,7 @@ void Measure::Disable()
 void Measure::Enable()
 {
 	m_Disabled = false;
+	m_DependencyGenerations.clear();
 
 	// Change the option as well to avoid reset in ReadOptions().
 	m_Skin->GetParser().SetValue(m_Name, L"Disabled", L"0");
@@ -200,6 +260,7 @@ void Measure::Enable()
 void Measure::Pause()
 {
 	m_Paused = true;
+	m_UpdatePending = false;
 
 	// Change the option as well to avoid reset in ReadOptions().
 	m_Skin->GetParser().SetValue(m_Name, L"Paused", L"1");
@@ -249,47 +310,27 @@ const WCHAR* Measure::CheckSubstitute(const WCHAR* buffer)
 	str = buffer;
 	if (!m_RegExpSubstitute)
 	{
-		for (size_t i = 0, isize = m_Substitute.size(); i < isize; i += 2)
-		{
-			if (!m_Substitute[i].empty())
-			{
-				MakePlainSubstitute(str, i);
-			}
-			else if (str.empty())
-			{
-				// Empty result and empty substitute -> use second
-				str = m_Substitute[i + 1];
-			}
-		}
+		m_PlainSubstitute.Apply(str);
 	}
 	else
 	{
 		int ovector[300];
 		for (size_t i = 0, isize = m_Substitute.size(); i < isize; i += 2)
 		{
-			const char* error;
-			int errorOffset;
 			int offset = 0;
-			pcre16* re = pcre16_compile(
-				(PCRE_SPTR16)m_Substitute[i].c_str(),
-				PCRE_UTF16,
-				&error,
-				&errorOffset,
-				nullptr);  // Use default character tables.
-			if (!re)
+			RegExpHandle re = GetRegExpCache().Get(m_Substitute[i]);
+			if (!re->IsValid())
 			{
 				MakePlainSubstitute(str, i);
-				LogNoticeF(this, L"Substitute: %S", error);
+				LogNoticeF(this, L"Substitute: %S", re->GetError());
 			}
 			else
 			{
 				do
 				{
 					const int options = str.empty() ? 0 : PCRE_NOTEMPTY;
-					const int rc = pcre16_exec(
-						re,
-						nullptr,
-						(PCRE_SPTR16)str.c_str(),
+					const int rc = re->Exec(
+						str.c_str(),
 						(int)str.length(),
 						offset,
 						options,               // Empty string is not a valid match
@@ -334,8 +375,6 @@ const WCHAR* Measure::CheckSubstitute(const WCHAR* buffer)
 					offset = start + (int)result.length();
 				}
 				while (true);
-
-				pcre16_free(re);
 			}
 		}
 	}
@@ -446,6 +485,24 @@ std::wstring Measure::ExtractWord(std::wstring& buffer)
 
 bool Measure::Update(bool rereadOptions)
 {
+	if (!BeginUpdate(rereadOptions)) return false;
+
+	// Call derived method to update value
+	UpdateValue();
+
+	EndUpdate(rereadOptions);
+	return true;
+}
+
+/*
+** Reads the options if needed and returns true if the value should be updated. Disabled measures
+** are reset here.
+**
+*/
+bool Measure::BeginUpdate(bool rereadOptions)
+{
+	m_UpdatePending = false;
+
 	if (rereadOptions)
 	{
 		ReadOptions(m_Skin->GetParser());
@@ -457,80 +514,246 @@ bool Measure::Update(bool rereadOptions)
 	if (!m_Disabled)
 	{
 		// Only update the counter if the divider
-		if (!UpdateCounter()) return false;
+		m_UpdatePending = UpdateCounter();
+		return m_UpdatePending;
+	}
+	else
+	{
+		// Disabled measures have 0 as value
+		m_Value = 0.0;
 
-		// Call derived method to update value
-		UpdateValue();
+		m_IfActions.SetState(m_Value);
 
-		if (m_AverageSize > 0)
+		if (m_UpdateHistory)
 		{
-			size_t averageValuesSize = m_AverageValues.size();
+			m_UpdateHistory->Add(GetValue());
+		}
 
-			if (m_AverageSize != averageValuesSize)
-			{
-				m_AverageValues.resize(m_AverageSize, m_Value);
-				averageValuesSize = m_AverageValues.size();
-				if (m_AveragePos >= averageValuesSize) m_AveragePos = 0;
-			}
-			m_AverageValues[m_AveragePos] = m_Value;
+		m_GenerationStale = true;
 
-			++m_AveragePos;
-			m_AveragePos %= averageValuesSize;
+		return false;
+	}
+}
 
-			// Calculate the average value
-			double value = 0;
-			for (size_t i = 0; i < averageValuesSize; ++i)
-			{
-				value += m_AverageValues[i];
-			}
-			m_Value = value / (double)averageValuesSize;
+/*
+** Processes the value after UpdateValue() and executes the IfActions.
+**
+*/
+void Measure::EndUpdate(bool rereadOptions)
+{
+	m_UpdatePending = false;
+
+	if (m_AverageSize > 0)
+	{
+		if (m_AverageSize != m_Average.GetSize())
+		{
+			m_Average.Resize(m_AverageSize, m_Value);
 		}
 
-		// If we're logging the maximum value of the measure, check if
-		// the new value is greater than the old one, and update if necessary.
-		if (m_LogMaxValue)
+		m_Value = m_Average.Add(m_Value);
+	}
+
+	// If we're logging the maximum value of the measure, check if
+	// the new value is greater than the old one, and update if necessary.
+	if (m_LogMaxValue)
+	{
+		if (m_Median.GetSize() == 0)
 		{
-			if (m_MedianValues.empty())
-			{
-				m_MedianValues.resize(MEDIAN_SIZE, 0);
-			}
+			m_Median.Reset(MEDIAN_SIZE, 0.0);
+		}
+
+		const double medianValue = m_Median.Add(m_Value);
+		m_MaxValue = max(m_MaxValue, medianValue);
+		m_MinValue = min(m_MinValue, medianValue);
+	}
+
+	m_ValueAssigned = true;
+	m_GenerationStale = true;
+
+	// For the conditional options to work with the current measure value when using
+	// [MeasureName], we need to read the options after m_Value has been changed.
+	if (rereadOptions)
+	{
+		ReadConditionOptions(m_Skin->GetParser());
+	}
 
-			m_MedianValues[m_MedianPos] = m_Value;
-			++m_MedianPos;
-			m_MedianPos %= MEDIAN_SIZE;
+	if (m_Skin)
+	{
+		m_IfActions.DoIfActions(*this, m_Value);
+	}
+
+	if (m_UpdateHistory)
+	{
+		m_UpdateHistory->Add(GetValue());
+	}
+
+	m_DependencyGenerations.resize(m_Dependencies.size());
+	for (size_t i = 0, isize = m_Dependencies.size(); i < isize; ++i)
+	{
+		m_DependencyGenerations[i] = m_Dependencies[i]->GetValueGeneration();
+	}
+}
+
+/*
+** Returns the value generation. The values are only compared when the generation is requested
+** so that measures whose generation is not used do not need to build their string values. Unless
+** the value is volatile, the string is requested at most once after each update, which matters for
+** plugins that do work in GetString.
+**
+*/
+UINT Measure::GetValueGeneration()
+{
+	if (m_GenerationStale || HasVolatileValue())
+	{
+		m_GenerationStale = false;
 
-			std::vector<double> medianArray = m_MedianValues;
-			std::sort(&medianArray.data()[0], &medianArray.data()[MEDIAN_SIZE]);  // Workaround for "Debug" build mode
+		const double value = GetValue();
+		const WCHAR* stringValue = GetStringValue();
+		if (value != m_GenerationValue || m_MinValue != m_GenerationMinValue || m_MaxValue != m_GenerationMaxValue ||
+			(stringValue != nullptr) != m_GenerationHasString ||
+			(stringValue && wcscmp(stringValue, m_GenerationString.c_str()) != 0))
+		{
+			m_GenerationValue = value;
+			m_GenerationMinValue = m_MinValue;
+			m_GenerationMaxValue = m_MaxValue;
+			m_GenerationHasString = stringValue != nullptr;
+			m_GenerationString = stringValue ? stringValue : L"";
+			++m_ValueGeneration;
+		}
+	}
+
+	return m_ValueGeneration;
+}
+
+/*
+** Returns true if updating a derived measure would not change its value because none of its
+** dependencies have changed since the last update. The measure must not have any side effects
+** that depend on being updated (e.g. OnUpdateAction).
+**
+*/
+bool Measure::IsUpToDate()
+{
+	if (!m_ValueAssigned || m_Disabled || m_Paused || !IsDerived() ||
+		m_UpdateDivider != 1 || HasDynamicVariables() || !m_OnUpdateAction.empty() ||
+		m_AverageSize > 1 || m_LogMaxValue || m_IfActions.IsRepeating() ||
+		m_DependencyGenerations.size() != m_Dependencies.size())
+	{
+		return false;
+	}
 
-			double medianValue = medianArray[MEDIAN_SIZE / 2];
-			m_MaxValue = max(m_MaxValue, medianValue);
-			m_MinValue = min(m_MinValue, medianValue);
+	for (size_t i = 0, isize = m_Dependencies.size(); i < isize; ++i)
+	{
+		if (m_DependencyGenerations[i] != m_Dependencies[i]->GetValueGeneration())
+		{
+			return false;
 		}
+	}
 
-		m_ValueAssigned = true;
+	return true;
+}
 
-		// For the conditional options to work with the current measure value when using
-		// [MeasureName], we need to read the options after m_Value has been changed.
-		if (rereadOptions)
+bool Measure::HasSideEffects()
+{
+	return !m_OnUpdateAction.empty() || !m_OnChangeAction.empty() || m_IfActions.HasActions();
+}
+
+std::shared_ptr<MeasureHistory> Measure::GetHistory(int updateDivider, size_t depth)
+{
+	std::shared_ptr<MeasureHistory> history;
+	for (auto iter = m_Histories.begin(); iter != m_Histories.end(); )
+	{
+		if (iter->second.expired())
 		{
-			m_IfActions.ReadConditionOptions(m_Skin->GetParser(), GetName());
+			// No longer used by any consumer.
+			iter = m_Histories.erase(iter);
+			continue;
 		}
 
-		if (m_Skin)
+		if (iter->first == updateDivider)
 		{
-			m_IfActions.DoIfActions(*this, m_Value);
+			history = iter->second.lock();
 		}
+		++iter;
+	}
 
-		return true;
+	if (!history)
+	{
+		history = std::make_shared<MeasureHistory>();
+		m_Histories.emplace_back(updateDivider, history);
 	}
-	else
+
+	history->Reserve(depth);
+	return history;
+}
+
+const MeasureHistory& Measure::GetUpdateHistory(size_t depth)
+{
+	if (!m_UpdateHistory)
 	{
-		// Disabled measures have 0 as value
-		m_Value = 0.0;
+		m_UpdateHistory.reset(new MeasureHistory());
+	}
 
-		m_IfActions.SetState(m_Value);
+	m_UpdateHistory->Reserve(depth);
+	return *m_UpdateHistory;
+}
 
-		return false;
+/*
+** Appends the measures that are read when updating this measure to |dependencies|.
+**
+*/
+void Measure::GetDependencies(std::vector<Measure*>& dependencies)
+{
+	// The measures in the conditions are looked up in the skin.
+	if (m_Skin)
+	{
+		m_IfActions.GetDependencies(m_Skin, dependencies);
+	}
+}
+
+void Measure::SetDependencies(std::vector<Measure*> dependencies)
+{
+	m_Dependencies.swap(dependencies);
+	m_DependencyGenerations.clear();
+}
+
+/*
+** Reads the IfCondition and IfMatch options again and records the variables referenced by them,
+** which are no longer read by ReadOptions() after the first time.
+**
+*/
+void Measure::ReadConditionOptions(ConfigParser& parser)
+{
+	ConfigParser::OptionReferences references = {};
+	ConfigParser::OptionReferences* previousReferences = parser.SetOptionReferences(&references);
+	const bool conditionsChanged = m_IfActions.ReadConditionOptions(parser, GetName());
+	parser.SetOptionReferences(previousReferences);
+
+	SetDeferredReferences(parser, std::move(references.variables), references.isVolatile);
+
+	if (conditionsChanged)
+	{
+		RefreshDependencies();
+	}
+}
+
+/*
+** Collects the dependencies again. The measure is not skipped on its next update and the skin
+** sorts its measures again before then.
+**
+*/
+void Measure::RefreshDependencies()
+{
+	std::vector<Measure*> dependencies = m_MeasureReferences;
+	GetDependencies(dependencies);
+
+	std::sort(dependencies.begin(), dependencies.end());
+	dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+	dependencies.erase(std::remove(dependencies.begin(), dependencies.end(), this), dependencies.end());
+	SetDependencies(std::move(dependencies));
+
+	if (m_Skin)
+	{
+		m_Skin->SetUpdateOrderDirty();
 	}
 }
 
@@ -612,82 +835,118 @@ const WCHAR* Measure::GetStringOrFormattedValue(AUTOSCALE autoScale, double scal
 */
 const WCHAR* Measure::GetFormattedValue(AUTOSCALE autoScale, double scale, int decimals, bool percentual)
 {
-	static WCHAR buffer[128];
-	WCHAR format[32];
-
+	double value;
 	if (percentual)
 	{
-		double val = 100.0 * GetRelativeValue();
+		value = 100.0 * GetRelativeValue();
+	}
+	else if (autoScale != AUTOSCALE_OFF)
+	{
+		value = GetValue();
+	}
+	else
+	{
+		value = GetValue() / scale;
+	}
+
+	// The same value is often requested by several meters so the result is reused as long as the
+	// value to be formatted does not change. Keying on the value rather than on the update also
+	// covers changes to e.g. MinValue/MaxValue between updates.
+	FormattedValue* entry = nullptr;
+	for (auto& formatted : m_FormattedValues)
+	{
+		if (formatted.autoScale == autoScale && formatted.decimals == decimals &&
+			formatted.percentual == percentual && IsSameValue(formatted.scale, scale))
+		{
+			if (IsSameValue(formatted.value, value))
+			{
+				return formatted.result.c_str();
+			}
 
-		_snwprintf_s(format, _TRUNCATE, L"%%.%if", decimals);
-		_snwprintf_s(buffer, _TRUNCATE, format, val);
+			entry = &formatted;
+			break;
+		}
+	}
+
+	WCHAR buffer[128];
+	if (percentual)
+	{
+		FormatFixed(value, decimals, buffer, _countof(buffer));
 	}
 	else if (autoScale != AUTOSCALE_OFF)
 	{
-		GetScaledValue(autoScale, decimals, GetValue(), buffer, _countof(buffer));
+		GetScaledValue(autoScale, decimals, value, buffer, _countof(buffer));
+	}
+	else if (decimals == -1)
+	{
+		int len = FormatFixed(value, 5, buffer, _countof(buffer));
+		RemoveTrailingZero(buffer, len);
 	}
 	else
 	{
-		double val = GetValue() / scale;
+		FormatFixed(value, decimals, buffer, _countof(buffer));
+	}
 
-		if (decimals == -1)
+	if (!entry)
+	{
+		if (m_FormattedValues.size() < MAX_FORMATTED_VALUES)
 		{
-			int len = _snwprintf_s(buffer, _TRUNCATE, L"%.5f", val);
-			RemoveTrailingZero(buffer, len);
+			// Reserve all entries up front so that returned strings do not move.
+			m_FormattedValues.reserve(MAX_FORMATTED_VALUES);
+			m_FormattedValues.emplace_back();
+			entry = &m_FormattedValues.back();
 		}
 		else
 		{
-			_snwprintf_s(format, _TRUNCATE, L"%%.%if", decimals);
-			_snwprintf_s(buffer, _TRUNCATE, format, val);
+			entry = &m_FormattedValues[m_NextFormattedValue];
+			m_NextFormattedValue = (m_NextFormattedValue + 1) % MAX_FORMATTED_VALUES;
 		}
+
+		entry->autoScale = autoScale;
+		entry->scale = scale;
+		entry->decimals = decimals;
+		entry->percentual = percentual;
 	}
 
-	return CheckSubstitute(buffer);
+	entry->value = value;
+	entry->result = CheckSubstitute(buffer);
+	return entry->result.c_str();
 }
 
 void Measure::GetScaledValue(AUTOSCALE autoScale, int decimals, double theValue, WCHAR* buffer, size_t sizeInWords)
 {
-	WCHAR format[32] = { 0 };
-	double value = 0;
-
-	if (decimals == 0)
-	{
-		wcsncpy_s(format, L"%.0f", _TRUNCATE);
-	}
-	else
-	{
-		_snwprintf_s(format, _TRUNCATE, L"%%.%if", decimals);
-	}
-
 	const double* tblScale =
 		g_TblScale[(autoScale == AUTOSCALE_1000 || autoScale == AUTOSCALE_1000K) ? AUTOSCALE_INDEX_1000 : AUTOSCALE_INDEX_1024];
 
+	double value = theValue;
+	const WCHAR* suffix = L" ";
 	if (theValue >= tblScale[0])
 	{
 		value = theValue / tblScale[0];
-		wcsncat_s(format, L" T", _TRUNCATE);
+		suffix = L" T";
 	}
 	else if (theValue >= tblScale[1])
 	{
 		value = theValue / tblScale[1];
-		wcsncat_s(format, L" G", _TRUNCATE);
+		suffix = L" G";
 	}
 	else if (theValue >= tblScale[2])
 	{
 		value = theValue / tblScale[2];
-		wcsncat_s(format, L" M", _TRUNCATE);
+		suffix = L" M";
 	}
 	else if (autoScale == AUTOSCALE_1024K || autoScale == AUTOSCALE_1000K || theValue >= tblScale[3])
 	{
 		value = theValue / tblScale[3];
-		wcsncat_s(format, L" k", _TRUNCATE);
+		suffix = L" k";
 	}
-	else
+
+	// Formatting the value and appending the suffix separately avoids building a format string.
+	const int len = FormatFixed(value, decimals, buffer, sizeInWords);
+	if (len >= 0 && (size_t)len < sizeInWords)
 	{
-		value = theValue;
-		wcsncat_s(format, L" ", _TRUNCATE);
+		wcsncpy_s(buffer + len, sizeInWords - len, suffix, _TRUNCATE);
 	}
-	_snwprintf_s(buffer, sizeInWords, _TRUNCATE, format, value);
 }
 
 void Measure::RemoveTrailingZero(WCHAR* str, int strLen)
@@ -868,17 +1127,42 @@ void Measure::Command(const std::wstring& command)
 bool Measure::GetCurrentMeasureValue(const WCHAR* str, int len, double* value, void* context)
 {
 	auto measure = (Measure*)context;
-	const std::vector<Measure*>& measures = measure->m_Skin->GetMeasures();
+	Measure* found = measure->m_Skin->GetParser().GetMeasure(str, (size_t)len);
+	if (found)
+	{
+		*value = found->GetValue();
+		return true;
+	}
 
-	for (const auto& iter : measures)
+	return false;
+}
+
+/*
+** Appends the measures referenced by name in |formula| to |measures|.
+**
+*/
+void Measure::FindMeasureReferences(Skin* skin, const WCHAR* formula, std::vector<Measure*>& measures)
+{
+	struct Context
 	{
-		if (iter->GetOriginalName().length() == len &&
-			_wcsnicmp(str, iter->GetName(), len) == 0)
+		ConfigParser& parser;
+		std::vector<Measure*>& measures;
+	} context = { skin->GetParser(), measures };
+
+	auto resolveName = [](const WCHAR* str, int len, int* slot, void* context) -> bool
+	{
+		auto findContext = (Context*)context;
+		Measure* measure = findContext->parser.GetMeasure(str, (size_t)len);
+		if (measure)
 		{
-			*value = iter->GetValue();
-			return true;
+			findContext->measures.push_back(measure);
 		}
-	}
 
-	return false;
+		// Accept unknown names as well so that the rest of the formula is scanned.
+		*slot = 0;
+		return true;
+	};
+
+	MathParser::Program program;
+	MathParser::Compile(formula, program, resolveName, &context);
 }
@@ -11,7 +11,11 @@
 #include <windows.h>
 #include <vector>
 #include <string>
+#include <memory>
 #include "IfActions.h"
+#include "MeasureHistory.h"
+#include "PlainSubstitute.h"
+#include "SlidingWindow.h"
 #include "Util.h"
 #include "Section.h"
 
@@ -49,11 +53,21 @@ public:
 
 	Measure(const Measure& other) = delete;
 
-	void ReadOptions(ConfigParser& parser) { ReadOptions(parser, GetName()); }
+	void ReadOptions(ConfigParser& parser) { ReadTrackedOptions(parser); }
 
 	virtual void Initialize();
 	bool Update(bool rereadOptions = false);
 
+	// Update() in steps for skins with ParallelMeasures=1. Only DoUpdateValue() may be called on a
+	// worker thread and only if BeginUpdate() returned true.
+	bool BeginUpdate(bool rereadOptions);
+	void DoUpdateValue() { UpdateValue(); }
+	void EndUpdate(bool rereadOptions);
+
+	// Returns true after BeginUpdate() returned true until EndUpdate() is called. False if the
+	// measure has been disabled, paused or updated again (e.g. with !UpdateMeasure) in between.
+	bool IsUpdatePending() const { return m_UpdatePending; }
+
 	void Disable();
 	void Enable();
 	bool IsDisabled() { return m_Disabled; }
@@ -82,6 +96,48 @@ public:
 
 	static Measure* Create(const WCHAR* measure, Skin* skin, const WCHAR* name);
 	static bool GetCurrentMeasureValue(const WCHAR* str, int len, double* value, void* context);
+	static void FindMeasureReferences(Skin* skin, const WCHAR* formula, std::vector<Measure*>& measures);
+
+	// Incremented whenever the value returned by GetValue(), its range, the string value or the
+	// options of the measure change.
+	UINT GetValueGeneration();
+
+	virtual void GetDependencies(std::vector<Measure*>& dependencies);
+	const std::vector<Measure*>& GetDependencies() const { return m_Dependencies; }
+	void SetDependencies(std::vector<Measure*> dependencies);
+
+	// The measures whose values were substituted into the options (e.g. [&Measure]) when the skin
+	// was read. Part of the dependencies in addition to those from GetDependencies().
+	const std::vector<Measure*>& GetMeasureReferences() const { return m_MeasureReferences; }
+	void SetMeasureReferences(std::vector<Measure*> references) { m_MeasureReferences.swap(references); }
+
+	bool IsUpToDate();
+
+	// Returns true if the measure must be updated even if nothing reads its value, e.g. because it
+	// executes actions or other measures depend on its state.
+	virtual bool HasSideEffects();
+
+	// Returns true if UpdateValue() can run on a worker thread concurrently with the updates of
+	// other measures. It must only change the state of this measure, must not use the skin, the
+	// parser or the main window and may only read shared state that is not changed while measures
+	// are updated.
+	virtual bool IsThreadSafe() { return false; }
+
+	// Used by skins with LazyMeasures=1. A measure is observed if a visible meter, a measure with
+	// side effects or another observed measure reads it. Measures that are not observed are not
+	// updated and become stale until they are read.
+	bool IsObserved() const { return m_Observed; }
+	void SetObserved(bool observed) { m_Observed = observed; }
+	bool IsStale() const { return m_Stale; }
+	void SetStale(bool stale) { m_Stale = stale; }
+
+	// Returns the history of the values recorded by consumers (e.g. Line meters) that are updated
+	// every |updateDivider| skin updates. The history keeps at least |depth| values.
+	std::shared_ptr<MeasureHistory> GetHistory(int updateDivider, size_t depth);
+
+	// Returns the history of the values after each update of the measure. It is only recorded
+	// once it has been requested.
+	const MeasureHistory& GetUpdateHistory(size_t depth);
 
 protected:
 	Measure(Skin* skin, const WCHAR* name);
@@ -89,6 +145,23 @@ protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 	virtual void UpdateValue() = 0;
 
+	// Called after the value has been updated so that [MeasureName] in the conditions refers to
+	// the new value.
+	void ReadConditionOptions(ConfigParser& parser);
+
+	// Must be called when GetDependencies() changes after the skin was read, e.g. when a formula is
+	// changed with !SetOption.
+	void RefreshDependencies();
+
+	// Returns true if the value depends only on the values of the dependencies, i.e. updating the
+	// measure again without any of them changing would produce the same value.
+	virtual bool IsDerived() { return false; }
+
+	// Returns true if the value may change without the measure being updated (e.g. when it is
+	// read from state updated by another measure). GetStringValue() is then called whenever the
+	// generation is requested, so it must not have side effects.
+	virtual bool HasVolatileValue() { return false; }
+
 	bool ParseSubstitute(std::wstring buffer);
 	std::wstring ExtractWord(std::wstring& buffer);
 	const WCHAR* CheckSubstitute(const WCHAR* buffer);
@@ -106,23 +179,54 @@ protected:
 
 	std::vector<std::wstring> m_Substitute;
 	bool m_RegExpSubstitute;
+	PlainSubstitute m_PlainSubstitute;
 
-	std::vector<double> m_MedianValues;	// The values for the median filtering
-	UINT m_MedianPos;					// Position in the median array, where the new value is placed
+	struct FormattedValue
+	{
+		AUTOSCALE autoScale;
+		double scale;
+		int decimals;
+		bool percentual;
+		double value;			// The value before formatting
+		std::wstring result;	// The formatted and substituted value
+	};
 
-	std::vector<double> m_AverageValues;
-	UINT m_AveragePos;
+	std::vector<FormattedValue> m_FormattedValues;
+	size_t m_NextFormattedValue;	// The entry to replace when |m_FormattedValues| is full
+
+	SlidingMedian m_Median;				// The values for the median filtering
+
+	SlidingAverage m_Average;
 	UINT m_AverageSize;
 
+	std::vector<std::pair<int, std::weak_ptr<MeasureHistory>>> m_Histories;	// By update divider
+	std::unique_ptr<MeasureHistory> m_UpdateHistory;
+
 	IfActions m_IfActions;
 
 	bool m_Disabled;
 	bool m_Paused;
 	bool m_Initialized;
+	bool m_Observed;
+	bool m_Stale;
+	bool m_UpdatePending;
 
 	std::wstring m_OnChangeAction;
 	MeasureValueSet* m_OldValue;
 	bool m_ValueAssigned;
+
+private:
+	UINT m_ValueGeneration;
+	bool m_GenerationStale;			// If true, the values below must be compared after an update
+	double m_GenerationValue;
+	double m_GenerationMinValue;
+	double m_GenerationMaxValue;
+	bool m_GenerationHasString;
+	std::wstring m_GenerationString;
+
+	std::vector<Measure*> m_MeasureReferences;
+	std::vector<Measure*> m_Dependencies;
+	std::vector<UINT> m_DependencyGenerations;	// Generations of |m_Dependencies| at the last update
 };
 
 #endif
@@ -28,7 +28,7 @@ typedef struct _SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION {
 
 FPNTQSI MeasureCPU::c_NtQuerySystemInformation = nullptr;
 int MeasureCPU::c_NumOfProcessors = 0;
-ULONG MeasureCPU::c_BufferSize = 0;
+volatile LONG MeasureCPU::c_BufferSize = 0L;
 
 // ntdll!NtQuerySystemInformation (NT specific!)
 //
@@ -102,7 +102,7 @@ void MeasureCPU::UpdateValue()
 	else if (c_NtQuerySystemInformation)
 	{
 		LONG status = 0L;
-		ULONG bufSize = c_BufferSize;
+		ULONG bufSize = (ULONG)c_BufferSize;
 		BYTE* buf = (bufSize > 0) ? new BYTE[bufSize] : nullptr;
 
 		int loop = 0;
@@ -151,10 +151,10 @@ void MeasureCPU::UpdateValue()
 
 		if (status == STATUS_SUCCESS)
 		{
-			if (bufSize != c_BufferSize)
+			if (bufSize != (ULONG)c_BufferSize)
 			{
 				// Store the new buffer size
-				c_BufferSize = bufSize;
+				InterlockedExchange(&c_BufferSize, (LONG)bufSize);
 			}
 
 			PSYSTEM_PROCESSOR_PERFORMANCE_INFORMATION systemPerfInfo = (PSYSTEM_PROCESSOR_PERFORMANCE_INFORMATION)buf;
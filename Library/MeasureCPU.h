@@ -23,6 +23,8 @@ public:
 
 	virtual UINT GetTypeID() { return TypeID<MeasureCPU>(); }
 
+	virtual bool IsThreadSafe() { return true; }
+
 	static void InitializeStatic();
 	static void FinalizeStatic();
 
@@ -40,7 +42,7 @@ private:
 	static FPNTQSI c_NtQuerySystemInformation;
 
 	static int c_NumOfProcessors;
-	static ULONG c_BufferSize;
+	static volatile LONG c_BufferSize;	// Shared by measures updated concurrently
 };
 
 #endif
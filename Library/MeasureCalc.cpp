@@ -6,7 +6,6 @@
  * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
 
 #include "StdAfx.h"
-#include "../Common/MathParser.h"
 #include "MeasureCalc.h"
 #include "Rainmeter.h"
 #include <random>
@@ -15,6 +14,10 @@ const int DEFAULT_LOWER_BOUND = 0;
 const int DEFAULT_UPPER_BOUND = 100;
 const int DEFAULT_UNIQUELIMIT = 65535;
 
+// Slots that do not refer to a measure in |m_Slots|.
+const int SLOT_COUNTER = -1;
+const int SLOT_RANDOM = -2;
+
 std::mt19937& GetRandomEngine()
 {
 	static std::unique_ptr<std::mt19937> s_Engine(new std::mt19937((uint32_t)time(nullptr)));
@@ -23,6 +26,7 @@ std::mt19937& GetRandomEngine()
 
 MeasureCalc::MeasureCalc(Skin* skin, const WCHAR* name) : Measure(skin, name),
 	m_ParseError(false),
+	m_Derived(false),
 	m_LowBound(DEFAULT_LOWER_BOUND),
 	m_HighBound(DEFAULT_UPPER_BOUND),
 	m_UpdateRandom(false),
@@ -40,7 +44,13 @@ MeasureCalc::~MeasureCalc()
 */
 void MeasureCalc::UpdateValue()
 {
-	const WCHAR* errMsg = MathParser::Parse(m_Formula.c_str(), &m_Value, GetMeasureValue, this);
+	if (m_Program.code.empty())
+	{
+		// Compilation failed.
+		return;
+	}
+
+	const WCHAR* errMsg = MathParser::Evaluate(m_Program, &m_Value, GetSlotValue, this);
 	if (errMsg != nullptr)
 	{
 		if (!m_ParseError)
@@ -116,9 +126,28 @@ void MeasureCalc::ReadOptions(ConfigParser& parser, const WCHAR* section)
 			LogErrorF(this, L"Calc: %s", errMsg);
 			m_Formula.clear();
 		}
+
+		m_Slots.clear();
+		m_Derived = true;
+		CompileContext context = { this, parser };
+		errMsg = MathParser::Compile(m_Formula.c_str(), m_Program, ResolveName, &context);
+		if (errMsg != nullptr && !m_ParseError)
+		{
+			LogErrorF(this, L"Calc: %s", errMsg);
+			m_ParseError = true;
+		}
+
+		// The formula may refer to other measures now, e.g. after !SetOption.
+		RefreshDependencies();
 	}
 }
 
+void MeasureCalc::GetDependencies(std::vector<Measure*>& dependencies)
+{
+	Measure::GetDependencies(dependencies);
+	dependencies.insert(dependencies.end(), m_Slots.begin(), m_Slots.end());
+}
+
 /*
 ** This replaces the word Random in the formula with a random number
 **
@@ -153,36 +182,53 @@ void MeasureCalc::FormulaReplace()
 	while (pos != std::wstring::npos);
 }
 
-bool MeasureCalc::GetMeasureValue(const WCHAR* str, int len, double* value, void* context)
+bool MeasureCalc::ResolveName(const WCHAR* str, int len, int* slot, void* context)
 {
-	auto calc = (MeasureCalc*)context;
-	const std::vector<Measure*>& measures = calc->m_Skin->GetMeasures();
+	auto compileContext = (CompileContext*)context;
+	MeasureCalc* calc = compileContext->calc;
 
-	std::vector<Measure*>::const_iterator iter = measures.begin();
-	for ( ; iter != measures.end(); ++iter)
+	// The measure pointers are valid until the skin is refreshed, at which point the formula is
+	// compiled again.
+	Measure* measure = compileContext->parser.GetMeasure(str, (size_t)len);
+	if (measure)
 	{
-		if ((*iter)->GetOriginalName().length() == len &&
-			_wcsnicmp(str, (*iter)->GetName(), len) == 0)
-		{
-			*value = (*iter)->GetValue();
-			return true;
-		}
+		*slot = (int)calc->m_Slots.size();
+		calc->m_Slots.push_back(measure);
+		return true;
 	}
 
 	if (_wcsnicmp(str, L"counter", len) == 0)
 	{
-		*value = calc->m_Skin->GetUpdateCounter();
+		*slot = SLOT_COUNTER;
+		calc->m_Derived = false;
 		return true;
 	}
 	else if (_wcsnicmp(str, L"random", len) == 0)
 	{
-		*value = calc->GetRandom();
+		*slot = SLOT_RANDOM;
+		calc->m_Derived = false;
 		return true;
 	}
 
 	return false;
 }
 
+double MeasureCalc::GetSlotValue(int slot, void* context)
+{
+	auto calc = (MeasureCalc*)context;
+	switch (slot)
+	{
+	case SLOT_COUNTER:
+		return calc->m_Skin->GetUpdateCounter();
+
+	case SLOT_RANDOM:
+		return calc->GetRandom();
+
+	default:
+		return calc->m_Slots[slot]->GetValue();
+	}
+}
+
 int MeasureCalc::GetRandom()
 {
 	if (m_LowBound == m_HighBound || m_LowBound > m_HighBound)
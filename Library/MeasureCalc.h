@@ -9,6 +9,7 @@
 #define __MEASURECALC_H__
 
 #include "Measure.h"
+#include "../Common/MathParser.h"
 
 class MeasureCalc : public Measure
 {
@@ -21,12 +22,22 @@ public:
 
 	virtual UINT GetTypeID() { return TypeID<MeasureCalc>(); }
 
+	virtual void GetDependencies(std::vector<Measure*>& dependencies);
+
 protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 	virtual void UpdateValue();
+	virtual bool IsDerived() { return m_Derived; }
 
 private:
-	static bool GetMeasureValue(const WCHAR* str, int len, double* value, void* context);
+	struct CompileContext
+	{
+		MeasureCalc* calc;
+		ConfigParser& parser;
+	};
+
+	static bool ResolveName(const WCHAR* str, int len, int* slot, void* context);
+	static double GetSlotValue(int slot, void* context);
 
 	void FormulaReplace();
 	int GetRandom();
@@ -34,6 +45,10 @@ private:
 	std::wstring m_Formula;
 	bool m_ParseError;
 
+	MathParser::Program m_Program;
+	std::vector<Measure*> m_Slots;
+	bool m_Derived;		// True if |m_Program| does not use Counter or Random
+
 	int m_LowBound;
 	int m_HighBound;
 
@@ -0,0 +1,108 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "ConfigParser.h"
+#include "MeasureCalc.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_MeasureCalc_Test)
+{
+public:
+	// Exposes the read of the conditions done after each update with DynamicVariables=1.
+	class ConditionCalc : public MeasureCalc
+	{
+	public:
+		ConditionCalc(const WCHAR* name) : MeasureCalc(nullptr, name) {}
+		using Measure::ReadConditionOptions;
+	};
+
+	TEST_METHOD(TestFormulaChange)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		parser.SetValue(L"A", L"Formula", L"1");
+		parser.SetValue(L"B", L"Formula", L"2");
+		parser.SetValue(L"C", L"Formula", L"A");
+
+		MeasureCalc calcA(nullptr, L"A");
+		MeasureCalc calcB(nullptr, L"B");
+		MeasureCalc calcC(nullptr, L"C");
+		Measure* a = &calcA;
+		Measure* b = &calcB;
+		Measure* c = &calcC;
+
+		for (Measure* measure : { a, b, c })
+		{
+			parser.AddMeasure(measure);
+		}
+
+		for (Measure* measure : { a, b, c })
+		{
+			measure->ReadOptions(parser);
+			measure->Update();
+		}
+		Assert::AreEqual(1.0, c->GetValue());
+		Assert::IsTrue(c->IsUpToDate());
+
+		// Same as !SetOption C Formula B.
+		parser.SetValue(L"C", L"Formula", L"B");
+		c->ReadOptions(parser);
+		Assert::IsTrue(c->GetDependencies() == std::vector<Measure*>{ b });
+		Assert::IsFalse(c->IsUpToDate());
+		c->Update();
+		Assert::AreEqual(2.0, c->GetValue());
+		Assert::IsTrue(c->IsUpToDate());
+
+		// Changes of the new input are not skipped.
+		parser.SetValue(L"B", L"Formula", L"3");
+		b->ReadOptions(parser);
+		b->Update();
+		Assert::IsFalse(c->IsUpToDate());
+		c->Update();
+		Assert::AreEqual(3.0, c->GetValue());
+
+		// A changed formula with the same inputs is not skipped either.
+		parser.SetValue(L"C", L"Formula", L"B * 2");
+		c->ReadOptions(parser);
+		Assert::IsFalse(c->IsUpToDate());
+		c->Update();
+		Assert::AreEqual(6.0, c->GetValue());
+	}
+
+	TEST_METHOD(TestConditionVariables)
+	{
+		ConfigParser parser;
+		parser.Initialize(L"");  // TODO: Better way to initialize without file.
+
+		parser.SetVariable(L"Threshold", L"1");
+		parser.SetValue(L"A", L"Formula", L"2");
+		parser.SetValue(L"A", L"DynamicVariables", L"1");
+		parser.SetValue(L"A", L"IfCondition", L"A > #Threshold#");
+		parser.SetValue(L"A", L"IfTrueAction", L"[!Log True]");
+
+		ConditionCalc calc(L"A");
+		Measure* a = &calc;
+		parser.AddMeasure(a);
+		a->ReadOptions(parser);
+		a->Initialize();
+		Assert::IsFalse(a->IsOptionsDirty());
+
+		// The variable is only used by the condition, which is not read by ReadOptions() after the
+		// first time. Setting it must still mark the options as changed after every read.
+		for (int i = 2; i < 5; ++i)
+		{
+			parser.SetVariable(L"Threshold", std::to_wstring(i));
+			Assert::IsTrue(a->IsOptionsDirty());
+
+			a->ReadOptions(parser);
+			calc.ReadConditionOptions(parser);
+			Assert::IsFalse(a->IsOptionsDirty());
+		}
+	}
+};
@@ -21,6 +21,8 @@ public:
 
 	virtual UINT GetTypeID() { return TypeID<MeasureDiskSpace>(); }
 
+	virtual bool IsThreadSafe() { return true; }
+
 	virtual const WCHAR* GetStringValue();
 
 protected:
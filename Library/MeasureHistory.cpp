@@ -0,0 +1,159 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "MeasureHistory.h"
+
+MeasureHistory::MeasureHistory() :
+	m_Count(),
+	m_LastTick()
+{
+}
+
+void MeasureHistory::Reserve(size_t depth)
+{
+	const size_t oldDepth = m_Values.size();
+	if (depth <= oldDepth) return;
+
+	// Values are stored at (index % depth) so they must be moved.
+	std::vector<double> values(depth, 0.0);
+	const uint64_t first = (m_Count > oldDepth) ? m_Count - oldDepth : 0ULL;
+	for (uint64_t i = first; i < m_Count; ++i)
+	{
+		values[(size_t)(i % depth)] = m_Values[(size_t)(i % oldDepth)];
+	}
+
+	m_Values.swap(values);
+	RebuildExtremes();
+}
+
+void MeasureHistory::Add(double value)
+{
+	const size_t depth = m_Values.size();
+	if (depth == 0) return;
+
+	const uint64_t index = m_Count++;
+	m_Values[(size_t)(index % depth)] = value;
+
+	Push(m_Mins, index, value, [](double a, double b) { return a < b; });
+	Push(m_Maxs, index, value, [](double a, double b) { return a > b; });
+
+	// Drop the candidates that are no longer in the buffer.
+	if (m_Mins.front().first + depth <= index) m_Mins.pop_front();
+	if (m_Maxs.front().first + depth <= index) m_Maxs.pop_front();
+}
+
+void MeasureHistory::Record(double value, int tick, const void* consumer)
+{
+	if (!m_Consumers.empty() && tick == m_LastTick &&
+		std::find(m_Consumers.cbegin(), m_Consumers.cend(), consumer) == m_Consumers.cend())
+	{
+		// Another consumer already added the value for this update.
+		m_Consumers.push_back(consumer);
+		return;
+	}
+
+	m_LastTick = tick;
+	m_Consumers.assign(1, consumer);
+	Add(value);
+}
+
+double MeasureHistory::GetValue(size_t count, size_t index) const
+{
+	const uint64_t age = count - index;	// 1 for the newest value
+	if (index >= count || age > m_Count || age > m_Values.size()) return 0.0;
+
+	return m_Values[(size_t)((m_Count - age) % m_Values.size())];
+}
+
+double MeasureHistory::GetMin(size_t count) const
+{
+	return GetExtreme(m_Mins, count, [](double a, double b) { return a < b; });
+}
+
+double MeasureHistory::GetMax(size_t count) const
+{
+	return GetExtreme(m_Maxs, count, [](double a, double b) { return a > b; });
+}
+
+void MeasureHistory::Decimate(size_t count, size_t width, std::vector<double>& mins, std::vector<double>& maxs) const
+{
+	mins.assign(width, 0.0);
+	maxs.assign(width, 0.0);
+	if (count == 0) return;
+
+	for (size_t i = 0; i < width; ++i)
+	{
+		const size_t begin = i * count / width;
+		const size_t end = max(begin + 1, (i + 1) * count / width);
+
+		double minValue = GetValue(count, begin);
+		double maxValue = minValue;
+		for (size_t j = begin + 1; j < end; ++j)
+		{
+			const double value = GetValue(count, j);
+			minValue = min(minValue, value);
+			maxValue = max(maxValue, value);
+		}
+
+		mins[i] = minValue;
+		maxs[i] = maxValue;
+	}
+}
+
+/*
+** Adds |value| to a monotonic queue: the candidates that can no longer be the extreme because
+** |value| is newer and at least as extreme are removed first.
+**
+*/
+template <typename Compare>
+void MeasureHistory::Push(Extremes& extremes, uint64_t index, double value, Compare compare)
+{
+	while (!extremes.empty() && !compare(extremes.back().second, value))
+	{
+		extremes.pop_back();
+	}
+
+	extremes.emplace_back(index, value);
+}
+
+template <typename Compare>
+double MeasureHistory::GetExtreme(const Extremes& extremes, size_t count, Compare compare) const
+{
+	count = min(count, m_Values.size());
+	if (count == 0) return 0.0;
+
+	// The first candidate within the last |count| values is the extreme of them.
+	const uint64_t first = (m_Count > count) ? m_Count - count : 0ULL;
+	auto iter = std::lower_bound(extremes.cbegin(), extremes.cend(), first,
+		[](const std::pair<uint64_t, double>& item, uint64_t index) { return item.first < index; });
+
+	double value = (iter != extremes.cend()) ? iter->second : 0.0;
+
+	// Values that have not been recorded yet are 0.
+	if (m_Count < count && compare(0.0, value))
+	{
+		value = 0.0;
+	}
+
+	return value;
+}
+
+void MeasureHistory::RebuildExtremes()
+{
+	m_Mins.clear();
+	m_Maxs.clear();
+
+	const size_t depth = m_Values.size();
+	const uint64_t first = (m_Count > depth) ? m_Count - depth : 0ULL;
+	for (uint64_t i = first; i < m_Count; ++i)
+	{
+		const double value = m_Values[(size_t)(i % depth)];
+		Push(m_Mins, i, value, [](double a, double b) { return a < b; });
+		Push(m_Maxs, i, value, [](double a, double b) { return a > b; });
+	}
+}
@@ -0,0 +1,81 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __MEASUREHISTORY_H__
+#define __MEASUREHISTORY_H__
+
+#include <windows.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Ring buffer of the most recent values of a measure shared by the meters (and scripts) that graph
+// it. Values that have not been recorded yet are 0.
+class MeasureHistory
+{
+public:
+	MeasureHistory();
+
+	MeasureHistory(const MeasureHistory& other) = delete;
+	MeasureHistory& operator=(MeasureHistory other) = delete;
+
+	size_t GetDepth() const { return m_Values.size(); }
+
+	// Makes sure that at least |depth| values are kept.
+	void Reserve(size_t depth);
+
+	void Add(double value);
+
+	// Adds |value| for |consumer| during skin update |tick|. Consumers that record in the same
+	// update share the value, so a value is only added once per update unless the same consumer
+	// records again (e.g. because of !UpdateMeter).
+	void Record(double value, int tick, const void* consumer);
+
+	// Returns the number of values that have been added.
+	uint64_t GetCount() const { return m_Count; }
+
+	// Returns the |index|th of the last |count| values, oldest first.
+	double GetValue(size_t count, size_t index) const;
+
+	// Returns the value that would be at |pos| if the values were kept in a ring buffer of |size|
+	// values. The oldest value is at (GetCount() % size).
+	double GetRingValue(size_t size, size_t pos) const
+	{
+		return GetValue(size, (pos + size - (size_t)(m_Count % size)) % size);
+	}
+
+	// Returns the smallest and largest of the last |count| values.
+	double GetMin(size_t count) const;
+	double GetMax(size_t count) const;
+
+	// Splits the last |count| values into |width| buckets and returns the smallest and largest
+	// value of each bucket.
+	void Decimate(size_t count, size_t width, std::vector<double>& mins, std::vector<double>& maxs) const;
+
+private:
+	// Candidates for the minimum or maximum as (value index, value) with increasing indices.
+	typedef std::deque<std::pair<uint64_t, double>> Extremes;
+
+	template <typename Compare>
+	static void Push(Extremes& extremes, uint64_t index, double value, Compare compare);
+
+	template <typename Compare>
+	double GetExtreme(const Extremes& extremes, size_t count, Compare compare) const;
+
+	void RebuildExtremes();
+
+	std::vector<double> m_Values;
+	uint64_t m_Count;
+
+	Extremes m_Mins;	// Increasing values
+	Extremes m_Maxs;	// Decreasing values
+
+	int m_LastTick;
+	std::vector<const void*> m_Consumers;	// Consumers that recorded the last value
+};
+
+#endif
@@ -0,0 +1,140 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "MeasureHistory.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_MeasureHistory_Test)
+{
+public:
+	TEST_METHOD(TestValues)
+	{
+		MeasureHistory history;
+		history.Add(1.0);
+		Assert::AreEqual(0ULL, history.GetCount());
+		Assert::AreEqual(0.0, history.GetValue(3, 2));
+
+		history.Reserve(3);
+		history.Add(1.0);
+		history.Add(2.0);
+		Assert::AreEqual(0.0, history.GetValue(3, 0));
+		Assert::AreEqual(1.0, history.GetValue(3, 1));
+		Assert::AreEqual(2.0, history.GetValue(3, 2));
+		Assert::AreEqual(2.0, history.GetValue(1, 0));
+		Assert::AreEqual(0.0, history.GetMin(3));
+		Assert::AreEqual(1.0, history.GetMin(2));
+		Assert::AreEqual(2.0, history.GetMax(3));
+
+		history.Add(3.0);
+		history.Add(4.0);
+		Assert::AreEqual(2.0, history.GetValue(3, 0));
+		Assert::AreEqual(4.0, history.GetValue(3, 2));
+		Assert::AreEqual(2.0, history.GetMin(3));
+
+		// Same as a ring buffer of 3 values where the next value goes to position 1.
+		Assert::AreEqual(1ULL, history.GetCount() % 3);
+		Assert::AreEqual(4.0, history.GetRingValue(3, 0));
+		Assert::AreEqual(2.0, history.GetRingValue(3, 1));
+		Assert::AreEqual(3.0, history.GetRingValue(3, 2));
+
+		// Existing values are kept when the depth increases.
+		history.Reserve(5);
+		Assert::AreEqual(0.0, history.GetValue(5, 1));
+		Assert::AreEqual(2.0, history.GetValue(5, 2));
+		Assert::AreEqual(4.0, history.GetValue(5, 4));
+		Assert::AreEqual(0.0, history.GetMin(5));
+		Assert::AreEqual(4.0, history.GetMax(5));
+	}
+
+	TEST_METHOD(TestRecord)
+	{
+		MeasureHistory history;
+		history.Reserve(10);
+
+		int meter1 = 0, meter2 = 0;
+		history.Record(1.0, 1, &meter1);
+		history.Record(1.0, 1, &meter2);
+		Assert::AreEqual(1ULL, history.GetCount());
+
+		history.Record(2.0, 2, &meter2);
+		history.Record(2.0, 2, &meter1);
+		Assert::AreEqual(2ULL, history.GetCount());
+
+		// The same meter updated again in the same skin update.
+		history.Record(3.0, 2, &meter1);
+		Assert::AreEqual(3ULL, history.GetCount());
+		Assert::AreEqual(3.0, history.GetValue(1, 0));
+	}
+
+	TEST_METHOD(TestMinMax)
+	{
+		UINT seed = 1U;
+		auto random = [&]()
+		{
+			seed = seed * 1103515245U + 12345U;
+			return (double)((seed >> 16) % 100U) - 50.0;
+		};
+
+		MeasureHistory history;
+		history.Reserve(50);
+
+		std::vector<double> values;
+		for (int i = 0; i < 2000; ++i)
+		{
+			if (i == 1000) history.Reserve(120);
+
+			values.push_back(random());
+			history.Add(values.back());
+
+			const size_t counts[] = { 1, 7, 50, 120 };
+			for (size_t count : counts)
+			{
+				// Values older than the previous depth are lost when the depth is increased.
+				if (count > history.GetDepth() || (count > 50 && i < 1000 + (int)count)) continue;
+
+				double minValue = DBL_MAX;
+				double maxValue = -DBL_MAX;
+				for (size_t j = 0; j < count; ++j)
+				{
+					const double value = (j + values.size() >= count) ? values[j + values.size() - count] : 0.0;
+					Assert::AreEqual(value, history.GetValue(count, j));
+					minValue = min(minValue, value);
+					maxValue = max(maxValue, value);
+				}
+
+				Assert::AreEqual(minValue, history.GetMin(count));
+				Assert::AreEqual(maxValue, history.GetMax(count));
+			}
+		}
+	}
+
+	TEST_METHOD(TestDecimate)
+	{
+		MeasureHistory history;
+		history.Reserve(6);
+		for (int i = 1; i <= 6; ++i)
+		{
+			history.Add((i % 2) ? i : -i);	// 1 -2 3 -4 5 -6
+		}
+
+		std::vector<double> mins;
+		std::vector<double> maxs;
+		history.Decimate(6, 3, mins, maxs);
+		Assert::AreEqual((size_t)3, mins.size());
+		Assert::AreEqual(-2.0, mins[0]);
+		Assert::AreEqual(1.0, maxs[0]);
+		Assert::AreEqual(-6.0, mins[2]);
+		Assert::AreEqual(5.0, maxs[2]);
+
+		// More buckets than values.
+		history.Decimate(2, 4, mins, maxs);
+		Assert::AreEqual(5.0, mins[0]);
+		Assert::AreEqual(5.0, maxs[1]);
+		Assert::AreEqual(-6.0, mins[3]);
+	}
+};
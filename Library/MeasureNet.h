@@ -18,6 +18,8 @@ class MeasureNet : public Measure
 public:
 	virtual UINT GetTypeID() { return TypeID<MeasureNet>(); }
 
+	virtual bool IsThreadSafe() { return true; }
+
 	static void UpdateIFTable();
 
 	static void UpdateStats();
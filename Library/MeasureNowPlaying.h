@@ -27,12 +27,18 @@ public:
 
 	const WCHAR* GetStringValue() override;
 
+	// Child measures read the player of the parent measure
+	bool HasSideEffects() override { return true; }
+
 	void Command(const std::wstring& command) override;
 
 protected:
 	void ReadOptions(ConfigParser& parser, const WCHAR* section) override;
 	void UpdateValue() override;
 
+	// The player state is updated by the parent measure
+	bool HasVolatileValue() override { return true; }
+
 private:
 	ParentMeasure* m_Parent;
 	MeasureType m_Type;
@@ -0,0 +1,132 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "MeasureOrder.h"
+#include "Measure.h"
+
+namespace MeasureOrder {
+
+std::vector<Measure*> Sort(const std::vector<Measure*>& measures)
+{
+	const size_t count = measures.size();
+	const size_t unvisited = (size_t)-1;
+
+	std::unordered_map<Measure*, size_t> indices;
+	for (size_t i = 0; i < count; ++i)
+	{
+		indices[measures[i]] = i;
+	}
+
+	// Tarjan's algorithm with the roots in file order. A group of measures that depend on each
+	// other is emitted after the groups it depends on, so independent measures keep their
+	// relative order. The measures of a group are emitted in file order.
+	std::vector<size_t> visitOrder(count, unvisited);
+	std::vector<size_t> lowLinks(count);
+	std::vector<size_t> positions(count);	// Position in |group|
+	std::vector<bool> inGroup(count, false);
+	std::vector<size_t> group;				// Visited measures whose group is not emitted yet
+	std::vector<std::pair<size_t, size_t>> stack;  // Measure index, next dependency
+	size_t nextVisit = 0;
+
+	auto visit = [&](size_t index)
+	{
+		visitOrder[index] = lowLinks[index] = nextVisit++;
+		positions[index] = group.size();
+		group.push_back(index);
+		inGroup[index] = true;
+		stack.emplace_back(index, 0);
+	};
+
+	std::vector<Measure*> order;
+	order.reserve(count);
+	for (size_t root = 0; root < count; ++root)
+	{
+		if (visitOrder[root] != unvisited) continue;
+
+		visit(root);
+		while (!stack.empty())
+		{
+			const size_t index = stack.back().first;
+			const std::vector<Measure*>& dependencies = measures[index]->GetDependencies();
+			if (stack.back().second < dependencies.size())
+			{
+				auto iter = indices.find(dependencies[stack.back().second++]);
+				if (iter == indices.end()) continue;
+
+				const size_t dependency = iter->second;
+				if (visitOrder[dependency] == unvisited)
+				{
+					visit(dependency);
+				}
+				else if (inGroup[dependency])
+				{
+					lowLinks[index] = min(lowLinks[index], visitOrder[dependency]);
+				}
+				continue;
+			}
+
+			stack.pop_back();
+			if (!stack.empty())
+			{
+				const size_t parent = stack.back().first;
+				lowLinks[parent] = min(lowLinks[parent], lowLinks[index]);
+			}
+
+			if (lowLinks[index] == visitOrder[index])
+			{
+				const auto first = group.begin() + positions[index];
+				std::sort(first, group.end());
+				for (auto member = first; member != group.end(); ++member)
+				{
+					inGroup[*member] = false;
+					order.push_back(measures[*member]);
+				}
+				group.erase(first, group.end());
+			}
+		}
+	}
+
+	return order;
+}
+
+std::vector<Wave> BuildWaves(const std::vector<Measure*>& order)
+{
+	std::vector<Wave> waves;
+	std::unordered_map<Measure*, size_t> measureWaves;
+	for (Measure* measure : order)
+	{
+		const bool parallel = measure->IsThreadSafe();
+
+		size_t wave = 0;
+		for (Measure* dependency : measure->GetDependencies())
+		{
+			// Dependencies in a cycle may not have a wave yet and are ignored.
+			auto iter = measureWaves.find(dependency);
+			if (iter != measureWaves.end())
+			{
+				wave = max(wave, iter->second + (parallel ? 1 : 0));
+			}
+		}
+
+		measureWaves[measure] = wave;
+		if (wave >= waves.size())
+		{
+			waves.resize(wave + 1);
+		}
+
+		waves[wave].measures.push_back(measure);
+		if (parallel)
+		{
+			waves[wave].parallel.push_back(measure);
+		}
+	}
+
+	return waves;
+}
+
+}  // namespace MeasureOrder
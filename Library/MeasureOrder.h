@@ -0,0 +1,37 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __MEASUREORDER_H__
+#define __MEASUREORDER_H__
+
+#include <vector>
+
+class Measure;
+
+// Helpers for the order in which the measures of a skin are updated.
+namespace MeasureOrder {
+
+// Returns |measures| (in file order) sorted so that each measure comes after the measures returned
+// by its GetDependencies(). Measures that depend on each other (e.g. counters that read each
+// other's previous value) are kept in file order, as are independent measures.
+std::vector<Measure*> Sort(const std::vector<Measure*>& measures);
+
+// Measures that are updated in the same step with ParallelMeasures=1.
+struct Wave
+{
+	std::vector<Measure*> measures;	// In update order
+	std::vector<Measure*> parallel;	// The thread-safe ones, which only read measures of earlier waves
+};
+
+// Groups |order| (as returned by Sort()) into waves. The thread-safe measures of a wave only depend
+// on measures of earlier waves. The other measures of a wave may also depend on the thread-safe
+// measures of the same wave that come before them.
+std::vector<Wave> BuildWaves(const std::vector<Measure*>& order);
+
+}  // namespace MeasureOrder
+
+#endif
@@ -0,0 +1,95 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "MeasureOrder.h"
+#include "MeasureCalc.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_MeasureOrder_Test)
+{
+public:
+	// Stands in for thread-safe measures such as CPU.
+	class ThreadSafeCalc : public MeasureCalc
+	{
+	public:
+		ThreadSafeCalc(const WCHAR* name) : MeasureCalc(nullptr, name) {}
+		bool IsThreadSafe() override { return true; }
+	};
+
+	TEST_METHOD(TestSort)
+	{
+		MeasureCalc a(nullptr, L"A");
+		MeasureCalc b(nullptr, L"B");
+		MeasureCalc c(nullptr, L"C");
+		MeasureCalc d(nullptr, L"D");
+
+		// Measures come after their dependencies, independent ones keep their order.
+		a.SetDependencies({ &c });
+		b.SetDependencies({});
+		c.SetDependencies({ &d });
+		d.SetDependencies({});
+		std::vector<Measure*> expected = { &d, &c, &a, &b };
+		Assert::IsTrue(MeasureOrder::Sort({ &a, &b, &c, &d }) == expected);
+	}
+
+	TEST_METHOD(TestSortCycle)
+	{
+		MeasureCalc a(nullptr, L"A");
+		MeasureCalc b(nullptr, L"B");
+		MeasureCalc c(nullptr, L"C");
+		MeasureCalc d(nullptr, L"D");
+
+		// Measures that read each other are kept in file order.
+		a.SetDependencies({ &b });
+		b.SetDependencies({ &a });
+		c.SetDependencies({});
+		d.SetDependencies({});
+		std::vector<Measure*> expected = { &a, &b, &c, &d };
+		Assert::IsTrue(MeasureOrder::Sort({ &a, &b, &c, &d }) == expected);
+
+		// The cycle still comes before the measures that read it.
+		a.SetDependencies({});
+		b.SetDependencies({ &d });
+		c.SetDependencies({});
+		d.SetDependencies({ &b, &c });
+		expected = { &a, &c, &b, &d };
+		Assert::IsTrue(MeasureOrder::Sort({ &a, &b, &c, &d }) == expected);
+		a.SetDependencies({ &d });
+		expected = { &c, &b, &d, &a };
+		Assert::IsTrue(MeasureOrder::Sort({ &a, &b, &c, &d }) == expected);
+	}
+
+	TEST_METHOD(TestBuildWaves)
+	{
+		ThreadSafeCalc input(L"Input");
+		MeasureCalc calc(nullptr, L"Calc");
+		ThreadSafeCalc other(L"Other");
+		ThreadSafeCalc last(L"Last");
+
+		// The Calc reads the input and is read by the last measure.
+		input.SetDependencies({});
+		calc.SetDependencies({ &input });
+		other.SetDependencies({});
+		last.SetDependencies({ &calc });
+
+		const std::vector<Measure*> order = MeasureOrder::Sort({ &input, &calc, &last, &other });
+		const std::vector<MeasureOrder::Wave> waves = MeasureOrder::BuildWaves(order);
+		Assert::AreEqual((size_t)2, waves.size());
+
+		// The Calc is updated in the same wave as its input, but after it.
+		std::vector<Measure*> expected = { &input, &calc, &other };
+		Assert::IsTrue(waves[0].measures == expected);
+		expected = { &input, &other };
+		Assert::IsTrue(waves[0].parallel == expected);
+
+		// Thread-safe measures that read the Calc wait for the next wave.
+		expected = { &last };
+		Assert::IsTrue(waves[1].measures == expected);
+		Assert::IsTrue(waves[1].parallel == expected);
+	}
+};
@@ -41,12 +41,18 @@ public:
 	virtual const WCHAR* GetStringValue();
 	virtual void Command(const std::wstring& command);
 
+	// Plugins may do work (e.g. for child measures) when updated
+	virtual bool HasSideEffects() { return true; }
+
 	bool CommandWithReturn(const std::wstring& command, std::wstring& strValue, void* delayedLogEntry = nullptr);
 
 protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 	virtual void UpdateValue();
 
+	// The plugin is reloaded whenever the options are read
+	virtual bool HasVolatileOptions() { return true; }
+
 private:
 	bool IsNewApi() { return m_ReloadFunc != nullptr; }
 
@@ -21,6 +21,8 @@ public:
 
 	virtual UINT GetTypeID() { return TypeID<MeasureRegistry>(); }
 
+	virtual bool IsThreadSafe() { return true; }
+
 	virtual const WCHAR* GetStringValue();
 
 protected:
@@ -26,6 +26,9 @@ public:
 	virtual const WCHAR* GetStringValue();
 	virtual void Command(const std::wstring& command);
 
+	// Scripts may execute bangs when updated
+	virtual bool HasSideEffects() { return true; }
+
 	bool CommandWithReturn(const std::wstring& command, std::wstring& strValue, void* delayedLogEntry = nullptr);
 
 	void UninitializeLuaScript();
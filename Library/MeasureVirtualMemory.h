@@ -21,6 +21,8 @@ public:
 
 	virtual UINT GetTypeID() { return TypeID<MeasureVirtualMemory>(); }
 
+	virtual bool IsThreadSafe() { return true; }
+
 protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 	virtual void UpdateValue();
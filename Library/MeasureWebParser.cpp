@@ -9,8 +9,7 @@
 #include "MeasureWebParser.h"
 #include "Rainmeter.h"
 #include "System.h"
-#include "pcre/config.h"
-#include "pcre/pcre.h"
+#include "../Common/RegExpCache.h"
 #include "../Common/CharacterEntityReference.h"
 #include "../Common/StringUtil.h"
 #include "../Common/FileUtil.h"
@@ -638,17 +637,13 @@ void MeasureWebParser::ParseData(const BYTE* rawData, DWORD rawSize, bool utf16D
 		utf16Data = true;
 	}
 
-	const char* error = nullptr;
-	int erroffset = 0;
 	int ovector[OVECCOUNT] = { 0 };
 	int rc = 0;
 	bool doErrorAction = false;
 
 	// Compile the regular expression in the first argument
-	pcre16* re = pcre16_compile(
-		(PCRE_SPTR16)m_RegExp.c_str(),
-		PCRE_UTF16, &error, &erroffset, nullptr);
-	if (re != nullptr)
+	RegExpHandle re = GetRegExpCache().Get(m_RegExp);
+	if (re->IsValid())
 	{
 		// Compilation succeeded: match the subject in the second argument
 		std::wstring buffer;
@@ -661,7 +656,7 @@ void MeasureWebParser::ParseData(const BYTE* rawData, DWORD rawSize, bool utf16D
 			dataLength = (DWORD)buffer.length();
 		}
 
-		rc = pcre16_exec(re, nullptr, (PCRE_SPTR16)data, dataLength, 0, 0, ovector, OVECCOUNT);
+		rc = re->Exec(data, (int)dataLength, 0, 0, ovector, OVECCOUNT);
 		if (rc >= 0)
 		{
 			if (rc == 0)
@@ -810,14 +805,11 @@ void MeasureWebParser::ParseData(const BYTE* rawData, DWORD rawSize, bool utf16D
 			}
 			LeaveCriticalSection(&g_CriticalSection);
 		}
-
-		// Release memory used for the compiled pattern
-		pcre16_free(re);
 	}
 	else
 	{
 		// Compilation failed.
-		LogErrorF(this, L"RegExp error at offset %d: %S", erroffset, error);
+		LogErrorF(this, L"RegExp error at offset %d: %S", re->GetErrorOffset(), re->GetError());
 		doErrorAction = true;
 	}
 
@@ -32,11 +32,17 @@ public:
 
 	const WCHAR* GetStringValue() override;
 
+	// Child measures read the result of the parent measure and downloads may run FinishAction
+	bool HasSideEffects() override { return true; }
+
 protected:
 	void ReadOptions(ConfigParser& parser, const WCHAR* section) override;
 	void UpdateValue() override;
 	void Command(const std::wstring& command) override;
 
+	// Downloads are completed on another thread
+	bool HasVolatileValue() override { return true; }
+
 private:
 	static unsigned __stdcall NetworkThreadProc(void* pParam);
 	static unsigned __stdcall NetworkDownloadThreadProc(void* pParam);
@@ -28,6 +28,9 @@ protected:
 	void ReadOptions(ConfigParser& parser, const WCHAR* section) override;
 	void UpdateValue() override;
 
+	// The interface state is shared by all WifiStatus measures
+	bool HasVolatileValue() override { return true; }
+
 private:
 	enum class MeasureType : UINT
 	{
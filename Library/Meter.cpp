@@ -22,6 +22,7 @@
 #include "../Common/Gfx/Canvas.h"
 
 Meter::Meter(Skin* skin, const WCHAR* name) : Section(skin, name),
+	m_Dirty(true),
 	m_X(),
 	m_Y(),
 	m_W(0),
@@ -147,6 +148,7 @@ void Meter::SetX(int x)
 {
 	m_X = x;
 	m_RelativeX = POSITION_ABSOLUTE;
+	m_Dirty = true;
 
 	// Change the option as well to avoid reset in ReadOptions().
 	WCHAR buffer[32] = { 0 };
@@ -158,6 +160,7 @@ void Meter::SetY(int y)
 {
 	m_Y = y;
 	m_RelativeY = POSITION_ABSOLUTE;
+	m_Dirty = true;
 
 	// Change the option as well to avoid reset in ReadOptions().
 	WCHAR buffer[32] = { 0 };
@@ -283,6 +286,7 @@ void Meter::UpdateContainer()
 void Meter::Show()
 {
 	m_Hidden = false;
+	m_Dirty = true;
 
 	// Change the option as well to avoid reset in ReadOptions().
 	m_Skin->GetParser().SetValue(m_Name, L"Hidden", L"0");
@@ -303,6 +307,7 @@ void Meter::Show()
 void Meter::Hide()
 {
 	m_Hidden = true;
+	m_Dirty = true;
 
 	// Change the option as well to avoid reset in ReadOptions().
 	m_Skin->GetParser().SetValue(m_Name, L"Hidden", L"1");
@@ -331,6 +336,10 @@ void Meter::ReadOptions(ConfigParser& parser, const WCHAR* section)
 
 	BindMeasures(parser, section);
 
+	// The options or the bound measures may have changed.
+	m_MeasureGenerations.clear();
+	m_Dirty = true;
+
 	int oldX = m_X;
 	std::wstring& x = (std::wstring&)parser.ReadString(section, L"X", L"0");
 	if (!x.empty())
@@ -576,7 +585,58 @@ Meter* Meter::Create(const WCHAR* meter, Skin* skin, const WCHAR* name)
 bool Meter::Update()
 {
 	// Only update the meter's value when the divider is equal to the counter
-	return UpdateCounter();
+	if (!UpdateCounter()) return false;
+
+	if (!IsMeasureDriven() || HaveMeasuresChanged())
+	{
+		m_Dirty = true;
+	}
+
+	return true;
+}
+
+/*
+** Returns true if the value generation of any of the bound measures has changed since the last
+** call.
+**
+*/
+bool Meter::HaveMeasuresChanged()
+{
+	bool changed = m_MeasureGenerations.size() != m_Measures.size();
+	m_MeasureGenerations.resize(m_Measures.size());
+	for (size_t i = 0, isize = m_Measures.size(); i < isize; ++i)
+	{
+		const UINT generation = m_Measures[i]->GetValueGeneration();
+		if (generation != m_MeasureGenerations[i])
+		{
+			m_MeasureGenerations[i] = generation;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+/*
+** Returns the history of |measure| shared with the other meters that are updated at the same
+** rate, or a history where all values are 0 if |measure| is nullptr.
+**
+*/
+std::shared_ptr<MeasureHistory> Meter::GetMeasureHistory(Measure* measure, size_t depth)
+{
+	if (!measure)
+	{
+		// Never recorded, so it stays empty.
+		static std::shared_ptr<MeasureHistory> s_EmptyHistory = std::make_shared<MeasureHistory>();
+		return s_EmptyHistory;
+	}
+
+	return measure->GetHistory(m_UpdateDivider, depth);
+}
+
+void Meter::RecordMeasureHistory(MeasureHistory& history, Measure* measure)
+{
+	history.Record(measure->GetValue(), m_Skin->GetUpdateCounter(), this);
 }
 
 /*
@@ -26,7 +26,7 @@ public:
 
 	Meter(const Meter& other) = delete;
 
-	void ReadOptions(ConfigParser& parser) { ReadOptions(parser, GetName()); parser.ClearStyleTemplate(); }
+	void ReadOptions(ConfigParser& parser) { ReadTrackedOptions(parser); parser.ClearStyleTemplate(); }
 	void ReadContainerOptions(ConfigParser& parser) { ReadContainerOptions(parser, GetName()); parser.ClearStyleTemplate(); }
 
 	virtual void Initialize();
@@ -34,6 +34,11 @@ public:
 	virtual bool Draw(Gfx::Canvas& canvas);
 	virtual bool HasActiveTransition() { return false; }
 
+	// The meter is dirty if it may look different than when it was last drawn.
+	bool IsDirty() { return m_Dirty; }
+	void SetDirty() { m_Dirty = true; }
+	void ClearDirty() { m_Dirty = false; }
+
 	virtual int GetW() { return m_Hidden ? 0 : m_W; }
 	virtual int GetH() { return m_Hidden ? 0 : m_H; }
 	virtual int GetX(bool abs = false);
@@ -57,13 +62,15 @@ public:
 	void UpdateContainer();
 	bool HitTestContainer(int& x, int& y) { return m_ContainerMeter ? m_ContainerMeter->HitTest(x, y) : true; }
 
-	void SetW(int w) { m_W = w; }
-	void SetH(int h) { m_H = h; }
+	void SetW(int w) { m_W = w; m_Dirty = true; }
+	void SetH(int h) { m_H = h; m_Dirty = true; }
 	void SetX(int x);
 	void SetY(int y);
 
 	void SetRelativeMeter(Meter* meter) { m_RelativeMeter = meter; }
 
+	const std::vector<Measure*>& GetMeasures() { return m_Measures; }
+
 	const Mouse& GetMouse() { return m_Mouse; }
 	bool HasMouseAction() { return m_Mouse.HasButtonAction() || m_Mouse.HasScrollAction(); }
 	void DisableMouseAction(const std::wstring& options) { m_Mouse.DisableMouseAction(options); }
@@ -123,6 +130,11 @@ protected:
 
 	virtual bool IsFixedSize(bool overwrite = false) { return true; }
 
+	// Returns true if the meter only changes when its options or the values of its measures
+	// change. Such meters are not marked dirty by updates that do not change the measures.
+	virtual bool IsMeasureDriven() { return false; }
+	bool HaveMeasuresChanged();
+
 	void ReadContainerOptions(ConfigParser& parser, const WCHAR* section);
 
 	bool BindPrimaryMeasure(ConfigParser& parser, const WCHAR* section, bool optional);
@@ -130,7 +142,12 @@ protected:
 
 	bool ReplaceMeasures(std::wstring& str, AUTOSCALE autoScale = AUTOSCALE_ON, double scale = 1.0, int decimals = 0, bool percentual = false);
 
+	std::shared_ptr<MeasureHistory> GetMeasureHistory(Measure* measure, size_t depth);
+	void RecordMeasureHistory(MeasureHistory& history, Measure* measure);
+
 	std::vector<Measure*> m_Measures;
+	std::vector<UINT> m_MeasureGenerations;	// Generations of |m_Measures| at the last update
+	bool m_Dirty;
 	int m_X;
 	int m_Y;
 	int m_W;
@@ -31,6 +31,8 @@ protected:
 
 	virtual bool IsFixedSize(bool overwrite = false) { return !m_Image.IsLoaded(); }
 
+	virtual bool IsMeasureDriven() { return true; }
+
 private:
 	enum ORIENTATION
 	{
@@ -32,6 +32,8 @@ public:
 protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 
+	virtual bool IsMeasureDriven() { return true; }
+
 private:
 	GeneralImage m_Image;
 	std::wstring m_ImageName;
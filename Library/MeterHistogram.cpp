@@ -20,14 +20,13 @@ MeterHistogram::MeterHistogram(Skin* skin, const WCHAR* name) : Meter(skin, name
 	m_PrimaryColor(D2D1::ColorF(D2D1::ColorF::Green)),
 	m_SecondaryColor(D2D1::ColorF(D2D1::ColorF::Red)),
 	m_OverlapColor(D2D1::ColorF(D2D1::ColorF::Yellow)),
-	m_MeterPos(0),
 	m_Autoscale(false),
 	m_Flip(false),
 	m_PrimaryImage(L"PrimaryImage", c_PrimaryOptionArray, false, skin),
 	m_SecondaryImage(L"SecondaryImage", c_SecondaryOptionArray, false, skin),
 	m_OverlapImage(L"BothImage", c_BothOptionArray, false, skin),
-	m_PrimaryValues(nullptr),
-	m_SecondaryValues(nullptr),
+	m_PrimaryHistory(),
+	m_SecondaryHistory(),
 	m_MaxPrimaryValue(1.0),
 	m_MinPrimaryValue(0.0),
 	m_MaxSecondaryValue(1.0),
@@ -40,43 +39,40 @@ MeterHistogram::MeterHistogram(Skin* skin, const WCHAR* name) : Meter(skin, name
 
 MeterHistogram::~MeterHistogram()
 {
-	DisposeBuffer();
 }
 
 /*
-** Disposes the buffers.
+** Releases the histories.
 **
 */
-void MeterHistogram::DisposeBuffer()
+void MeterHistogram::ReleaseHistories()
 {
-	// Reset current position
-	m_MeterPos = 0;
-
-	// Delete buffers
-	delete [] m_PrimaryValues;
-	m_PrimaryValues = nullptr;
-
-	delete [] m_SecondaryValues;
-	m_SecondaryValues = nullptr;
+	m_PrimaryHistory.reset();
+	m_SecondaryHistory.reset();
 }
 
 /*
-** Creates the buffers.
+** Gets the shared histories of the measures.
 **
 */
-void MeterHistogram::CreateBuffer()
+void MeterHistogram::UpdateHistories()
 {
-	DisposeBuffer();
-
-	// Create buffers for values
 	int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
 	if (maxSize > 0)
 	{
-		m_PrimaryValues = new double[maxSize]();
+		m_PrimaryHistory = GetMeasureHistory(m_Measures.empty() ? nullptr : m_Measures[0], (size_t)maxSize);
 		if (m_Measures.size() >= 2)
 		{
-			m_SecondaryValues = new double[maxSize]();
+			m_SecondaryHistory = GetMeasureHistory(m_Measures[1], (size_t)maxSize);
 		}
+		else
+		{
+			m_SecondaryHistory.reset();
+		}
+	}
+	else
+	{
+		ReleaseHistories();
 	}
 }
 
@@ -154,12 +150,12 @@ void MeterHistogram::Initialize()
 		(!m_SecondaryImageName.empty() && !m_SecondaryImage.IsLoaded()) ||
 		(!m_OverlapImageName.empty() && !m_OverlapImage.IsLoaded()))
 	{
-		DisposeBuffer();
+		ReleaseHistories();
 		m_SizeChanged = false;
 	}
 	else if (m_SizeChanged)
 	{
-		CreateBuffer();
+		UpdateHistories();
 		m_SizeChanged = false;
 	}
 }
@@ -257,7 +253,7 @@ void MeterHistogram::ReadOptions(ConfigParser& parser, const WCHAR* section)
 			
 			if (m_SizeChanged)
 			{
-				CreateBuffer();
+				UpdateHistories();
 			}
 		}
 	}
@@ -273,22 +269,22 @@ bool MeterHistogram::Update()
 	{
 		int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
 
-		if (m_PrimaryValues && maxSize > 0)  // m_PrimaryValues must not be nullptr
+		if (m_PrimaryHistory && maxSize > 0)  // m_PrimaryHistory must not be nullptr
 		{
 			Measure* measure = m_Measures[0];
 			Measure* secondaryMeasure = (m_Measures.size() >= 2) ? m_Measures[1] : nullptr;
 
+			// The measures or update rate may have changed.
+			UpdateHistories();
+
 			// Gather values
-			m_PrimaryValues[m_MeterPos] = measure->GetValue();
+			RecordMeasureHistory(*m_PrimaryHistory, measure);
 
-			if (secondaryMeasure && m_SecondaryValues)
+			if (secondaryMeasure && m_SecondaryHistory)
 			{
-				m_SecondaryValues[m_MeterPos] = secondaryMeasure->GetValue();
+				RecordMeasureHistory(*m_SecondaryHistory, secondaryMeasure);
 			}
 
-			++m_MeterPos;
-			m_MeterPos %= maxSize;
-
 			m_MaxPrimaryValue = measure->GetMaxValue();
 			m_MinPrimaryValue = measure->GetMinValue();
 			m_MaxSecondaryValue = 0.0;
@@ -301,13 +297,8 @@ bool MeterHistogram::Update()
 
 			if (m_Autoscale)
 			{
-				// Go through all values and find the max
-
-				double newValue = 0.0;
-				for (int i = 0; i < maxSize; ++i)
-				{
-					newValue = max(newValue, m_PrimaryValues[i]);
-				}
+				// Find the max of all values
+				double newValue = max(0.0, m_PrimaryHistory->GetMax(maxSize));
 
 				// Scale the value up to nearest power of 2
 				if (newValue > DBL_MAX / 2.0)
@@ -323,12 +314,9 @@ bool MeterHistogram::Update()
 					}
 				}
 
-				if (secondaryMeasure && m_SecondaryValues)
+				if (secondaryMeasure && m_SecondaryHistory)
 				{
-					for (int i = 0; i < maxSize; ++i)
-					{
-						newValue = max(newValue, m_SecondaryValues[i]);
-					}
+					newValue = max(newValue, m_SecondaryHistory->GetMax(maxSize));
 
 					// Scale the value up to nearest power of 2
 					if (newValue > DBL_MAX / 2.0)
@@ -358,11 +346,18 @@ bool MeterHistogram::Update()
 bool MeterHistogram::Draw(Gfx::Canvas& canvas)
 {
 	if (!Meter::Draw(canvas) ||
-		(m_Measures.size() >= 1 && !m_PrimaryValues) ||
-		(m_Measures.size() >= 2 && !m_SecondaryValues)) return false;
+		(m_Measures.size() >= 1 && !m_PrimaryHistory) ||
+		(m_Measures.size() >= 2 && !m_SecondaryHistory)) return false;
+
+	const int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
+	if (!m_PrimaryHistory || maxSize <= 0) return true;
 
 	Measure* secondaryMeasure = (m_Measures.size() >= 2) ? m_Measures[1] : nullptr;
 
+	// Positions of the oldest values as if the values were in buffers of |maxSize| values.
+	const int primaryPos = (int)(m_PrimaryHistory->GetCount() % maxSize);
+	const int secondaryPos = m_SecondaryHistory ? (int)(m_SecondaryHistory->GetCount() % maxSize) : 0;
+
 	Gfx::D2DBitmap* primaryBitmap = m_PrimaryImage.GetImage();
 	Gfx::D2DBitmap* secondaryBitmap = m_SecondaryImage.GetImage();
 	Gfx::D2DBitmap* bothBitmap = m_OverlapImage.GetImage();
@@ -434,7 +429,7 @@ bool MeterHistogram::Draw(Gfx::Canvas& canvas)
 
 			double range = m_MaxPrimaryValue - m_MinPrimaryValue;
 			double value = (range < 0.0) ? 0.0 : (range == 0.0) ? 1.0 :
-				(m_PrimaryValues[(i + m_MeterPos) % displayH] - m_MinPrimaryValue) / range;
+				(m_PrimaryHistory->GetRingValue(maxSize, (i + primaryPos) % displayH) - m_MinPrimaryValue) / range;
 
 			int primaryBarHeight = (int)(displayW * value);
 			primaryBarHeight = min(displayW, primaryBarHeight);
@@ -446,7 +441,7 @@ bool MeterHistogram::Draw(Gfx::Canvas& canvas)
 			{
 				range = m_MaxSecondaryValue - m_MinSecondaryValue;
 				value = (range < 0.0) ? 0.0 : (range == 0.0) ? 1.0 :
-					(m_SecondaryValues[(i + m_MeterPos) % displayH] - m_MinSecondaryValue) / range;
+					(m_SecondaryHistory->GetRingValue(maxSize, (i + secondaryPos) % displayH) - m_MinSecondaryValue) / range;
 
 				int secondaryBarHeight = (int)(displayW * value);
 				secondaryBarHeight = min(displayW, secondaryBarHeight);
@@ -497,7 +492,7 @@ bool MeterHistogram::Draw(Gfx::Canvas& canvas)
 
 			double range = m_MaxPrimaryValue - m_MinPrimaryValue;
 			double value = (range < 0.0) ? 0.0 : (range == 0.0) ? 1.0 :
-				(m_PrimaryValues[((i + m_MeterPos) % displayW)] - m_MinPrimaryValue) / range;
+				(m_PrimaryHistory->GetRingValue(maxSize, (i + primaryPos) % displayW) - m_MinPrimaryValue) / range;
 
 			int primaryBarHeight = (int)(displayH * value);
 			primaryBarHeight = min(displayH, primaryBarHeight);
@@ -509,7 +504,7 @@ bool MeterHistogram::Draw(Gfx::Canvas& canvas)
 			{
 				range = m_MaxSecondaryValue - m_MinSecondaryValue;
 				value = (range < 0.0) ? 0.0 : (range == 0.0) ? 1.0 :
-					(m_SecondaryValues[(i + m_MeterPos) % displayW] - m_MinSecondaryValue) / range;
+					(m_SecondaryHistory->GetRingValue(maxSize, (i + secondaryPos) % displayW) - m_MinSecondaryValue) / range;
 
 				int secondaryBarHeight = (int)(displayH * value);
 				secondaryBarHeight = min(displayH, secondaryBarHeight);
@@ -33,14 +33,13 @@ protected:
 	virtual bool IsFixedSize(bool overwrite = false) { return m_PrimaryImageName.empty(); }
 
 private:
-	void DisposeBuffer();
-	void CreateBuffer();
+	void ReleaseHistories();
+	void UpdateHistories();
 
 	D2D1_COLOR_F m_PrimaryColor;
 	D2D1_COLOR_F m_SecondaryColor;
 	D2D1_COLOR_F m_OverlapColor;
 
-	int m_MeterPos;							// New value placement position
 	bool m_Autoscale;
 	bool m_Flip;
 
@@ -52,8 +51,8 @@ private:
 	GeneralImage m_SecondaryImage;
 	GeneralImage m_OverlapImage;
 
-	double* m_PrimaryValues;
-	double* m_SecondaryValues;
+	std::shared_ptr<MeasureHistory> m_PrimaryHistory;
+	std::shared_ptr<MeasureHistory> m_SecondaryHistory;
 
 	double m_MaxPrimaryValue;
 	double m_MinPrimaryValue;
@@ -20,7 +20,6 @@ MeterLine::MeterLine(Skin* skin, const WCHAR* name) : Meter(skin, name),
 	m_LineWidth(1.0),
 	m_HorizontalColor(D2D1::ColorF(D2D1::ColorF::Black)),
 	m_StrokeType(D2D1_STROKE_TRANSFORM_TYPE_NORMAL),
-	m_CurrentPos(0),
 	m_GraphStartLeft(false),
 	m_GraphHorizontalOrientation(false)
 {
@@ -31,50 +30,30 @@ MeterLine::~MeterLine()
 }
 
 /*
-** create the buffer for the lines
+** Gets the histories for the lines.
 **
 */
 void MeterLine::Initialize()
 {
 	Meter::Initialize();
 
-	size_t colorsSize = m_Colors.size();
-	size_t allValuesSize = m_AllValues.size();
-	size_t num = (allValuesSize > 0) ? m_AllValues[0].size() : 0;
-	int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
-
-	if (colorsSize != allValuesSize)
-	{
-		if (colorsSize > allValuesSize)
-		{
-			for (size_t i = allValuesSize; i < colorsSize; ++i)
-			{
-				m_AllValues.push_back(std::vector<double>());
+	UpdateHistories();
+}
 
-				if (maxSize > 0)
-				{
-					m_AllValues.back().assign(maxSize, 0.0);
-				}
-			}
-		}
-		else
-		{
-			m_AllValues.resize(colorsSize);
-		}
-	}
+/*
+** Gets the shared histories of the measures. Lines without a measure use an empty history.
+**
+*/
+void MeterLine::UpdateHistories()
+{
+	const int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
+	const size_t depth = (maxSize > 0) ? (size_t)maxSize : 0;
 
-	if (maxSize < 0 || num != (size_t)maxSize)
+	m_Histories.resize(m_Colors.size());
+	for (size_t i = 0, isize = m_Histories.size(); i < isize; ++i)
 	{
-		if (m_CurrentPos >= maxSize) m_CurrentPos = 0;
-
-		num = (maxSize < 0) ? 0 : maxSize;
-		for (size_t i = 0; i < allValuesSize; ++i)
-		{
-			if (num != m_AllValues[i].size())
-			{
-				m_AllValues[i].resize(num, 0.0);
-			}
-		}
+		Measure* measure = (i < m_Measures.size()) ? m_Measures[i] : nullptr;
+		m_Histories[i] = GetMeasureHistory(measure, depth);
 	}
 }
 
@@ -86,11 +65,6 @@ void MeterLine::ReadOptions(ConfigParser& parser, const WCHAR* section)
 {
 	WCHAR tmpName[64] = { 0 };
 
-	// Store the current number of lines so we know if the buffer needs to be updated
-	int oldLineCount = (int)m_Colors.size();
-	int oldSize = m_GraphHorizontalOrientation ? m_H : m_W;
-	bool oldGraphHorizontalOrientation = m_GraphHorizontalOrientation;
-
 	Meter::ReadOptions(parser, section);
 
 	int lineCount = parser.ReadInt(section, L"LineCount", 1);
@@ -172,13 +146,8 @@ void MeterLine::ReadOptions(ConfigParser& parser, const WCHAR* section)
 
 	if (m_Initialized)
 	{
-		int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
-		if (oldLineCount != lineCount || oldSize != maxSize || oldGraphHorizontalOrientation != m_GraphHorizontalOrientation)
-		{
-			m_AllValues.clear();
-			m_CurrentPos = 0;
-			Initialize();
-		}
+		// The measures, size or update rate may have changed.
+		UpdateHistories();
 	}
 }
 
@@ -193,15 +162,14 @@ bool MeterLine::Update()
 		int maxSize = m_GraphHorizontalOrientation ? m_H : m_W;
 		if (maxSize > 0)
 		{
-			int allValuesSize = (int)m_AllValues.size();
+			UpdateHistories();
+
+			int historiesSize = (int)m_Histories.size();
 			int counter = 0;
-			for (auto i = m_Measures.cbegin(); counter < allValuesSize && i != m_Measures.cend(); ++i, ++counter)
+			for (auto i = m_Measures.cbegin(); counter < historiesSize && i != m_Measures.cend(); ++i, ++counter)
 			{
-				m_AllValues[counter][m_CurrentPos] = (*i)->GetValue();
+				RecordMeasureHistory(*m_Histories[counter], *i);
 			}
-
-			++m_CurrentPos;
-			m_CurrentPos %= maxSize;
 		}
 		return true;
 	}
@@ -226,14 +194,11 @@ bool MeterLine::Draw(Gfx::Canvas& canvas)
 	{
 		double newValue = 0.0;
 		int counter = 0;
-		for (auto i = m_AllValues.cbegin(); i != m_AllValues.cend(); ++i)
+		for (auto i = m_Histories.cbegin(); i != m_Histories.cend(); ++i)
 		{
 			double scale = m_ScaleValues[counter];
-			for (auto j = (*i).cbegin(); j != (*i).cend(); ++j)
-			{
-				double val = (*j) * scale;
-				newValue = max(newValue, val);
-			}
+			double val = (scale >= 0.0 ? (*i)->GetMax(maxSize) : (*i)->GetMin(maxSize)) * scale;
+			newValue = max(newValue, val);
 			++counter;
 		}
 
@@ -321,10 +286,10 @@ bool MeterLine::Draw(Gfx::Canvas& canvas)
 	{
 		const FLOAT W = (FLOAT)(drawW - 1);
 		int counter = 0;
-		for (auto i = m_AllValues.cbegin(); i != m_AllValues.cend(); ++i)
+		for (auto i = m_Histories.cbegin(); i != m_Histories.cend(); ++i)
 		{
 			const double scale = (m_ScaleValues[counter] * W) / range;
-			int pos = m_CurrentPos;
+			int pos = (int)((*i)->GetCount() % maxSize);
 
 			auto calcX = [&](FLOAT& _x)
 			{
@@ -338,7 +303,7 @@ bool MeterLine::Draw(Gfx::Canvas& canvas)
 				}
 				else
 				{
-					_x = ((FLOAT)(((*i)[pos] - minValue) * scale) + offset);
+					_x = ((FLOAT)(((*i)->GetRingValue(maxSize, pos) - minValue) * scale) + offset);
 					_x = min(_x, W + offset);
 					_x = max(_x, offset);
 				}
@@ -394,10 +359,10 @@ bool MeterLine::Draw(Gfx::Canvas& canvas)
 	{
 		const FLOAT H = (FLOAT)(drawH - 1);
 		int counter = 0;
-		for (auto i = m_AllValues.cbegin(); i != m_AllValues.cend(); ++i)
+		for (auto i = m_Histories.cbegin(); i != m_Histories.cend(); ++i)
 		{
 			const double scale = (m_ScaleValues[counter] * H) / range;
-			int pos = m_CurrentPos;
+			int pos = (int)((*i)->GetCount() % maxSize);
 
 			auto calcY = [&](FLOAT& _y)
 			{
@@ -411,7 +376,7 @@ bool MeterLine::Draw(Gfx::Canvas& canvas)
 				}
 				else
 				{
-					_y = ((FLOAT)(((*i)[pos] - minValue) * scale) + offset);
+					_y = ((FLOAT)(((*i)->GetRingValue(maxSize, pos) - minValue) * scale) + offset);
 					_y = min(_y, H + offset);
 					_y = max(_y, offset);
 				}
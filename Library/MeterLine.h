@@ -30,6 +30,8 @@ protected:
 	virtual void BindMeasures(ConfigParser& parser, const WCHAR* section);
 
 private:
+	void UpdateHistories();
+
 	std::vector<D2D1_COLOR_F> m_Colors;
 	std::vector<double> m_ScaleValues;
 
@@ -40,8 +42,7 @@ private:
 	D2D1_COLOR_F m_HorizontalColor;
 	D2D1_STROKE_TRANSFORM_TYPE m_StrokeType;
 
-	std::vector<std::vector<double>> m_AllValues;
-	int m_CurrentPos;
+	std::vector<std::shared_ptr<MeasureHistory>> m_Histories;	// For each line
 
 	bool m_GraphStartLeft;
 	bool m_GraphHorizontalOrientation;
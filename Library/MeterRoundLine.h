@@ -28,6 +28,8 @@ protected:
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
 	virtual void BindMeasures(ConfigParser& parser, const WCHAR* section);
 
+	virtual bool IsMeasureDriven() { return true; }
+
 private:
 	bool m_Solid;
 	double m_LineWidth;
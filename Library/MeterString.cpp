@@ -322,6 +322,9 @@ bool MeterString::Update()
 {
 	if (Meter::Update())
 	{
+		// The text only changes with the options and the measures.
+		if (!IsDirty()) return true;
+
 		int decimals = (m_NumOfDecimals != -1) ? m_NumOfDecimals : (m_NoDecimals && (m_Percentual || m_AutoScale == AUTOSCALE_OFF)) ? 0 : 1;
 
 		// Create the text
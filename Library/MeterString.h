@@ -39,6 +39,8 @@ protected:
 
 	virtual bool IsFixedSize(bool overwrite = false) { return overwrite; }
 
+	virtual bool IsMeasureDriven() { return true; }
+
 private:
 	enum TEXTSTYLE
 	{
@@ -0,0 +1,212 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "OptionStore.h"
+
+const UINT OptionStore::c_InvalidId;
+
+void OptionStore::Clear()
+{
+	m_Sections.Clear();
+	m_Keys.Clear();
+	m_Slots.clear();
+	m_Values.clear();
+	m_Count = 0;
+}
+
+const std::wstring* OptionStore::GetValue(UINT section, UINT key) const
+{
+	if (section == c_InvalidId || key == c_InvalidId) return nullptr;
+
+	const UINT index = FindValue(MakeKey(section, key));
+	if (index == c_InvalidId || !m_Values[index].isSet) return nullptr;
+
+	return &m_Values[index].value;
+}
+
+void OptionStore::SetValue(const std::wstring& section, const std::wstring& key, const std::wstring& value)
+{
+	const uint64_t id = MakeKey(
+		m_Sections.Add(section.c_str(), section.length()),
+		m_Keys.Add(key.c_str(), key.length()));
+
+	UINT index = FindValue(id);
+	if (index == c_InvalidId)
+	{
+		// Keep the load factor at or below 1/2.
+		if ((m_Values.size() + 1) * 2 > m_Slots.size())
+		{
+			Rehash(m_Slots.empty() ? 64 : m_Slots.size() * 2);
+		}
+
+		index = (UINT)m_Values.size();
+		m_Values.emplace_back();
+		m_Values.back().id = id;
+
+		const size_t mask = m_Slots.size() - 1;
+		size_t i = Hash(id) & mask;
+		while (m_Slots[i].index != c_InvalidId)
+		{
+			i = (i + 1) & mask;
+		}
+
+		m_Slots[i].key = id;
+		m_Slots[i].index = index;
+	}
+
+	Value& entry = m_Values[index];
+	if (!entry.isSet)
+	{
+		entry.isSet = true;
+		++m_Count;
+	}
+	entry.value = value;
+}
+
+void OptionStore::DeleteValue(const std::wstring& section, const std::wstring& key)
+{
+	const UINT index = FindValue(MakeKey(
+		m_Sections.Find(section.c_str(), section.length()),
+		m_Keys.Find(key.c_str(), key.length())));
+	if (index != c_InvalidId && m_Values[index].isSet)
+	{
+		m_Values[index].isSet = false;
+		m_Values[index].value.clear();
+		--m_Count;
+	}
+}
+
+size_t OptionStore::Hash(uint64_t key)
+{
+	// Fibonacci hashing spreads the consecutive section and key ids.
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (size_t)(key ^ (key >> 32));
+}
+
+UINT OptionStore::FindValue(uint64_t key) const
+{
+	if (m_Slots.empty()) return c_InvalidId;
+
+	const size_t mask = m_Slots.size() - 1;
+	for (size_t i = Hash(key) & mask; m_Slots[i].index != c_InvalidId; i = (i + 1) & mask)
+	{
+		if (m_Slots[i].key == key)
+		{
+			return m_Slots[i].index;
+		}
+	}
+
+	return c_InvalidId;
+}
+
+void OptionStore::Rehash(size_t size)
+{
+	const Slot empty = { 0, c_InvalidId };
+	std::vector<Slot> slots(size, empty);
+	slots.swap(m_Slots);
+
+	const size_t mask = m_Slots.size() - 1;
+	for (const auto& slot : slots)
+	{
+		if (slot.index == c_InvalidId) continue;
+
+		size_t i = Hash(slot.key) & mask;
+		while (m_Slots[i].index != c_InvalidId)
+		{
+			i = (i + 1) & mask;
+		}
+		m_Slots[i] = slot;
+	}
+}
+
+void OptionStore::NameTable::Clear()
+{
+	m_Entries.clear();
+	m_Names.clear();
+}
+
+UINT OptionStore::NameTable::Add(const WCHAR* name, size_t length)
+{
+	const size_t hash = Hash(name, length);
+	UINT id = Find(name, length, hash);
+	if (id != c_InvalidId) return id;
+
+	// Keep the load factor at or below 1/2.
+	if ((m_Names.size() + 1) * 2 > m_Entries.size())
+	{
+		std::vector<Entry> entries(m_Entries.empty() ? 64 : m_Entries.size() * 2, Entry());
+		entries.swap(m_Entries);
+		for (const auto& entry : entries)
+		{
+			if (entry.id != 0U)
+			{
+				Insert(entry.hash, entry.id - 1U);
+			}
+		}
+	}
+
+	id = (UINT)m_Names.size();
+	m_Names.emplace_back(name, length);
+	for (auto& ch : m_Names.back())
+	{
+		ch = (WCHAR)towupper(ch);
+	}
+
+	Insert(hash, id);
+	return id;
+}
+
+size_t OptionStore::NameTable::Hash(const WCHAR* name, size_t length)
+{
+	// FNV-1a of the uppercase characters
+	size_t hash = 2166136261U;
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= (size_t)towupper(name[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+UINT OptionStore::NameTable::Find(const WCHAR* name, size_t length, size_t hash) const
+{
+	if (m_Entries.empty()) return c_InvalidId;
+
+	// Entry ids are offset by one so that a zeroed entry is empty.
+	const size_t mask = m_Entries.size() - 1;
+	for (size_t i = hash & mask; m_Entries[i].id != 0U; i = (i + 1) & mask)
+	{
+		const Entry& entry = m_Entries[i];
+		if (entry.hash != hash) continue;
+
+		const std::wstring& folded = m_Names[entry.id - 1U];
+		if (folded.length() != length) continue;
+
+		size_t j = 0;
+		while (j < length && (WCHAR)towupper(name[j]) == folded[j]) ++j;
+		if (j == length)
+		{
+			return entry.id - 1U;
+		}
+	}
+
+	return c_InvalidId;
+}
+
+void OptionStore::NameTable::Insert(size_t hash, UINT id)
+{
+	const size_t mask = m_Entries.size() - 1;
+	size_t i = hash & mask;
+	while (m_Entries[i].id != 0U)
+	{
+		i = (i + 1) & mask;
+	}
+
+	m_Entries[i].hash = hash;
+	m_Entries[i].id = id + 1U;
+}
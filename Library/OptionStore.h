@@ -0,0 +1,110 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __OPTIONSTORE_H__
+#define __OPTIONSTORE_H__
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Stores the values of the options of a skin by section and key. Section and key names are
+// compared case-insensitively and interned as ids so that a value is found with a single probe of
+// a flat table. Lookups of existing values do not allocate.
+class OptionStore
+{
+public:
+	static const UINT c_InvalidId = (UINT)-1;
+
+	OptionStore() : m_Count() {}
+
+	OptionStore(const OptionStore& other) = delete;
+	OptionStore& operator=(OptionStore other) = delete;
+
+	void Clear();
+
+	// Returns c_InvalidId if no value has been set for a section or key with the given name.
+	UINT FindSection(const WCHAR* name, size_t length) const { return m_Sections.Find(name, length); }
+	UINT FindSection(const std::wstring& name) const { return m_Sections.Find(name.c_str(), name.length()); }
+	UINT FindKey(const WCHAR* name, size_t length) const { return m_Keys.Find(name, length); }
+	UINT FindKey(const std::wstring& name) const { return m_Keys.Find(name.c_str(), name.length()); }
+
+	UINT AddSection(const WCHAR* name, size_t length) { return m_Sections.Add(name, length); }
+	UINT AddKey(const WCHAR* name, size_t length) { return m_Keys.Add(name, length); }
+
+	// Returns nullptr if the value is not set.
+	const std::wstring* GetValue(UINT section, UINT key) const;
+	void SetValue(const std::wstring& section, const std::wstring& key, const std::wstring& value);
+	void DeleteValue(const std::wstring& section, const std::wstring& key);
+
+	size_t GetCount() const { return m_Count; }
+
+	// Calls |func(section, key, value)| for each set value in insertion order. Names are uppercase.
+	template<typename Func>
+	void ForEachValue(Func func) const
+	{
+		for (const auto& value : m_Values)
+		{
+			if (!value.isSet) continue;
+			func(m_Sections.GetName((UINT)(value.id >> 32)), m_Keys.GetName((UINT)value.id), value.value);
+		}
+	}
+
+private:
+	// Interns case-folded names. The ids are indices into |m_Names|.
+	class NameTable
+	{
+	public:
+		void Clear();
+		UINT Find(const WCHAR* name, size_t length) const { return Find(name, length, Hash(name, length)); }
+		UINT Add(const WCHAR* name, size_t length);
+		const std::wstring& GetName(UINT id) const { return m_Names[id]; }
+
+	private:
+		static size_t Hash(const WCHAR* name, size_t length);
+		UINT Find(const WCHAR* name, size_t length, size_t hash) const;
+		void Insert(size_t hash, UINT id);
+
+		struct Entry
+		{
+			size_t hash;
+			UINT id;	// Index into |m_Names| plus one, or 0 if the entry is empty
+		};
+
+		std::vector<Entry> m_Entries;		// Open addressing with linear probing; size is a power of 2
+		std::vector<std::wstring> m_Names;	// Uppercase
+	};
+
+	struct Slot
+	{
+		uint64_t key;	// Section id in the high part, key id in the low part
+		UINT index;		// Index into |m_Values| or c_InvalidId if the slot is empty
+	};
+
+	struct Value
+	{
+		std::wstring value;
+		uint64_t id;
+		bool isSet;		// Deleted values keep their slot
+	};
+
+	static uint64_t MakeKey(UINT section, UINT key) { return ((uint64_t)section << 32) | key; }
+	static size_t Hash(uint64_t key);
+
+	UINT FindValue(uint64_t key) const;
+	void Rehash(size_t size);
+
+	NameTable m_Sections;
+	NameTable m_Keys;
+
+	std::vector<Slot> m_Slots;		// Open addressing with linear probing; size is a power of 2
+	std::vector<Value> m_Values;	// Stored contiguously in insertion order
+	size_t m_Count;					// Number of set values
+};
+
+#endif
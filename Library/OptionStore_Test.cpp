@@ -0,0 +1,94 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "OptionStore.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_OptionStore_Test)
+{
+public:
+	static const std::wstring* Get(const OptionStore& store, const std::wstring& section, const std::wstring& key)
+	{
+		return store.GetValue(store.FindSection(section), store.FindKey(key));
+	}
+
+	TEST_METHOD(TestValues)
+	{
+		OptionStore store;
+		Assert::IsNull(Get(store, L"Meter", L"Text"));
+		Assert::AreEqual(OptionStore::c_InvalidId, store.FindSection(L"Meter"));
+
+		store.SetValue(L"Meter", L"Text", L"abc");
+		store.SetValue(L"Meter", L"X", L"10");
+		store.SetValue(L"Measure", L"Text", L"def");
+		Assert::AreEqual((size_t)3, store.GetCount());
+
+		// Names are case-insensitive.
+		Assert::AreEqual(L"abc", Get(store, L"METER", L"text")->c_str());
+		Assert::AreEqual(L"10", Get(store, L"meter", L"x")->c_str());
+		Assert::AreEqual(L"def", Get(store, L"Measure", L"Text")->c_str());
+		Assert::IsNull(Get(store, L"Measure", L"X"));
+
+		store.SetValue(L"meter", L"TEXT", L"ghi");
+		Assert::AreEqual(L"ghi", Get(store, L"Meter", L"Text")->c_str());
+		Assert::AreEqual((size_t)3, store.GetCount());
+
+		store.DeleteValue(L"Meter", L"Text");
+		store.DeleteValue(L"Meter", L"NA");
+		Assert::IsNull(Get(store, L"Meter", L"Text"));
+		Assert::AreEqual((size_t)2, store.GetCount());
+
+		store.SetValue(L"Meter", L"Text", L"jkl");
+		Assert::AreEqual(L"jkl", Get(store, L"Meter", L"Text")->c_str());
+
+		store.Clear();
+		Assert::IsNull(Get(store, L"Meter", L"Text"));
+		Assert::AreEqual((size_t)0, store.GetCount());
+	}
+
+	TEST_METHOD(TestForEachValue)
+	{
+		OptionStore store;
+		store.SetValue(L"Meter", L"Text", L"abc");
+		store.SetValue(L"Meter", L"X", L"10");
+		store.SetValue(L"Measure", L"Text", L"def");
+		store.DeleteValue(L"Meter", L"X");
+
+		std::wstring result;
+		store.ForEachValue([&](const std::wstring& section, const std::wstring& key, const std::wstring& value)
+		{
+			result += section + L'|' + key + L'|' + value + L';';
+		});
+		Assert::AreEqual(L"METER|TEXT|abc;MEASURE|TEXT|def;", result.c_str());
+	}
+
+	TEST_METHOD(TestGrowth)
+	{
+		OptionStore store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			const std::wstring section = L"Section" + std::to_wstring(i);
+			for (int j = 0; j < 10; ++j)
+			{
+				store.SetValue(section, L"Key" + std::to_wstring(j), std::to_wstring(i * j));
+			}
+		}
+
+		Assert::AreEqual((size_t)10000, store.GetCount());
+		for (int i = 0; i < 1000; ++i)
+		{
+			const std::wstring section = L"SECTION" + std::to_wstring(i);
+			for (int j = 0; j < 10; ++j)
+			{
+				const std::wstring* value = Get(store, section, L"KEY" + std::to_wstring(j));
+				Assert::IsNotNull(value);
+				Assert::AreEqual(std::to_wstring(i * j).c_str(), value->c_str());
+			}
+		}
+	}
+};
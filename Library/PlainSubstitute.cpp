@@ -0,0 +1,296 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "PlainSubstitute.h"
+
+namespace {
+
+const UINT c_None = (UINT)-1;
+const UINT c_Free = (UINT)-1;
+const UINT c_Covered = (UINT)-2;
+
+// Returns true if |pattern| could match text that includes |replacement| after it has replaced
+// something.
+bool CanMatchReplacement(const std::wstring& pattern, const std::wstring& replacement)
+{
+	// The pattern could match across the text on both sides of removed text.
+	if (replacement.empty()) return pattern.length() > 1;
+
+	if (pattern.find(replacement) != std::wstring::npos ||
+		replacement.find(pattern) != std::wstring::npos)
+	{
+		return true;
+	}
+
+	// The pattern could start before or end after the replacement.
+	const size_t patternLen = pattern.length();
+	const size_t replacementLen = replacement.length();
+	for (size_t n = 1, nsize = min(patternLen, replacementLen); n < nsize; ++n)
+	{
+		if (pattern.compare(patternLen - n, n, replacement, 0, n) == 0 ||
+			replacement.compare(replacementLen - n, n, pattern, 0, n) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}  // namespace
+
+PlainSubstitute::PlainSubstitute()
+{
+}
+
+void PlainSubstitute::Clear()
+{
+	m_Pairs.clear();
+	m_Stages.clear();
+}
+
+/*
+** Splits the pairs into stages. A pair can be applied in the same pass as the preceding pairs of
+** the stage if its pattern cannot match any text that includes their replacements.
+**
+*/
+void PlainSubstitute::Compile(const std::vector<std::wstring>& substitute)
+{
+	Clear();
+
+	for (size_t i = 0, isize = substitute.size(); i + 1 < isize; i += 2)
+	{
+		Pair pair = { substitute[i], substitute[i + 1] };
+		m_Pairs.push_back(std::move(pair));
+	}
+
+	UINT begin = 0U;
+	for (UINT i = 1U, isize = (UINT)m_Pairs.size(); i < isize; ++i)
+	{
+		const std::wstring& pattern = m_Pairs[i].pattern;
+
+		// An empty pattern replaces an empty string, so it is always in a stage of its own.
+		bool split = pattern.empty() || m_Pairs[begin].pattern.empty();
+		for (UINT j = begin; !split && j < i; ++j)
+		{
+			split = CanMatchReplacement(pattern, m_Pairs[j].replacement);
+		}
+
+		if (split)
+		{
+			AddStage(begin, i);
+			begin = i;
+		}
+	}
+
+	if (begin < (UINT)m_Pairs.size())
+	{
+		AddStage(begin, (UINT)m_Pairs.size());
+	}
+}
+
+void PlainSubstitute::AddStage(UINT begin, UINT end)
+{
+	m_Stages.emplace_back();
+	Stage& stage = m_Stages.back();
+	stage.begin = begin;
+	stage.end = end;
+
+	// Build the trie of the patterns.
+	std::vector<std::map<WCHAR, UINT>> children(1);
+	Node root = { 0U, 0U, 0U, 0U, c_None, 0U };
+	stage.nodes.push_back(root);
+	for (UINT i = begin; i < end; ++i)
+	{
+		UINT node = 0U;
+		for (WCHAR ch : m_Pairs[i].pattern)
+		{
+			auto iter = children[node].find(ch);
+			if (iter == children[node].end())
+			{
+				const UINT child = (UINT)stage.nodes.size();
+				Node newNode = { 0U, 0U, 0U, 0U, c_None, stage.nodes[node].depth + 1U };
+				stage.nodes.push_back(newNode);
+				children.emplace_back();
+				iter = children[node].emplace(ch, child).first;
+			}
+			node = iter->second;
+		}
+
+		// If the same pattern is used twice, the first pair replaces all occurrences.
+		if (stage.nodes[node].pair == c_None)
+		{
+			stage.nodes[node].pair = i;
+		}
+	}
+
+	// Set the failure and output links in breadth-first order.
+	std::vector<UINT> queue(1, 0U);
+	for (size_t q = 0; q < queue.size(); ++q)
+	{
+		const UINT parent = queue[q];
+		Node& node = stage.nodes[parent];
+		node.edgeBegin = (UINT)stage.edges.size();
+		for (const auto& child : children[parent])
+		{
+			UINT fail = 0U;
+			if (parent != 0U)
+			{
+				fail = stage.nodes[parent].fail;
+				while (true)
+				{
+					auto iter = children[fail].find(child.first);
+					if (iter != children[fail].end())
+					{
+						fail = iter->second;
+						break;
+					}
+					if (fail == 0U) break;
+					fail = stage.nodes[fail].fail;
+				}
+			}
+
+			Node& childNode = stage.nodes[child.second];
+			childNode.fail = fail;
+			childNode.output = (childNode.pair != c_None) ? child.second : stage.nodes[fail].output;
+
+			Edge edge = { child.first, child.second };
+			stage.edges.push_back(edge);
+			queue.push_back(child.second);
+		}
+		stage.nodes[parent].edgeEnd = (UINT)stage.edges.size();
+	}
+}
+
+UINT PlainSubstitute::FindEdge(const Stage& stage, const Node& node, WCHAR ch)
+{
+	auto first = stage.edges.begin() + node.edgeBegin;
+	auto last = stage.edges.begin() + node.edgeEnd;
+	auto iter = std::lower_bound(first, last, ch, [](const Edge& edge, WCHAR ch) { return edge.ch < ch; });
+	return (iter != last && iter->ch == ch) ? iter->node : 0U;
+}
+
+void PlainSubstitute::Apply(std::wstring& str) const
+{
+	for (const auto& stage : m_Stages)
+	{
+		const Pair& first = m_Pairs[stage.begin];
+		if (first.pattern.empty())
+		{
+			// Empty result and empty substitute -> use second
+			if (str.empty())
+			{
+				str = first.replacement;
+			}
+		}
+		else
+		{
+			ApplyStage(stage, str);
+		}
+	}
+}
+
+/*
+** Finds all occurrences of the patterns of the stage and then picks them in the order the pairs
+** would be applied one after another: the leftmost non-overlapping occurrences of the first pair,
+** then those of the second pair that do not overlap any picked occurrence, and so on.
+**
+*/
+void PlainSubstitute::ApplyStage(const Stage& stage, std::wstring& str) const
+{
+	const WCHAR* text = str.c_str();
+	const UINT length = (UINT)str.length();
+
+	// Occurrences as (pair, position) in the order of their end position.
+	std::vector<std::pair<UINT, UINT>> found;
+	bool overlap = false;
+	UINT lastEnd = 0U;
+	UINT state = 0U;
+	for (UINT pos = 0U; pos < length; ++pos)
+	{
+		const WCHAR ch = text[pos];
+		while (true)
+		{
+			const UINT next = FindEdge(stage, stage.nodes[state], ch);
+			if (next != 0U || state == 0U)
+			{
+				state = next;
+				break;
+			}
+			state = stage.nodes[state].fail;
+		}
+
+		for (UINT node = stage.nodes[state].output; node != 0U; node = stage.nodes[stage.nodes[node].fail].output)
+		{
+			const UINT start = pos + 1U - stage.nodes[node].depth;
+			overlap |= start < lastEnd;
+			lastEnd = pos + 1U;
+			found.emplace_back(stage.nodes[node].pair, start);
+		}
+	}
+
+	if (found.empty()) return;
+
+	std::wstring result;
+	result.reserve(length);
+
+	if (!overlap)
+	{
+		// No occurrence overlaps another so all of them are replaced.
+		UINT pos = 0U;
+		for (const auto& item : found)
+		{
+			const Pair& pair = m_Pairs[item.first];
+			result.append(text + pos, item.second - pos);
+			result += pair.replacement;
+			pos = item.second + (UINT)pair.pattern.length();
+		}
+		result.append(text + pos, length - pos);
+		str.swap(result);
+		return;
+	}
+
+	std::sort(found.begin(), found.end());
+
+	// For each character, c_Free, c_Covered or the pair that replaces the text starting there.
+	std::vector<UINT> owner(length, c_Free);
+	for (const auto& item : found)
+	{
+		const UINT pos = item.second;
+		const UINT end = pos + (UINT)m_Pairs[item.first].pattern.length();
+
+		UINT i = pos;
+		while (i < end && owner[i] == c_Free) ++i;
+		if (i != end) continue;
+
+		owner[pos] = item.first;
+		for (i = pos + 1U; i < end; ++i)
+		{
+			owner[i] = c_Covered;
+		}
+	}
+
+	for (UINT pos = 0U; pos < length; )
+	{
+		const UINT index = owner[pos];
+		if (index == c_Free)
+		{
+			const UINT start = pos;
+			while (++pos < length && owner[pos] == c_Free);
+			result.append(text + start, pos - start);
+		}
+		else
+		{
+			const Pair& pair = m_Pairs[index];
+			result += pair.replacement;
+			pos += (UINT)pair.pattern.length();
+		}
+	}
+
+	str.swap(result);
+}
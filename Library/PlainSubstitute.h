@@ -0,0 +1,76 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __PLAINSUBSTITUTE_H__
+#define __PLAINSUBSTITUTE_H__
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+// Applies a list of plain (non-regex) Substitute pairs. The result is the same as replacing all
+// occurrences of each pair in turn, but consecutive pairs that cannot match each other's
+// replacements are applied together in a single pass over the string.
+class PlainSubstitute
+{
+public:
+	PlainSubstitute();
+
+	PlainSubstitute(const PlainSubstitute& other) = delete;
+	PlainSubstitute& operator=(PlainSubstitute other) = delete;
+
+	// |substitute| contains the patterns and replacements in alternating order.
+	void Compile(const std::vector<std::wstring>& substitute);
+	void Clear();
+
+	bool IsEmpty() const { return m_Pairs.empty(); }
+
+	void Apply(std::wstring& str) const;
+
+private:
+	struct Pair
+	{
+		std::wstring pattern;
+		std::wstring replacement;
+	};
+
+	struct Node
+	{
+		UINT edgeBegin;		// Range of Stage::edges
+		UINT edgeEnd;
+		UINT fail;			// Node of the longest proper suffix
+		UINT output;		// Nearest node (this or via |fail|) where a pattern ends, or 0
+		UINT pair;			// Pair whose pattern ends here
+		UINT depth;
+	};
+
+	struct Edge
+	{
+		WCHAR ch;
+		UINT node;
+	};
+
+	// Pairs in the range [begin, end) applied in one pass using an Aho-Corasick automaton of
+	// their patterns. The first node is the root.
+	struct Stage
+	{
+		UINT begin;
+		UINT end;
+		std::vector<Node> nodes;
+		std::vector<Edge> edges;	// Sorted by character for each node
+	};
+
+	void AddStage(UINT begin, UINT end);
+	void ApplyStage(const Stage& stage, std::wstring& str) const;
+
+	static UINT FindEdge(const Stage& stage, const Node& node, WCHAR ch);
+
+	std::vector<Pair> m_Pairs;
+	std::vector<Stage> m_Stages;
+};
+
+#endif
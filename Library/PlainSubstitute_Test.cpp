@@ -0,0 +1,156 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "PlainSubstitute.h"
+#include "../Common/Timer.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_PlainSubstitute_Test)
+{
+public:
+	// Applies the pairs one after another like Measure did before PlainSubstitute.
+	static void ApplySequential(const std::vector<std::wstring>& substitute, std::wstring& str)
+	{
+		for (size_t i = 0, isize = substitute.size(); i < isize; i += 2)
+		{
+			if (!substitute[i].empty())
+			{
+				size_t start = 0, pos;
+				while ((pos = str.find(substitute[i], start)) != std::wstring::npos)
+				{
+					str.replace(pos, substitute[i].length(), substitute[i + 1]);
+					start = pos + substitute[i + 1].length();
+				}
+			}
+			else if (str.empty())
+			{
+				str = substitute[i + 1];
+			}
+		}
+	}
+
+	static std::wstring Apply(const std::vector<std::wstring>& substitute, const WCHAR* str)
+	{
+		PlainSubstitute plain;
+		plain.Compile(substitute);
+		std::wstring result = str;
+		plain.Apply(result);
+		return result;
+	}
+
+	TEST_METHOD(TestApply)
+	{
+		Assert::AreEqual(L"xbcx", Apply({ L"a", L"x" }, L"abca").c_str());
+		Assert::AreEqual(L"empty", Apply({ L"a", L"x", L"", L"empty" }, L"").c_str());
+		Assert::AreEqual(L"a", Apply({ L"", L"empty" }, L"a").c_str());
+
+		// Earlier pairs take precedence over later ones.
+		Assert::AreEqual(L"storm0", Apply({ L"1", L"storm", L"10", L"wind" }, L"10").c_str());
+		Assert::AreEqual(L"1tornado", Apply({ L"0", L"tornado", L"10", L"wind" }, L"10").c_str());
+
+		// Later pairs see the replacements of earlier pairs.
+		Assert::AreEqual(L"Z", Apply({ L"a", L"x", L"xb", L"Z" }, L"ab").c_str());
+		Assert::AreEqual(L"Z", Apply({ L"a", L"", L"xy", L"Z" }, L"xay").c_str());
+		Assert::AreEqual(L"c", Apply({ L"a", L"b", L"b", L"c" }, L"a").c_str());
+
+		// Overlapping occurrences are replaced from the left.
+		Assert::AreEqual(L"xxa", Apply({ L"aa", L"x" }, L"aaaaa").c_str());
+		Assert::AreEqual(L"xbc", Apply({ L"ab", L"x", L"abc", L"y" }, L"abbc").c_str());
+	}
+
+	TEST_METHOD(TestSequential)
+	{
+		// Compare against the pairs applied one after another with small alphabets so that
+		// patterns often overlap each other and the replacements.
+		const WCHAR* alphabets[] = { L"ab", L"abc", L"abcdefgh" };
+
+		UINT seed = 1U;
+		auto random = [&](UINT n)
+		{
+			seed = seed * 1103515245U + 12345U;
+			return (seed >> 16) % n;
+		};
+
+		auto randomString = [&](const WCHAR* alphabet, UINT maxLength)
+		{
+			std::wstring str;
+			const UINT size = (UINT)wcslen(alphabet);
+			for (UINT i = 0, length = random(maxLength + 1U); i < length; ++i)
+			{
+				str += alphabet[random(size)];
+			}
+			return str;
+		};
+
+		for (int n = 0; n < 20000; ++n)
+		{
+			const WCHAR* alphabet = alphabets[n % _countof(alphabets)];
+
+			std::vector<std::wstring> substitute;
+			for (UINT i = 0, count = 1U + random(6U); i < count; ++i)
+			{
+				substitute.push_back(randomString(alphabet, 3U));
+				substitute.push_back(randomString(alphabet, 3U));
+			}
+
+			const std::wstring str = randomString(alphabet, 12U);
+			std::wstring expected = str;
+			ApplySequential(substitute, expected);
+			Assert::AreEqual(expected.c_str(), Apply(substitute, str.c_str()).c_str());
+		}
+	}
+
+	TEST_METHOD(TestBenchmark)
+	{
+		// Typical mapping of weather codes to icons.
+		const WCHAR* icons[] = { L"Tornado", L"Storm", L"Thunder", L"Snow", L"Rain", L"Sleet", L"Fog", L"Cloudy" };
+		std::vector<std::wstring> substitute;
+		for (int i = 0; i < 48; ++i)
+		{
+			substitute.push_back(L"Code" + std::to_wstring(i) + L";");
+			substitute.push_back(std::wstring(icons[i % _countof(icons)]) + L".png|");
+		}
+
+		std::wstring str;
+		for (int i = 0; i < 200; ++i)
+		{
+			str += L"Code" + std::to_wstring(i % 50) + L"; ";
+		}
+
+		PlainSubstitute plain;
+		plain.Compile(substitute);
+
+		const int iterations = 1000;
+
+		std::wstring expected;
+		Timer timer;
+		timer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			expected = str;
+			ApplySequential(substitute, expected);
+		}
+		timer.Stop();
+		const double sequential = timer.GetElapsed() / iterations;
+
+		std::wstring result;
+		timer.Start();
+		for (int n = 0; n < iterations; ++n)
+		{
+			result = str;
+			plain.Apply(result);
+		}
+		timer.Stop();
+		Assert::AreEqual(expected.c_str(), result.c_str());
+
+		WCHAR buffer[128];
+		_snwprintf_s(buffer, _TRUNCATE, L"Substitute (48 pairs, %d characters): %.3f ms sequential, %.3f ms single pass\n",
+			(int)str.length(), sequential, timer.GetElapsed() / iterations);
+		Logger::WriteMessage(buffer);
+	}
+};
@@ -11,6 +11,7 @@
 #include "../Common/PathUtil.h"
 #include "../Common/Platform.h"
 #include "Rainmeter.h"
+#include "ConfigCache.h"
 #include "TrayIcon.h"
 #include "System.h"
 #include "DialogAbout.h"
@@ -27,13 +28,40 @@ using namespace Gdiplus;
 
 enum TIMER
 {
-	TIMER_NETSTATS    = 1
+	TIMER_NETSTATS    = 1,
+	TIMER_SCHEDULE    = 2,
+	TIMER_UPDATE      = 3
 };
 enum INTERVAL
 {
 	INTERVAL_NETSTATS = 120000
 };
 
+namespace {
+
+/*
+** Sets the timer |id| to fire at the GetTickCount64() time |due| unless it is already set for it.
+** |timerDue| is the time the timer is currently set for.
+**
+*/
+void SetTimerForDue(HWND window, UINT_PTR id, uint64_t due, uint64_t& timerDue)
+{
+	if (due == timerDue) return;
+
+	timerDue = due;
+	if (due == (uint64_t)-1)
+	{
+		KillTimer(window, id);
+		return;
+	}
+
+	const uint64_t now = GetTickCount64();
+	const UINT elapse = (due > now) ? (UINT)min(due - now, (uint64_t)USER_TIMER_MAXIMUM) : USER_TIMER_MINIMUM;
+	SetTimer(window, id, elapse, nullptr);
+}
+
+}  // namespace
+
 /*
 ** Initializes Rainmeter.
 **
@@ -111,6 +139,8 @@ Rainmeter::Rainmeter() :
 	m_DisableRDP(false),
 	m_DisableDragging(false),
 	m_CurrentParser(),
+	m_ScheduleTimerDue(TimerWheel::c_NoTimer),
+	m_UpdateTimerDue(UpdateScheduler::c_NoUpdate),
 	m_Window(),
 	m_Mutex(),
 	m_Instance(),
@@ -563,6 +593,8 @@ int Rainmeter::Initialize(LPCWSTR iniPath, LPCWSTR layout, bool safeStart)
 void Rainmeter::Finalize()
 {
 	KillTimer(m_Window, TIMER_NETSTATS);
+	KillTimer(m_Window, TIMER_SCHEDULE);
+	KillTimer(m_Window, TIMER_UPDATE);
 
 	GetGameMode().ForceExit();
 
@@ -736,6 +768,14 @@ LRESULT CALLBACK Rainmeter::MainWndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPA
 			MeasureNet::UpdateStats();
 			GetRainmeter().WriteStats(false);
 		}
+		else if (wParam == TIMER_UPDATE)
+		{
+			GetRainmeter().RunSkinUpdates();
+		}
+		else if (wParam == TIMER_SCHEDULE)
+		{
+			GetRainmeter().RunScheduledCommands();
+		}
 		else
 		{
 			GetGameMode().OnTimerEvent(wParam);
@@ -747,12 +787,7 @@ LRESULT CALLBACK Rainmeter::MainWndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPA
 		break;
 
 	case WM_RAINMETER_DELAYED_EXECUTE:
-		if (!wParam || GetRainmeter().HasSkin((Skin*)wParam))
-		{
-			WCHAR* bang = (WCHAR*)lParam;
-			GetRainmeter().ExecuteCommand(bang, (Skin*)wParam);
-			free(bang);  // _wcsdup()
-		}
+		GetRainmeter().RunDelayedCommands();
 		break;
 
 	case WM_RAINMETER_EXECUTE:
@@ -1479,6 +1514,18 @@ void Rainmeter::ScanForSkins()
 {
 	m_SkinRegistry.Populate(m_SkinPath, m_Favorites);
 	m_SkinOrders.clear();
+
+	// Remove the cached skin files of skins that no longer exist.
+	std::vector<std::wstring> iniFiles;
+	for (int i = 0, isize = m_SkinRegistry.GetFolderCount(); i < isize; ++i)
+	{
+		const std::wstring folderPath = m_SkinPath + m_SkinRegistry.GetFolderPath(i) + L'\\';
+		for (const auto& file : m_SkinRegistry.GetFolder(i).files)
+		{
+			iniFiles.push_back(folderPath + file.filename);
+		}
+	}
+	ConfigCache::PruneCacheFiles(iniFiles);
 }
 
 /*
@@ -1582,10 +1629,110 @@ void Rainmeter::ExecuteActionCommand(const WCHAR* command, Section* section)
 ** Executes command when current processing is done.
 **
 */
-void Rainmeter::DelayedExecuteCommand(const WCHAR* command, Skin* skin)
+void Rainmeter::DelayedExecuteCommand(const WCHAR* command, Skin* skin, UINT delay)
+{
+	// Can be called from any thread. Only one message is posted until the queue has been run.
+	if (m_CommandQueue.Push(command, skin, delay))
+	{
+		PostMessage(m_Window, WM_RAINMETER_DELAYED_EXECUTE, 0, 0);
+	}
+}
+
+/*
+** Executes commands queued with DelayedExecuteCommand. Other messages are processed between
+** slices so that a flood of commands does not block the main thread.
+**
+*/
+void Rainmeter::RunDelayedCommands()
+{
+	const size_t MAX_COMMANDS_PER_SLICE = 64;
+
+	const bool remaining = m_CommandQueue.Run(MAX_COMMANDS_PER_SLICE, [&](const WCHAR* command, Skin* skin, UINT delay)
+	{
+		if (!skin || HasSkin(skin))
+		{
+			if (delay > 0U)
+			{
+				ScheduleCommand(command, skin, delay);
+			}
+			else
+			{
+				ExecuteCommand(command, skin);
+			}
+		}
+	});
+
+	if (remaining)
+	{
+		PostMessage(m_Window, WM_RAINMETER_DELAYED_EXECUTE, 0, 0);
+	}
+}
+
+/*
+** Schedules a command on the timer wheel. All scheduled commands share a single timer.
+**
+*/
+void Rainmeter::ScheduleCommand(const WCHAR* command, Skin* skin, UINT delay)
+{
+	std::wstring copy = command;
+	m_ScheduledCommands.Add(GetTickCount64(), delay, skin, [skin, copy]()
+	{
+		GetRainmeter().ExecuteCommand(copy.c_str(), skin, true);
+	});
+
+	SetScheduleTimer();
+}
+
+/*
+** Cancels the scheduled commands of |skin|. Called when the skin is refreshed or closed.
+**
+*/
+void Rainmeter::CancelScheduledCommands(Skin* skin)
+{
+	m_ScheduledCommands.CancelAll(skin);
+	SetScheduleTimer();
+}
+
+void Rainmeter::RunScheduledCommands()
+{
+	// The timer is set again for the next due command.
+	m_ScheduleTimerDue = TimerWheel::c_NoTimer;
+	m_ScheduledCommands.Advance(GetTickCount64());
+	SetScheduleTimer();
+}
+
+void Rainmeter::SetScheduleTimer()
+{
+	SetTimerForDue(m_Window, TIMER_SCHEDULE, m_ScheduledCommands.GetNextDue(), m_ScheduleTimerDue);
+}
+
+/*
+** Schedules the updates of |skin|. All skins are updated with a single timer.
+**
+*/
+void Rainmeter::AddSkinUpdates(Skin* skin, UINT period)
+{
+	m_UpdateScheduler.Add(skin, period, GetTickCount64());
+	SetUpdateTimer();
+}
+
+void Rainmeter::RemoveSkinUpdates(Skin* skin)
+{
+	m_UpdateScheduler.Remove(skin);
+	SetUpdateTimer();
+}
+
+void Rainmeter::RunSkinUpdates()
+{
+	// The timer is set again for the next due skin.
+	m_UpdateTimerDue = UpdateScheduler::c_NoUpdate;
+	m_UpdateScheduler.Run(GetTickCount64(), [](Skin* skin) { skin->DoScheduledUpdate(); });
+	SetUpdateTimer();
+}
+
+void Rainmeter::SetUpdateTimer()
 {
-	WCHAR* bang = _wcsdup(command);
-	PostMessage(m_Window, WM_RAINMETER_DELAYED_EXECUTE, (WPARAM)skin, (LPARAM)bang);
+	SetTimerForDue(m_Window, TIMER_UPDATE, m_UpdateScheduler.GetNextDue(), m_UpdateTimerDue);
 }
 
 /*
@@ -14,11 +14,15 @@
 #include <list>
 #include <string>
 #include "CommandHandler.h"
+#include "CommandQueue.h"
 #include "ContextMenu.h"
 #include "DialogManage.h"
 #include "Logger.h"
 #include "Skin.h"
 #include "SkinRegistry.h"
+#include "TimerWheel.h"
+#include "UpdateScheduler.h"
+#include "WorkerPool.h"
 
 #define MAX_LINE_LENGTH 4096
 
@@ -173,7 +177,19 @@ public:
 
 	void ExecuteBang(const WCHAR* bang, std::vector<std::wstring>& args, Skin* skin);
 	void ExecuteCommand(const WCHAR* command, Skin* skin, bool multi = true);
-	void DelayedExecuteCommand(const WCHAR* command, Skin* skin = nullptr);
+	void DelayedExecuteCommand(const WCHAR* command, Skin* skin = nullptr, UINT delay = 0U);
+
+	// Executes |command| in |delay| milliseconds unless cancelled.
+	void ScheduleCommand(const WCHAR* command, Skin* skin, UINT delay);
+	void CancelScheduledCommands(Skin* skin);
+
+	// Updates |skin| every |period| milliseconds together with the other skins that are due.
+	void AddSkinUpdates(Skin* skin, UINT period);
+	void RemoveSkinUpdates(Skin* skin);
+
+	// Used by skins with ParallelMeasures=1.
+	WorkerPool& GetWorkerPool() { return m_WorkerPool; }
+
 	void ExecuteActionCommand(const WCHAR* command, Section* section);
 
 	void RefreshAll();
@@ -205,6 +221,12 @@ private:
 
 	static LRESULT CALLBACK MainWndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
+	void RunDelayedCommands();
+	void RunScheduledCommands();
+	void SetScheduleTimer();
+	void RunSkinUpdates();
+	void SetUpdateTimer();
+
 	void ActivateActiveSkins();
 	void CreateSkin(const std::wstring& folderPath, const std::wstring& file, bool hasSettings);
 	void DeleteAllSkins();
@@ -276,6 +298,12 @@ private:
 	D2D1_COLOR_F m_DefaultSelectedColor;
 
 	CommandHandler m_CommandHandler;
+	CommandQueue m_CommandQueue;
+	TimerWheel m_ScheduledCommands;
+	uint64_t m_ScheduleTimerDue;
+	UpdateScheduler m_UpdateScheduler;
+	uint64_t m_UpdateTimerDue;
+	WorkerPool m_WorkerPool;
 	ContextMenu m_ContextMenu;
 	SkinRegistry m_SkinRegistry;
 
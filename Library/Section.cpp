@@ -9,9 +9,13 @@
 #include "Section.h"
 #include "ConfigParser.h"
 #include "Rainmeter.h"
+#include <iterator>
 
 Section::Section(Skin* skin, const WCHAR* name) : m_Skin(skin), m_Name(name),
 	m_DynamicVariables(false),
+	m_OptionsDirty(true),
+	m_ReadVolatile(false),
+	m_DeferredVolatile(false),
 	m_UpdateDivider(1),
 	m_UpdateCounter(1)
 {
@@ -19,6 +23,10 @@ Section::Section(Skin* skin, const WCHAR* name) : m_Skin(skin), m_Name(name),
 
 Section::~Section()
 {
+	if (m_Skin)
+	{
+		m_Skin->GetParser().RemoveVariableReferences(this, m_VariableReferences);
+	}
 }
 
 /*
@@ -44,6 +52,63 @@ void Section::ReadOptions(ConfigParser& parser, const WCHAR* section)
 	InitializeGroup(group);
 }
 
+/*
+** Reads the options and records the variables referenced by them.
+**
+*/
+void Section::ReadTrackedOptions(ConfigParser& parser)
+{
+	ConfigParser::OptionReferences references = {};
+	ConfigParser::OptionReferences* previousReferences = parser.SetOptionReferences(&references);
+	ReadOptions(parser, GetName());
+	parser.SetOptionReferences(previousReferences);
+
+	std::vector<std::wstring>& variables = references.variables;
+	std::sort(variables.begin(), variables.end());
+	variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+	m_ReadReferences.swap(variables);
+	m_ReadVolatile = references.isVolatile;
+
+	std::vector<Measure*>& measures = references.measures;
+	std::sort(measures.begin(), measures.end());
+	measures.erase(std::unique(measures.begin(), measures.end()), measures.end());
+	m_OptionMeasures.swap(measures);
+
+	UpdateVariableReferences(parser);
+	m_OptionsDirty = m_ReadVolatile || m_DeferredVolatile || HasVolatileOptions();
+}
+
+void Section::SetDeferredReferences(ConfigParser& parser, std::vector<std::wstring> variables, bool isVolatile)
+{
+	std::sort(variables.begin(), variables.end());
+	variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+	m_DeferredReferences.swap(variables);
+	m_DeferredVolatile = isVolatile;
+
+	UpdateVariableReferences(parser);
+	if (m_DeferredVolatile)
+	{
+		m_OptionsDirty = true;
+	}
+}
+
+void Section::UpdateVariableReferences(ConfigParser& parser)
+{
+	std::vector<std::wstring> variables;
+	variables.reserve(m_ReadReferences.size() + m_DeferredReferences.size());
+	std::set_union(
+		m_ReadReferences.cbegin(), m_ReadReferences.cend(),
+		m_DeferredReferences.cbegin(), m_DeferredReferences.cend(),
+		std::back_inserter(variables));
+
+	if (variables != m_VariableReferences)
+	{
+		parser.RemoveVariableReferences(this, m_VariableReferences);
+		parser.AddVariableReferences(this, variables);
+		m_VariableReferences.swap(variables);
+	}
+}
+
 /*
 ** Updates the counter value
 **
@@ -10,9 +10,11 @@
 
 #include <windows.h>
 #include <string>
+#include <vector>
 #include "Group.h"
 
 class ConfigParser;
+class Measure;
 class Skin;
 
 class __declspec(novtable) Section : public Group
@@ -30,6 +32,14 @@ public:
 	bool HasDynamicVariables() const { return m_DynamicVariables; }
 	void SetDynamicVariables(bool b) { m_DynamicVariables = b; }
 
+	// With DynamicVariables=1, options that only reference variables are read again only after one
+	// of the variables has been set (or the options have been changed with !SetOption).
+	bool IsOptionsDirty() const { return m_OptionsDirty; }
+	void SetOptionsDirty() { m_OptionsDirty = true; }
+
+	// The measures whose values were read by the options, e.g. W=([Measure]*2).
+	const std::vector<Measure*>& GetOptionMeasures() const { return m_OptionMeasures; }
+
 	void ResetUpdateCounter() { m_UpdateCounter = m_UpdateDivider; }
 	int GetUpdateCounter() const { return m_UpdateCounter; }
 	int GetUpdateDivider() const { return m_UpdateDivider; }
@@ -43,6 +53,15 @@ protected:
 	Section(Skin* skin, const WCHAR* name);
 
 	virtual void ReadOptions(ConfigParser& parser, const WCHAR* section);
+	void ReadTrackedOptions(ConfigParser& parser);
+
+	// Records the references of options that are read outside of ReadOptions(), e.g. the
+	// conditions of a measure that are read again after its value has been updated.
+	void SetDeferredReferences(ConfigParser& parser, std::vector<std::wstring> variables, bool isVolatile);
+
+	// Returns true if reading the options has side effects (e.g. reloading a plugin) so that they
+	// must be read on every update with DynamicVariables=1.
+	virtual bool HasVolatileOptions() { return false; }
 
 	bool UpdateCounter();
 
@@ -51,12 +70,22 @@ protected:
 	const std::wstring m_Name;
 
 	bool m_DynamicVariables;		// If true, the section contains dynamic variables
+	bool m_OptionsDirty;			// If true, the options must be read again with DynamicVariables=1
+	std::vector<std::wstring> m_VariableReferences;		// Sorted uppercase names of the variables in the options
+	std::vector<std::wstring> m_ReadReferences;			// Part of |m_VariableReferences| from ReadOptions()
+	std::vector<std::wstring> m_DeferredReferences;		// Part of |m_VariableReferences| from SetDeferredReferences()
+	std::vector<Measure*> m_OptionMeasures;
+	bool m_ReadVolatile;
+	bool m_DeferredVolatile;
 	int m_UpdateDivider;			// Divider for the update
 	int m_UpdateCounter;			// Current update counter
 
 	std::wstring m_OnUpdateAction;
 
 	Skin* m_Skin;
+
+private:
+	void UpdateVariableReferences(ConfigParser& parser);
 };
 
 #endif
@@ -0,0 +1,124 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __SECTIONINDEX_H__
+#define __SECTIONINDEX_H__
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <cwctype>
+
+// Case-insensitive index of sections (measures or meters) by name. The hash of each name is
+// computed once when the section is added, and lookups do not allocate.
+template <typename T>
+class SectionIndex
+{
+public:
+	SectionIndex() : m_Entries(), m_Count() {}
+
+	SectionIndex(const SectionIndex& other) = delete;
+	SectionIndex& operator=(SectionIndex other) = delete;
+
+	void Clear()
+	{
+		m_Entries.clear();
+		m_Count = 0;
+	}
+
+	// Adds |section| unless a section with the same name has already been added.
+	bool Add(T* section)
+	{
+		const std::wstring& name = section->GetOriginalName();
+		const size_t hash = Hash(name.c_str(), name.length());
+		if (Find(name.c_str(), name.length(), hash)) return false;
+
+		// Keep the load factor at or below 1/2.
+		if ((m_Count + 1) * 2 > m_Entries.size())
+		{
+			Rehash(m_Entries.empty() ? 16 : m_Entries.size() * 2);
+		}
+
+		Insert(hash, section);
+		++m_Count;
+		return true;
+	}
+
+	T* Find(const WCHAR* name, size_t length) const { return Find(name, length, Hash(name, length)); }
+	T* Find(const std::wstring& name) const { return Find(name.c_str(), name.length()); }
+
+	size_t GetCount() const { return m_Count; }
+
+	static size_t Hash(const WCHAR* name, size_t length)
+	{
+		// FNV-1a of the lowercase characters, which matches the folding done by _wcsnicmp.
+		size_t hash = 2166136261U;
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash ^= (size_t)towlower(name[i]);
+			hash *= 16777619U;
+		}
+		return hash;
+	}
+
+private:
+	struct Entry
+	{
+		size_t hash;
+		T* section;
+	};
+
+	T* Find(const WCHAR* name, size_t length, size_t hash) const
+	{
+		if (m_Entries.empty()) return nullptr;
+
+		const size_t mask = m_Entries.size() - 1;
+		for (size_t i = hash & mask; m_Entries[i].section; i = (i + 1) & mask)
+		{
+			const Entry& entry = m_Entries[i];
+			if (entry.hash == hash &&
+				entry.section->GetOriginalName().length() == length &&
+				_wcsnicmp(entry.section->GetName(), name, length) == 0)
+			{
+				return entry.section;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Insert(size_t hash, T* section)
+	{
+		const size_t mask = m_Entries.size() - 1;
+		size_t i = hash & mask;
+		while (m_Entries[i].section)
+		{
+			i = (i + 1) & mask;
+		}
+
+		m_Entries[i].hash = hash;
+		m_Entries[i].section = section;
+	}
+
+	void Rehash(size_t size)
+	{
+		std::vector<Entry> entries(size, Entry());
+		entries.swap(m_Entries);
+		for (const auto& entry : entries)
+		{
+			if (entry.section)
+			{
+				Insert(entry.hash, entry.section);
+			}
+		}
+	}
+
+	std::vector<Entry> m_Entries;	// Open addressing with linear probing; size is a power of 2
+	size_t m_Count;
+};
+
+#endif
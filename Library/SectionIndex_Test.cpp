@@ -0,0 +1,76 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "SectionIndex.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_SectionIndex_Test)
+{
+public:
+	struct TestSection
+	{
+		TestSection(const WCHAR* name) : m_Name(name) {}
+
+		const WCHAR* GetName() const { return m_Name.c_str(); }
+		const std::wstring& GetOriginalName() const { return m_Name; }
+
+		std::wstring m_Name;
+	};
+
+	TEST_METHOD(TestFind)
+	{
+		TestSection a(L"MeasureCPU");
+		TestSection b(L"measurecpu2");
+		TestSection c(L"MeterText");
+
+		SectionIndex<TestSection> index;
+		Assert::IsNull(index.Find(L"MeasureCPU"));
+
+		Assert::IsTrue(index.Add(&a));
+		Assert::IsTrue(index.Add(&b));
+		Assert::IsTrue(index.Add(&c));
+
+		TestSection duplicate(L"METERTEXT");
+		Assert::IsFalse(index.Add(&duplicate));
+		Assert::AreEqual((size_t)3, index.GetCount());
+
+		Assert::IsTrue(index.Find(L"measurecpu") == &a);
+		Assert::IsTrue(index.Find(L"MEASURECPU2") == &b);
+		Assert::IsTrue(index.Find(L"metertext") == &c);
+		Assert::IsNull(index.Find(L"MeasureCP"));
+		Assert::IsNull(index.Find(L"MeterText2"));
+
+		// Names in formulas are not null-terminated.
+		const WCHAR* formula = L"MeasureCPU2 + 1";
+		Assert::IsTrue(index.Find(formula, 10) == &a);
+		Assert::IsTrue(index.Find(formula, 11) == &b);
+
+		index.Clear();
+		Assert::IsNull(index.Find(L"MeasureCPU"));
+	}
+
+	TEST_METHOD(TestGrow)
+	{
+		std::vector<TestSection> sections;
+		for (int i = 0; i < 1000; ++i)
+		{
+			sections.emplace_back(std::to_wstring(i).c_str());
+		}
+
+		SectionIndex<TestSection> index;
+		for (auto& section : sections)
+		{
+			Assert::IsTrue(index.Add(&section));
+		}
+
+		for (auto& section : sections)
+		{
+			Assert::IsTrue(index.Find(section.GetOriginalName()) == &section);
+		}
+	}
+};
@@ -36,14 +36,10 @@
 
 enum TIMER
 {
-	TIMER_METER      = 1,
 	TIMER_MOUSE      = 2,
 	TIMER_FADE       = 3,
 	TIMER_TRANSITION = 4,
-	TIMER_DEACTIVATE = 5,
-
-	// Update this when adding a new timer.
-	TIMER_MAX        = 5
+	TIMER_DEACTIVATE = 5
 };
 enum INTERVAL
 {
@@ -102,7 +98,13 @@ Skin::Skin(const std::wstring& folderPath, const std::wstring& file, const bool
 	m_WindowUpdate(INTERVAL_METER),
 	m_TransitionUpdate(INTERVAL_TRANSITION),
 	m_DefaultUpdateDivider(1),
+	m_LazyMeasures(false),
+	m_ParallelMeasures(false),
+	m_UpdateOrderDirty(false),
+	m_UpdatingMeasures(false),
 	m_ActiveTransition(false),
+	m_BatchDepth(0),
+	m_BatchRedraw(false),
 	m_HasNetMeasures(false),
 	m_HasButtons(false),
 	m_WindowHide(HIDEMODE_NONE),
@@ -200,11 +202,14 @@ Skin::~Skin()
 void Skin::Dispose(bool refresh)
 {
 	// Kill the timer/hook
-	KillTimer(m_Window, TIMER_METER);
+	GetRainmeter().RemoveSkinUpdates(this);
 	KillTimer(m_Window, TIMER_MOUSE);
 	KillTimer(m_Window, TIMER_FADE);
 	KillTimer(m_Window, TIMER_TRANSITION);
 
+	// Pending !Delay commands
+	GetRainmeter().CancelScheduledCommands(this);
+
 	m_FadeStartTime = 0ULL;
 
 	UnregisterMouseInput();
@@ -221,6 +226,7 @@ void Skin::Dispose(bool refresh)
 		delete (*j);
 	}
 	m_Meters.clear();
+	m_MeterIndex.Clear();
 
 	// Destroy the measures
 	for (auto i = m_Measures.begin(); i != m_Measures.end(); ++i)
@@ -228,6 +234,8 @@ void Skin::Dispose(bool refresh)
 		delete (*i);
 	}
 	m_Measures.clear();
+	m_UpdateOrder.clear();
+	m_MeasureWaves.clear();
 
 	delete m_Background;
 	m_Background = nullptr;
@@ -478,7 +486,7 @@ void Skin::Refresh(bool init, bool all)
 	// Start the timers
 	if (m_WindowUpdate >= 0)
 	{
-		SetTimer(m_Window, TIMER_METER, m_WindowUpdate, nullptr);
+		GetRainmeter().AddSkinUpdates(this, max((UINT)m_WindowUpdate, USER_TIMER_MINIMUM));
 	}
 
 	SetTimer(m_Window, TIMER_MOUSE, INTERVAL_MOUSE, nullptr);
@@ -808,16 +816,18 @@ void Skin::DoBang(Bang bang, const std::vector<std::wstring>& args)
 		break;
 
 	case Bang::Redraw:
-		Redraw();
+		if (m_BatchDepth > 0)
+		{
+			m_BatchRedraw = true;
+		}
+		else
+		{
+			Redraw();
+		}
 		break;
 
 	case Bang::Update:
-		KillTimer(m_Window, TIMER_METER);  // Kill timer temporarily
 		Update(false);
-		if (m_WindowUpdate >= 0)
-		{
-			SetTimer(m_Window, TIMER_METER, m_WindowUpdate, nullptr);
-		}
 		break;
 
 	case Bang::ShowBlur:
@@ -1177,10 +1187,8 @@ void Skin::DoBang(Bang bang, const std::vector<std::wstring>& args)
 
 void Skin::DoDelayedCommand(const WCHAR* command, UINT delay)
 {
-	static UINT_PTR id = TIMER_MAX;
-	++id;
-	SetTimer(m_Window, id, delay, nullptr);
-	m_DelayedCommands.emplace(id, command);
+	// Cancelled in Dispose().
+	GetRainmeter().ScheduleCommand(command, this, delay);
 }
 
 void Skin::ShowBlur()
@@ -1304,84 +1312,111 @@ bool CompareName(const Section* section, const WCHAR* name, bool group)
 	return (group) ? section->BelongsToGroup(name) : (_wcsicmp(section->GetName(), name) == 0);
 }
 
-void Skin::ShowMeter(const std::wstring& name, bool group)
+/*
+** Returns the meter named |name| or, if |group| is true, the meters in the group |name|.
+**
+*/
+std::vector<Meter*> Skin::FindMeters(const std::wstring& name, bool group)
 {
-	const WCHAR* meter = name.c_str();
-
-	std::vector<Meter*>::const_iterator j = m_Meters.begin();
-	for ( ; j != m_Meters.end(); ++j)
+	std::vector<Meter*> meters;
+	if (group)
 	{
-		if (CompareName((*j), meter, group))
+		for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
 		{
-			(*j)->Show();
-			SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
-			if (!group) return;
+			if ((*j)->BelongsToGroup(name))
+			{
+				meters.push_back(*j);
+			}
 		}
 	}
+	else if (Meter* meter = m_MeterIndex.Find(name))
+	{
+		meters.push_back(meter);
+	}
 
-	if (!group) LogErrorF(this, L"!ShowMeter: [%s] not found", meter);
+	return meters;
 }
 
-void Skin::HideMeter(const std::wstring& name, bool group)
+/*
+** Returns the measure named |name| or, if |group| is true, the measures in the group |name|.
+**
+*/
+std::vector<Measure*> Skin::FindMeasures(const std::wstring& name, bool group)
 {
-	const WCHAR* meter = name.c_str();
-
-	std::vector<Meter*>::const_iterator j = m_Meters.begin();
-	for ( ; j != m_Meters.end(); ++j)
+	std::vector<Measure*> measures;
+	if (group)
 	{
-		if (CompareName((*j), meter, group))
+		for (auto i = m_Measures.cbegin(); i != m_Measures.cend(); ++i)
 		{
-			(*j)->Hide();
-			SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
-			if (!group) return;
+			if ((*i)->BelongsToGroup(name))
+			{
+				measures.push_back(*i);
+			}
 		}
 	}
+	else if (Measure* measure = m_Parser.GetMeasure(name))
+	{
+		measures.push_back(measure);
+	}
 
-	if (!group) LogErrorF(this, L"!HideMeter: [%s] not found", meter);
+	return measures;
 }
 
-void Skin::ToggleMeter(const std::wstring& name, bool group)
+void Skin::ShowMeter(const std::wstring& name, bool group)
 {
-	const WCHAR* meter = name.c_str();
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		(*j)->Show();
+		SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
+	}
 
-	std::vector<Meter*>::const_iterator j = m_Meters.begin();
-	for ( ; j != m_Meters.end(); ++j)
+	if (!group && meters.empty()) LogErrorF(this, L"!ShowMeter: [%s] not found", name.c_str());
+}
+
+void Skin::HideMeter(const std::wstring& name, bool group)
+{
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
 	{
-		if (CompareName((*j), meter, group))
+		(*j)->Hide();
+		SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
+	}
+
+	if (!group && meters.empty()) LogErrorF(this, L"!HideMeter: [%s] not found", name.c_str());
+}
+
+void Skin::ToggleMeter(const std::wstring& name, bool group)
+{
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		if ((*j)->IsHidden())
 		{
-			if ((*j)->IsHidden())
-			{
-				(*j)->Show();
-			}
-			else
-			{
-				(*j)->Hide();
-			}
-			SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
-			if (!group) return;
+			(*j)->Show();
 		}
+		else
+		{
+			(*j)->Hide();
+		}
+		SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
 	}
 
-	if (!group) LogErrorF(this, L"!ToggleMeter: [%s] not found", meter);
+	if (!group && meters.empty()) LogErrorF(this, L"!ToggleMeter: [%s] not found", name.c_str());
 }
 
 void Skin::MoveMeter(const std::wstring& name, int x, int y)
 {
-	const WCHAR* meter = name.c_str();
-
-	std::vector<Meter*>::const_iterator j = m_Meters.begin();
-	for ( ; j != m_Meters.end(); ++j)
+	Meter* meter = m_MeterIndex.Find(name);
+	if (meter)
 	{
-		if (CompareName((*j), meter, false))
-		{
-			(*j)->SetX(x);
-			(*j)->SetY(y);
-			SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
-			return;
-		}
+		meter->SetX(x);
+		meter->SetY(y);
+		SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
+		return;
 	}
 
-	LogErrorF(this, L"!MoveMeter: [%s] not found", meter);
+	LogErrorF(this, L"!MoveMeter: [%s] not found", name.c_str());
 }
 
 void Skin::UpdateMeter(const std::wstring& name, bool group)
@@ -1433,7 +1468,6 @@ void Skin::UpdateMeter(const std::wstring& name, bool group)
 void Skin::DisableMouseAction(const std::wstring& name, const std::wstring& options, bool group)
 {
 	const WCHAR* meter = name.c_str();
-	bool all = false;
 
 	if (_wcsicmp(meter, L"Rainmeter") == 0)
 	{
@@ -1443,26 +1477,25 @@ void Skin::DisableMouseAction(const std::wstring& name, const std::wstring& opti
 
 	if (!group && meter[0] == L'*' && meter[1] == L'\0')  // Allow [!DisableMouseAction * ...]
 	{
-		all = true;
-		group = true;
-	}
-
-	for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
-	{
-		if (all || CompareName((*j), meter, group))
+		for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
 		{
 			(*j)->DisableMouseAction(options);
-			if (!group) return;
 		}
+		return;
+	}
+
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		(*j)->DisableMouseAction(options);
 	}
 
-	if (!group) LogErrorF(this, L"!DisableMouseAction: [%s] not found", meter);
+	if (!group && meters.empty()) LogErrorF(this, L"!DisableMouseAction: [%s] not found", meter);
 }
 
 void Skin::ClearMouseAction(const std::wstring& name, const std::wstring& options, bool group)
 {
 	const WCHAR* meter = name.c_str();
-	bool all = false;
 
 	if (_wcsicmp(meter, L"Rainmeter") == 0)
 	{
@@ -1472,26 +1505,25 @@ void Skin::ClearMouseAction(const std::wstring& name, const std::wstring& option
 
 	if (!group && meter[0] == L'*' && meter[1] == L'\0')  // Allow [!ClearMouseAction * ...]
 	{
-		all = true;
-		group = true;
-	}
-
-	for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
-	{
-		if (all || CompareName((*j), meter, group))
+		for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
 		{
 			(*j)->ClearMouseAction(options);
-			if (!group) return;
 		}
+		return;
+	}
+
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		(*j)->ClearMouseAction(options);
 	}
 
-	if (!group) LogErrorF(this, L"!ClearMouseAction: [%s] not found", meter);
+	if (!group && meters.empty()) LogErrorF(this, L"!ClearMouseAction: [%s] not found", meter);
 }
 
 void Skin::EnableMouseAction(const std::wstring& name, const std::wstring& options, bool group)
 {
 	const WCHAR* meter = name.c_str();
-	bool all = false;
 
 	if (_wcsicmp(meter, L"Rainmeter") == 0)
 	{
@@ -1501,26 +1533,25 @@ void Skin::EnableMouseAction(const std::wstring& name, const std::wstring& optio
 
 	if (!group && meter[0] == L'*' && meter[1] == L'\0')  // Allow [!EnableMouseAction * ...]
 	{
-		all = true;
-		group = true;
-	}
-
-	for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
-	{
-		if (all || CompareName((*j), meter, group))
+		for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
 		{
 			(*j)->EnableMouseAction(options);
-			if (!group) return;
 		}
+		return;
 	}
 
-	if (!group) LogErrorF(this, L"!EnableMouseAction: [%s] not found", meter);
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		(*j)->EnableMouseAction(options);
+	}
+
+	if (!group && meters.empty()) LogErrorF(this, L"!EnableMouseAction: [%s] not found", meter);
 }
 
 void Skin::ToggleMouseAction(const std::wstring& name, const std::wstring& options, bool group)
 {
 	const WCHAR* meter = name.c_str();
-	bool all = false;
 
 	if (_wcsicmp(meter, L"Rainmeter") == 0)
 	{
@@ -1530,136 +1561,100 @@ void Skin::ToggleMouseAction(const std::wstring& name, const std::wstring& optio
 
 	if (!group && meter[0] == L'*' && meter[1] == L'\0')  // Allow [!ToggleMouseAction * ...]
 	{
-		all = true;
-		group = true;
-	}
-
-	for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
-	{
-		if (all || CompareName((*j), meter, group))
+		for (auto j = m_Meters.cbegin(); j != m_Meters.cend(); ++j)
 		{
 			(*j)->ToggleMouseAction(options);
-			if (!group) return;
 		}
+		return;
 	}
 
-	if (!group) LogErrorF(this, L"!ToggleMouseAction: [%s] not found", meter);
+	const std::vector<Meter*> meters = FindMeters(name, group);
+	for (auto j = meters.cbegin(); j != meters.cend(); ++j)
+	{
+		(*j)->ToggleMouseAction(options);
+	}
+
+	if (!group && meters.empty()) LogErrorF(this, L"!ToggleMouseAction: [%s] not found", meter);
 }
 
 void Skin::EnableMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
-		{
-			(*i)->Enable();
-			if (!group) return;
-		}
+		(*i)->Enable();
 	}
 
-	if (!group) LogErrorF(this, L"!EnableMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!EnableMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::DisableMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
-		{
-			(*i)->Disable();
-			if (!group) return;
-		}
+		(*i)->Disable();
 	}
 
-	if (!group) LogErrorF(this, L"!DisableMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!DisableMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::ToggleMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
+		if ((*i)->IsDisabled())
 		{
-			if ((*i)->IsDisabled())
-			{
-				(*i)->Enable();
-			}
-			else
-			{
-				(*i)->Disable();
-			}
-			if (!group) return;
+			(*i)->Enable();
+		}
+		else
+		{
+			(*i)->Disable();
 		}
 	}
 
-	if (!group) LogErrorF(this, L"!ToggleMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!ToggleMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::PauseMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
-		{
-			(*i)->Pause();
-			if (!group) return;
-		}
+		(*i)->Pause();
 	}
 
-	if (!group) LogErrorF(this, L"!PauseMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!PauseMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::UnpauseMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
-		{
-			(*i)->Unpause();
-			if (!group) return;
-		}
+		(*i)->Unpause();
 	}
 
-	if (!group) LogErrorF(this, L"!UnpauseMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!UnpauseMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::TogglePauseMeasure(const std::wstring& name, bool group)
 {
-	const WCHAR* measure = name.c_str();
-
-	std::vector<Measure*>::const_iterator i = m_Measures.begin();
-	for ( ; i != m_Measures.end(); ++i)
+	const std::vector<Measure*> measures = FindMeasures(name, group);
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (CompareName((*i), measure, group))
+		if ((*i)->IsPaused())
 		{
-			if ((*i)->IsPaused())
-			{
-				(*i)->Unpause();
-			}
-			else
-			{
-				(*i)->Pause();
-			}
-			if (!group) return;
+			(*i)->Unpause();
+		}
+		else
+		{
+			(*i)->Pause();
 		}
 	}
 
-	if (!group) LogErrorF(this, L"!TogglePauseMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!TogglePauseMeasure: [%s] not found", name.c_str());
 }
 
 void Skin::UpdateMeasure(const std::wstring& name, bool group)
@@ -1673,33 +1668,38 @@ void Skin::UpdateMeasure(const std::wstring& name, bool group)
 		group = true;
 	}
 
+	const std::vector<Measure*> measures = all ? m_Measures : FindMeasures(name, group);
+
 	bool bNetStats = m_HasNetMeasures;
-	for (auto i = m_Measures.cbegin(); i != m_Measures.cend(); ++i)
+	for (auto i = measures.cbegin(); i != measures.cend(); ++i)
 	{
-		if (all || CompareName((*i), measure, group))
+		if (bNetStats && IsNetworkMeasure((*i)))
 		{
-			if (bNetStats && IsNetworkMeasure((*i)))
-			{
-				MeasureNet::UpdateIFTable();
-				MeasureNet::UpdateStats();
-				bNetStats = false;
-			}
-
-			if (UpdateMeasure((*i), true))
-			{
-				(*i)->DoUpdateAction();
-				(*i)->DoChangeAction();
-			}
+			MeasureNet::UpdateIFTable();
+			MeasureNet::UpdateStats();
+			bNetStats = false;
+		}
 
-			if (!group) return;
+		if (UpdateMeasure((*i), true))
+		{
+			(*i)->DoUpdateAction();
+			(*i)->DoChangeAction();
 		}
 	}
 
-	if (!group) LogErrorF(this, L"!UpdateMeasure: [%s] not found", measure);
+	if (!group && measures.empty()) LogErrorF(this, L"!UpdateMeasure: [%s] not found", measure);
 }
 
 void Skin::SetVariable(const std::wstring& variable, const std::wstring& value)
 {
+	// Meters whose options were already dirty are not affected by this change.
+	std::vector<bool> wasDirty;
+	wasDirty.reserve(m_Meters.size());
+	for (Meter* meter : m_Meters)
+	{
+		wasDirty.push_back(meter->IsOptionsDirty());
+	}
+
 	double result = 0.0;
 	if (m_Parser.ParseFormula(value, &result))
 	{
@@ -1714,6 +1714,40 @@ void Skin::SetVariable(const std::wstring& variable, const std::wstring& value)
 	{
 		m_Parser.SetVariable(variable, value);
 	}
+
+	// Measures that use the variable are updated on the next update as before. Meters that use it
+	// are updated now so that the change is shown without waiting for the next update. This is
+	// skipped while Update() updates the measures since the meters are updated right after that.
+	if (m_UpdatingMeasures) return;
+
+	bool bActiveTransition = false;
+	bool redraw = false;
+	for (size_t i = 0, isize = m_Meters.size(); i < isize; ++i)
+	{
+		Meter* meter = m_Meters[i];
+		if (wasDirty[i] || !meter->IsOptionsDirty() || !meter->HasDynamicVariables()) continue;
+
+		if (UpdateMeter(meter, bActiveTransition, true))
+		{
+			meter->DoUpdateAction();
+		}
+
+		SetResizeWindowMode(RESIZEMODE_CHECK);	// Need to recalculate the window size
+		redraw = true;
+	}
+
+	if (redraw)
+	{
+		// Combined with the other redraws of the command (e.g. several !SetVariable bangs).
+		if (m_BatchDepth > 0)
+		{
+			m_BatchRedraw = true;
+		}
+		else if (GetRainmeter().IsRedrawable())
+		{
+			Redraw();
+		}
+	}
 }
 
 /*
@@ -1726,6 +1760,7 @@ void Skin::SetOption(const std::wstring& section, const std::wstring& option, co
 	{
 		// Force DynamicVariables temporarily (until next ReadOptions()).
 		section->SetDynamicVariables(true);
+		section->SetOptionsDirty();
 
 		if (value.empty())
 		{
@@ -2499,6 +2534,8 @@ bool Skin::ReadSkin()
 	m_WindowUpdate = m_Parser.ReadInt(L"Rainmeter", L"Update", INTERVAL_METER);
 	m_TransitionUpdate = m_Parser.ReadInt(L"Rainmeter", L"TransitionUpdate", INTERVAL_TRANSITION);
 	m_DefaultUpdateDivider = m_Parser.ReadInt(L"Rainmeter", L"DefaultUpdateDivider", 1);
+	m_LazyMeasures = m_Parser.ReadBool(L"Rainmeter", L"LazyMeasures", false);
+	m_ParallelMeasures = m_Parser.ReadBool(L"Rainmeter", L"ParallelMeasures", false);
 	m_ToolTipHidden = m_Parser.ReadBool(L"Rainmeter", L"ToolTipHidden", false);
 
 	if (m_Parser.ReadBool(L"Rainmeter", L"Blur", false))
@@ -2706,6 +2743,7 @@ bool Skin::ReadSkin()
 				if (meter)
 				{
 					m_Meters.push_back(meter);
+					m_MeterIndex.Add(meter);
 
 					if (meter->GetTypeID() == TypeID<MeterButton>())
 					{
@@ -2740,11 +2778,22 @@ bool Skin::ReadSkin()
 	// Read measure options. This is done before the meters to ensure that e.g. Substitute is used
 	// when the meters get the value of the measure. The measures cannot be initialized yet as som
 	// measures (e.g. Script) except that the meters are ready when calling Initialize().
-	for (auto iter = m_Measures.cbegin(); iter != m_Measures.cend(); ++iter)
+	// The measures substituted into the options (e.g. [&Measure]) are recorded to determine the
+	// update order.
+	std::vector<std::vector<Measure*>> references(m_Measures.size());
+	for (size_t i = 0, isize = m_Measures.size(); i < isize; ++i)
 	{
-		Measure* measure = *iter;
-		measure->ReadOptions(m_Parser);
+		m_Parser.SetMeasureReferences(&references[i]);
+		m_Measures[i]->ReadOptions(m_Parser);
 	}
+	m_Parser.SetMeasureReferences(nullptr);
+
+	for (size_t i = 0, isize = m_Measures.size(); i < isize; ++i)
+	{
+		m_Measures[i]->SetMeasureReferences(std::move(references[i]));
+	}
+
+	BuildUpdateOrder();
 
 	// Initialize meters.
 	for (auto iter = m_Meters.cbegin(); iter != m_Meters.cend(); ++iter)
@@ -2870,6 +2919,19 @@ void Skin::CreateDoubleBuffer(int cx, int cy)
 	m_Canvas.Resize(cx, cy);
 }
 
+/*
+** Ends a batch started with BeginBatch() and performs the redraws requested during it.
+**
+*/
+void Skin::EndBatch()
+{
+	if (--m_BatchDepth == 0 && m_BatchRedraw)
+	{
+		m_BatchRedraw = false;
+		Redraw();
+	}
+}
+
 /*
 ** Redraws the meters and paints the window
 **
@@ -3028,6 +3090,8 @@ void Skin::Redraw()
 		// Draw the meters
 		for (auto meter : m_Meters)
 		{
+			meter->ClearDirty();
+
 			if (HandleContainer(meter)) continue;
 
 			const D2D1_MATRIX_3X2_F matrix = meter->GetTransformationMatrix();
@@ -3180,21 +3244,219 @@ void Skin::PostUpdate(bool bActiveTransition)
 */
 bool Skin::UpdateMeasure(Measure* measure, bool force)
 {
-	bool bUpdate = false;
+	bool rereadOptions = false;
+	if (!PrepareMeasureUpdate(measure, force, rereadOptions)) return false;
+
+	return measure->Update(rereadOptions);
+}
 
+/*
+** Returns false if the update divider of the measure is disabled. Otherwise determines whether
+** the options of the measure must be read again.
+**
+*/
+bool Skin::PrepareMeasureUpdate(Measure* measure, bool force, bool& rereadOptions)
+{
 	if (force)
 	{
 		measure->ResetUpdateCounter();
 	}
 
 	int updateDivider = measure->GetUpdateDivider();
-	if (updateDivider >= 0 || force)
+	if (updateDivider < 0 && !force) return false;
+
+	rereadOptions = measure->HasDynamicVariables() && (force || measure->IsOptionsDirty()) &&
+		(measure->GetUpdateCounter() + 1) >= updateDivider;
+	return true;
+}
+
+/*
+** Returns true if the measure should be updated by Update(). Measures that are skipped because
+** nothing observes them (LazyMeasures=1) are marked as stale.
+**
+*/
+bool Skin::IsMeasureUpdateNeeded(Measure* measure, bool refresh, bool lazy)
+{
+	if (lazy && !measure->IsObserved())
 	{
-		const bool rereadOptions = measure->HasDynamicVariables() && (measure->GetUpdateCounter() + 1) >= updateDivider;
-		bUpdate = measure->Update(rereadOptions);
+		// Updated when read instead.
+		measure->SetStale(true);
+		return false;
 	}
 
-	return bUpdate;
+	measure->SetStale(false);
+
+	// Derived measures (e.g. Calc) whose inputs have not changed are skipped.
+	return refresh || !measure->IsUpToDate();
+}
+
+/*
+** Updates the measures of |m_MeasureWaves| (ParallelMeasures=1). The values of the thread-safe
+** measures of each wave are updated concurrently on the worker pool. Options, actions and the
+** remaining measures are then handled on the main thread in update order.
+**
+*/
+void Skin::UpdateMeasureWaves(bool refresh, bool lazy)
+{
+	std::vector<std::pair<Measure*, bool>> updates;  // Measure, reread options
+	for (const MeasureOrder::Wave& wave : m_MeasureWaves)
+	{
+		updates.clear();
+		for (Measure* measure : wave.parallel)
+		{
+			bool rereadOptions = false;
+			if (IsMeasureUpdateNeeded(measure, refresh, lazy) &&
+				PrepareMeasureUpdate(measure, refresh, rereadOptions) &&
+				measure->BeginUpdate(rereadOptions))
+			{
+				updates.emplace_back(measure, rereadOptions);
+			}
+		}
+
+		GetRainmeter().GetWorkerPool().ForEach(updates.size(),
+			[&](size_t index) { updates[index].first->DoUpdateValue(); });
+
+		// |updates| is in the same order as |wave.measures|.
+		auto update = updates.cbegin();
+		for (Measure* measure : wave.measures)
+		{
+			if (update != updates.cend() && update->first == measure)
+			{
+				const bool rereadOptions = update->second;
+				++update;
+
+				// Actions of earlier measures may have updated, disabled or paused it meanwhile.
+				if (!measure->IsUpdatePending()) continue;
+
+				measure->EndUpdate(rereadOptions);
+				measure->DoUpdateAction();
+				measure->DoChangeAction();
+			}
+			else if (!measure->IsThreadSafe())
+			{
+				if (IsMeasureUpdateNeeded(measure, refresh, lazy) && UpdateMeasure(measure, refresh))
+				{
+					measure->DoUpdateAction();
+					measure->DoChangeAction();
+				}
+			}
+		}
+	}
+}
+
+/*
+** Updates |measure| if it was skipped because nothing observed it. The stale measures it depends
+** on are updated first.
+**
+*/
+void Skin::RefreshMeasure(Measure* measure)
+{
+	if (!measure->IsStale()) return;
+
+	// Cleared first to stop at dependency cycles.
+	measure->SetStale(false);
+
+	for (Measure* dependency : measure->GetDependencies())
+	{
+		RefreshMeasure(dependency);
+	}
+
+	UpdateMeasure(measure, false);
+}
+
+/*
+** Marks the measures that are read by visible meters, by measures with side effects (e.g. actions)
+** or by other observed measures. Used with LazyMeasures=1.
+**
+*/
+void Skin::UpdateObservedMeasures()
+{
+	std::vector<Measure*> stack;
+	for (Measure* measure : m_Measures)
+	{
+		measure->SetObserved(false);
+		if (measure->HasSideEffects())
+		{
+			stack.push_back(measure);
+		}
+	}
+
+	for (Meter* meter : m_Meters)
+	{
+		if (meter->IsHidden()) continue;
+
+		const std::vector<Measure*>& measures = meter->GetMeasures();
+		stack.insert(stack.end(), measures.cbegin(), measures.cend());
+
+		// Measures read by the options (e.g. W=([Measure]*2)) are updated before the options are
+		// read instead of in the middle of reading them.
+		const std::vector<Measure*>& optionMeasures = meter->GetOptionMeasures();
+		stack.insert(stack.end(), optionMeasures.cbegin(), optionMeasures.cend());
+	}
+
+	while (!stack.empty())
+	{
+		Measure* measure = stack.back();
+		stack.pop_back();
+		if (measure->IsObserved()) continue;
+
+		measure->SetObserved(true);
+
+		const std::vector<Measure*>& dependencies = measure->GetDependencies();
+		stack.insert(stack.end(), dependencies.cbegin(), dependencies.cend());
+	}
+}
+
+/*
+** Determines the dependencies of each measure and sorts |m_UpdateOrder| so that measures are
+** updated after the measures they read. Measures in a dependency cycle are kept in file order.
+** Called again on the next update when the dependencies of a measure change.
+**
+*/
+void Skin::BuildUpdateOrder()
+{
+	m_UpdateOrderDirty = false;
+
+	const size_t count = m_Measures.size();
+
+	std::unordered_map<Measure*, size_t> indices;
+	for (size_t i = 0; i < count; ++i)
+	{
+		indices[m_Measures[i]] = i;
+	}
+
+	std::vector<Measure*> dependencies;
+	for (size_t i = 0; i < count; ++i)
+	{
+		Measure* measure = m_Measures[i];
+
+		dependencies = measure->GetMeasureReferences();
+		measure->GetDependencies(dependencies);
+
+		// Keep the dependencies in file order without duplicates or self-references.
+		std::sort(dependencies.begin(), dependencies.end(),
+			[&](Measure* a, Measure* b) { return indices[a] < indices[b]; });
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+		dependencies.erase(std::remove(dependencies.begin(), dependencies.end(), measure), dependencies.end());
+
+		measure->SetDependencies(std::move(dependencies));
+	}
+
+	m_UpdateOrder = MeasureOrder::Sort(m_Measures);
+
+	BuildMeasureWaves();
+}
+
+/*
+** Groups |m_UpdateOrder| into waves for ParallelMeasures=1.
+**
+*/
+void Skin::BuildMeasureWaves()
+{
+	m_MeasureWaves.clear();
+	if (!m_ParallelMeasures) return;
+
+	m_MeasureWaves = MeasureOrder::BuildWaves(m_UpdateOrder);
 }
 
 /*
@@ -3208,12 +3470,27 @@ bool Skin::UpdateMeter(Meter* meter, bool& bActiveTransition, bool force)
 	if (force)
 	{
 		meter->ResetUpdateCounter();
+		meter->SetDirty();
 	}
 
 	int updateDivider = meter->GetUpdateDivider();
 	if (updateDivider >= 0 || force)
 	{
-		if (meter->HasDynamicVariables() &&
+		if (force && m_LazyMeasures)
+		{
+			// The measures of a hidden meter are not observed and may be stale.
+			for (Measure* measure : meter->GetMeasures())
+			{
+				RefreshMeasure(measure);
+			}
+
+			for (Measure* measure : meter->GetOptionMeasures())
+			{
+				RefreshMeasure(measure);
+			}
+		}
+
+		if (meter->HasDynamicVariables() && (force || meter->IsOptionsDirty()) &&
 			(meter->GetUpdateCounter() + 1) >= updateDivider)
 		{
 			meter->ReadOptions(m_Parser);
@@ -3263,38 +3540,69 @@ void Skin::Update(bool refresh)
 			MeasureNet::UpdateStats();
 		}
 
-		// Update all measures
-		std::vector<Measure*>::const_iterator i = m_Measures.begin();
-		for ( ; i != m_Measures.end(); ++i)
+		// The order is not rebuilt while an outer update (e.g. one that executed !Update in an
+		// action) iterates over it.
+		if (m_UpdateOrderDirty && !m_UpdatingMeasures)
+		{
+			BuildUpdateOrder();
+		}
+
+		const bool lazy = m_LazyMeasures && !refresh;
+		if (lazy)
+		{
+			UpdateObservedMeasures();
+		}
+
+		const bool updatingMeasures = m_UpdatingMeasures;
+		m_UpdatingMeasures = true;
+
+		if (m_ParallelMeasures)
 		{
-			if (UpdateMeasure((*i), refresh))
+			UpdateMeasureWaves(refresh, lazy);
+		}
+		else
+		{
+			// Update all measures in dependency order.
+			std::vector<Measure*>::const_iterator i = m_UpdateOrder.begin();
+			for ( ; i != m_UpdateOrder.end(); ++i)
 			{
-				(*i)->DoUpdateAction();
-				(*i)->DoChangeAction();
+				if (!IsMeasureUpdateNeeded((*i), refresh, lazy)) continue;
+
+				if (UpdateMeasure((*i), refresh))
+				{
+					(*i)->DoUpdateAction();
+					(*i)->DoChangeAction();
+				}
 			}
 		}
+
+		m_UpdatingMeasures = updatingMeasures;
 	}
 
 	DialogAbout::UpdateMeasures(this);
 
 	// Update all meters
 	bool bActiveTransition = false;
-	bool bUpdate = false;
+	bool bRedraw = false;
 	std::vector<Meter*>::const_iterator j = m_Meters.begin();
 	for ( ; j != m_Meters.end(); ++j)
 	{
 		if (UpdateMeter((*j), bActiveTransition, refresh))
 		{
-			bUpdate = true;
-
 			(*j)->DoUpdateAction();
 		}
+
+		// Only redraw if some meter may look different.
+		if ((*j)->IsDirty())
+		{
+			bRedraw = true;
+		}
 	}
 
 	UpdateRelativeMeters();
 
 	// Redraw all meters
-	if (bUpdate || m_ResizeWindow || refresh)
+	if (bRedraw || m_ResizeWindow || refresh)
 	{
 		if (m_DynamicWindowSize)
 		{
@@ -3359,18 +3667,14 @@ void Skin::UpdateWindowTransparency(int alpha)
 }
 
 /*
-** Handles the timers. The METERTIMER updates all the measures
-** MOUSETIMER is used to hide/show the window.
+** Handles the timers. MOUSETIMER is used to hide/show the window. The measures are updated by
+** Rainmeter::RunSkinUpdates instead.
 **
 */
 LRESULT Skin::OnTimer(UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
 	switch (wParam)
 	{
-	case TIMER_METER:
-		Update(false);
-		break;
-
 	case TIMER_MOUSE:
 		if (!GetRainmeter().IsMenuActive() && !m_Dragging)
 		{
@@ -3488,17 +3792,6 @@ LRESULT Skin::OnTimer(UINT uMsg, WPARAM wParam, LPARAM lParam)
 			delete this;
 		}
 		break;
-
-	default:
-		{
-			auto it = m_DelayedCommands.find(wParam);
-			if (it != m_DelayedCommands.end())
-			{
-				KillTimer(m_Window, wParam);
-				GetRainmeter().ExecuteCommand(it->second.c_str(), this, true);
-				m_DelayedCommands.erase(it);
-			}
-		}
 	}
 
 	return 0;
@@ -5517,16 +5810,7 @@ std::wstring Skin::GetSkinPath()
 
 Meter* Skin::GetMeter(const std::wstring& meterName)
 {
-	const WCHAR* name = meterName.c_str();
-	std::vector<Meter*>::const_iterator j = m_Meters.begin();
-	for ( ; j != m_Meters.end(); ++j)
-	{
-		if (_wcsicmp((*j)->GetName(), name) == 0)
-		{
-			return (*j);
-		}
-	}
-	return nullptr;
+	return m_MeterIndex.Find(meterName);
 }
 
 bool Skin::IsNetworkMeasure(Measure* measure)
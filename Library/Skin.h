@@ -15,7 +15,9 @@
 #include "CommandHandler.h"
 #include "ConfigParser.h"
 #include "Group.h"
+#include "MeasureOrder.h"
 #include "Mouse.h"
+#include "SectionIndex.h"
 #include "../Common/Gfx/Canvas.h"
 
 #define BEGIN_MESSAGEPROC switch (uMsg) {
@@ -111,6 +113,12 @@ public:
 	void DoBang(Bang bang, const std::vector<std::wstring>& args);
 	void DoDelayedCommand(const WCHAR* command, UINT delay);
 
+	// Called by Rainmeter every Update milliseconds.
+	void DoScheduledUpdate() { Update(false); }
+
+	// Sorts the measures again before the next update because the dependencies have changed.
+	void SetUpdateOrderDirty() { m_UpdateOrderDirty = true; }
+
 	void HideMeter(const std::wstring& name, bool group = false);
 	void ShowMeter(const std::wstring& name, bool group = false);
 	void ToggleMeter(const std::wstring& name, bool group = false);
@@ -131,6 +139,11 @@ public:
 	void Refresh(bool init, bool all = false);
 	void Redraw();
 	void RedrawWindow() { UpdateWindow(m_TransparencyValue); }
+
+	// !Redraw bangs executed between BeginBatch() and EndBatch() are combined into a single redraw
+	// when the outermost batch ends.
+	void BeginBatch() { ++m_BatchDepth; }
+	void EndBatch();
 	void SetVariable(const std::wstring& variable, const std::wstring& value);
 	void SetOption(const std::wstring& section, const std::wstring& option, const std::wstring& value, bool group);
 	bool HandleContainer(Meter* container);
@@ -223,6 +236,8 @@ public:
 	Meter* GetMeter(const std::wstring& meterName);
 	Measure* GetMeasure(const std::wstring& measureName) { return m_Parser.GetMeasure(measureName); }
 
+	void RefreshMeasure(Measure* measure);
+
 	friend class DialogManage;
 
 protected:
@@ -305,7 +320,15 @@ private:
 	void ScreenToWindow();
 	void PostUpdate(bool bActiveTransition);
 	bool UpdateMeasure(Measure* measure, bool force);
+	bool PrepareMeasureUpdate(Measure* measure, bool force, bool& rereadOptions);
+	bool IsMeasureUpdateNeeded(Measure* measure, bool refresh, bool lazy);
+	void UpdateMeasureWaves(bool refresh, bool lazy);
 	bool UpdateMeter(Meter* meter, bool& bActiveTransition, bool force);
+	void BuildUpdateOrder();
+	void BuildMeasureWaves();
+	void UpdateObservedMeasures();
+	std::vector<Meter*> FindMeters(const std::wstring& name, bool group);
+	std::vector<Measure*> FindMeasures(const std::wstring& name, bool group);
 	void Update(bool refresh);
 	void UpdateWindow(int alpha, bool canvasBeginDrawCalled = false);
 	void UpdateWindowTransparency(int alpha);
@@ -408,7 +431,13 @@ private:
 	int m_WindowUpdate;
 	int m_TransitionUpdate;
 	int m_DefaultUpdateDivider;
+	bool m_LazyMeasures;
+	bool m_ParallelMeasures;
+	bool m_UpdateOrderDirty;
+	bool m_UpdatingMeasures;	// True while Update() iterates over |m_UpdateOrder|
 	bool m_ActiveTransition;
+	int m_BatchDepth;
+	bool m_BatchRedraw;
 	bool m_HasNetMeasures;
 	bool m_HasButtons;
 	HIDEMODE m_WindowHide;
@@ -459,10 +488,11 @@ private:
 	bool m_Hidden;
 	RESIZEMODE m_ResizeWindow;
 
-	std::unordered_map<UINT_PTR, std::wstring> m_DelayedCommands;
-
 	std::vector<Measure*> m_Measures;
+	std::vector<Measure*> m_UpdateOrder;	// |m_Measures| sorted so that dependencies come first
+	std::vector<MeasureOrder::Wave> m_MeasureWaves;	// |m_UpdateOrder| grouped for ParallelMeasures=1
 	std::vector<Meter*> m_Meters;
+	SectionIndex<Meter> m_MeterIndex;
 
 	const std::wstring m_FolderPath;
 	const std::wstring m_FileName;
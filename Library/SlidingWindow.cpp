@@ -0,0 +1,121 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "SlidingWindow.h"
+
+SlidingAverage::SlidingAverage() :
+	m_Pos(),
+	m_Sum(),
+	m_AddCount()
+{
+}
+
+void SlidingAverage::Resize(size_t size, double value)
+{
+	m_Values.resize(size, value);
+	if (m_Pos >= size) m_Pos = 0;
+	Recalculate();
+}
+
+double SlidingAverage::Add(double value)
+{
+	const size_t size = m_Values.size();
+	if (size == 0) return value;
+
+	m_Sum += value - m_Values[m_Pos];
+	m_Values[m_Pos] = value;
+	m_Pos = (m_Pos + 1) % size;
+
+	// Recalculate the sum once per window to discard the accumulated rounding errors, or right
+	// away if it has become infinite or NaN since that cannot be undone by subtracting.
+	if (++m_AddCount >= size || !std::isfinite(m_Sum))
+	{
+		Recalculate();
+	}
+
+	return m_Sum / (double)size;
+}
+
+void SlidingAverage::Recalculate()
+{
+	m_Sum = 0.0;
+	for (double value : m_Values)
+	{
+		m_Sum += value;
+	}
+	m_AddCount = 0;
+}
+
+SlidingMedian::SlidingMedian() :
+	m_Pos()
+{
+}
+
+void SlidingMedian::Reset(size_t size, double value)
+{
+	m_Values.assign(size, value);
+	m_Pos = 0;
+	m_Lower.clear();
+	m_Upper.clear();
+	m_Lower.insert(m_Values.begin(), m_Values.begin() + size / 2);
+	m_Upper.insert(m_Values.begin() + size / 2, m_Values.end());
+}
+
+double SlidingMedian::Add(double value)
+{
+	const size_t size = m_Values.size();
+	if (size == 0) return value;
+
+	// NaN cannot be ordered.
+	if (std::isnan(value)) value = 0.0;
+
+	// Remove the oldest value. Values in |m_Lower| are never greater than the first value in
+	// |m_Upper|, so the value is in |m_Upper| if it is not less than that.
+	const double oldest = m_Values[m_Pos];
+	if (oldest >= *m_Upper.begin())
+	{
+		m_Upper.erase(m_Upper.find(oldest));
+	}
+	else
+	{
+		m_Lower.erase(m_Lower.find(oldest));
+	}
+
+	m_Values[m_Pos] = value;
+	m_Pos = (m_Pos + 1) % size;
+
+	if (!m_Upper.empty() && value >= *m_Upper.begin())
+	{
+		m_Upper.insert(value);
+	}
+	else
+	{
+		m_Lower.insert(value);
+	}
+
+	Balance();
+	return *m_Upper.begin();
+}
+
+void SlidingMedian::Balance()
+{
+	const size_t lowerSize = m_Values.size() / 2;
+	while (m_Lower.size() > lowerSize)
+	{
+		auto iter = std::prev(m_Lower.end());
+		m_Upper.insert(*iter);
+		m_Lower.erase(iter);
+	}
+
+	while (m_Lower.size() < lowerSize)
+	{
+		auto iter = m_Upper.begin();
+		m_Lower.insert(*iter);
+		m_Upper.erase(iter);
+	}
+}
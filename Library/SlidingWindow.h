@@ -0,0 +1,62 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __SLIDINGWINDOW_H__
+#define __SLIDINGWINDOW_H__
+
+#include <windows.h>
+#include <set>
+#include <vector>
+
+// Average of the last N values. Adding a value takes constant time regardless of N.
+class SlidingAverage
+{
+public:
+	SlidingAverage();
+
+	size_t GetSize() const { return m_Values.size(); }
+
+	// Changes the number of values. New values are set to |value|.
+	void Resize(size_t size, double value);
+
+	// Replaces the oldest value with |value| and returns the new average.
+	double Add(double value);
+
+private:
+	void Recalculate();
+
+	std::vector<double> m_Values;
+	size_t m_Pos;
+	double m_Sum;
+	size_t m_AddCount;	// Values added since the sum was last recalculated
+};
+
+// Median of the last N values. Adding a value takes O(log N) time. With an even N, the upper of
+// the two middle values is returned.
+class SlidingMedian
+{
+public:
+	SlidingMedian();
+
+	size_t GetSize() const { return m_Values.size(); }
+
+	// Sets the number of values and sets all of them to |value|.
+	void Reset(size_t size, double value);
+
+	// Replaces the oldest value with |value| and returns the new median.
+	double Add(double value);
+
+private:
+	void Balance();
+
+	std::vector<double> m_Values;	// In the order they were added
+	size_t m_Pos;
+	std::multiset<double> m_Lower;	// The smallest N / 2 values
+	std::multiset<double> m_Upper;	// The rest, with the median first
+};
+
+#endif
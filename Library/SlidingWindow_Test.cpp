@@ -0,0 +1,84 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "SlidingWindow.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_SlidingWindow_Test)
+{
+public:
+	TEST_METHOD(TestAverage)
+	{
+		SlidingAverage average;
+		Assert::AreEqual(5.0, average.Add(5.0));
+
+		average.Resize(4, 2.0);
+		Assert::AreEqual(3.0, average.Add(6.0));	// 6 2 2 2
+		Assert::AreEqual(4.0, average.Add(6.0));	// 6 6 2 2
+		Assert::AreEqual(5.0, average.Add(6.0));	// 6 6 6 2
+		Assert::AreEqual(6.0, average.Add(6.0));	// 6 6 6 6
+		Assert::AreEqual(4.5, average.Add(0.0));	// 0 6 6 6
+
+		// Existing values are kept when the size changes.
+		average.Resize(2, 0.0);
+		Assert::AreEqual(2.0, average.Add(4.0));	// 0 4
+
+		// Infinite values do not affect the average after they have been replaced.
+		Assert::AreEqual(HUGE_VAL, average.Add(HUGE_VAL));
+		average.Add(1.0);
+		Assert::AreEqual(1.0, average.Add(1.0));
+	}
+
+	TEST_METHOD(TestMedian)
+	{
+		SlidingMedian median;
+		Assert::AreEqual(5.0, median.Add(5.0));
+
+		median.Reset(3, 0.0);
+		Assert::AreEqual(0.0, median.Add(10.0));	// 10 0 0
+		Assert::AreEqual(10.0, median.Add(20.0));	// 10 20 0
+		Assert::AreEqual(10.0, median.Add(5.0));	// 10 20 5
+		Assert::AreEqual(5.0, median.Add(1.0));		// 1 20 5
+		Assert::AreEqual(5.0, median.Add(5.0));		// 1 5 5
+	}
+
+	TEST_METHOD(TestRandom)
+	{
+		// Compare against recalculating the whole window each time.
+		UINT seed = 1U;
+		auto random = [&]()
+		{
+			seed = seed * 1103515245U + 12345U;
+			return (double)((seed >> 16) % 50U);
+		};
+
+		const size_t sizes[] = { 1, 2, 3, 4, 7, 600 };
+		for (size_t size : sizes)
+		{
+			SlidingAverage average;
+			average.Resize(size, 0.0);
+			SlidingMedian median;
+			median.Reset(size, 0.0);
+
+			std::vector<double> values(size, 0.0);
+			for (size_t i = 0; i < 5000; ++i)
+			{
+				const double value = random();
+				values[i % size] = value;
+
+				double sum = 0.0;
+				for (double v : values) sum += v;
+				Assert::AreEqual(sum / size, average.Add(value), 1e-9);
+
+				std::vector<double> sorted = values;
+				std::sort(sorted.begin(), sorted.end());
+				Assert::AreEqual(sorted[size / 2], median.Add(value));
+			}
+		}
+	}
+};
@@ -0,0 +1,232 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel() :
+	m_Slots(),
+	m_Tick(),
+	m_Linked(),
+	m_NextId()
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+	for (const auto& timer : m_Timers)
+	{
+		delete timer.second;
+	}
+}
+
+UINT TimerWheel::Add(uint64_t now, UINT delay, const void* owner, Callback callback)
+{
+	if (m_Linked == 0)
+	{
+		// Nothing to run in between, so skip the ticks since the last Advance().
+		m_Tick = now;
+	}
+
+	do
+	{
+		++m_NextId;
+	}
+	while (m_NextId == 0U || m_Timers.find(m_NextId) != m_Timers.end());
+
+	Timer* timer = new Timer;
+	timer->due = now + delay;
+	timer->id = m_NextId;
+	timer->cancelled = false;
+	timer->owner = owner;
+	timer->callback = std::move(callback);
+	Link(timer);
+
+	m_Timers.emplace(timer->id, timer);
+	return timer->id;
+}
+
+bool TimerWheel::Cancel(UINT id)
+{
+	auto iter = m_Timers.find(id);
+	if (iter == m_Timers.end()) return false;
+
+	Timer* timer = iter->second;
+	m_Timers.erase(iter);
+
+	if (timer->slot == -1)
+	{
+		// Deleted by Advance().
+		timer->cancelled = true;
+	}
+	else
+	{
+		Unlink(timer);
+		delete timer;
+	}
+
+	return true;
+}
+
+void TimerWheel::CancelAll(const void* owner)
+{
+	std::vector<UINT> ids;
+	for (const auto& timer : m_Timers)
+	{
+		if (timer.second->owner == owner)
+		{
+			ids.push_back(timer.first);
+		}
+	}
+
+	for (UINT id : ids)
+	{
+		Cancel(id);
+	}
+}
+
+void TimerWheel::Advance(uint64_t now)
+{
+	std::vector<Timer*> expired;
+
+	while (m_Tick <= now && m_Linked > 0)
+	{
+		const uint64_t index = m_Tick & GetMask(0);
+		if (index == 0)
+		{
+			// Refill level 0 from the next levels.
+			for (int level = 1; level < c_Levels; ++level)
+			{
+				const uint64_t levelIndex = (m_Tick >> GetShift(level)) & GetMask(level);
+				Cascade(level, levelIndex);
+				if (levelIndex != 0) break;
+			}
+		}
+
+		Slot& slot = m_Slots[index];
+		for (Timer* timer = slot.head; timer; timer = timer->next)
+		{
+			timer->slot = -1;
+			expired.push_back(timer);
+			--m_Linked;
+		}
+		slot.head = slot.tail = nullptr;
+
+		// Skip the ticks without anything to do.
+		++m_Tick;
+		m_Tick = min(GetNextDue(), now + 1);
+	}
+
+	if (m_Linked == 0)
+	{
+		m_Tick = now + 1;
+	}
+
+	for (Timer* timer : expired)
+	{
+		// A previous callback might have cancelled the timer.
+		if (!timer->cancelled)
+		{
+			m_Timers.erase(timer->id);
+			timer->callback();
+		}
+
+		delete timer;
+	}
+}
+
+uint64_t TimerWheel::GetNextDue() const
+{
+	uint64_t due = c_NoTimer;
+	for (uint64_t i = 0; i <= GetMask(0); ++i)
+	{
+		if (m_Slots[(m_Tick + i) & GetMask(0)].head)
+		{
+			due = m_Tick + i;
+			break;
+		}
+	}
+
+	// The next levels might need to be moved to level 0 before that.
+	for (int level = 1; level < c_Levels; ++level)
+	{
+		const int shift = GetShift(level);
+		const uint64_t block = m_Tick >> shift;
+
+		// The current block is only moved if |m_Tick| is at its start and has not been run yet.
+		const uint64_t first = ((m_Tick & ((1ULL << shift) - 1)) == 0) ? 0 : 1;
+		for (uint64_t i = first; i <= first + GetMask(level); ++i)
+		{
+			if (m_Slots[GetFirstSlot(level) + ((block + i) & GetMask(level))].head)
+			{
+				due = min(due, (block + i) << shift);
+				break;
+			}
+		}
+	}
+
+	return due;
+}
+
+void TimerWheel::Link(Timer* timer)
+{
+	uint64_t due = max(timer->due, m_Tick);
+	const uint64_t delta = due - m_Tick;
+
+	int level = 0;
+	while (level < c_Levels - 1 && delta >= (1ULL << GetShift(level + 1)))
+	{
+		++level;
+	}
+
+	// Timers beyond the last level wait in its last slot and are linked again when it is refilled.
+	const uint64_t range = 1ULL << (GetShift(c_Levels - 1) + c_LevelBits);
+	if (delta >= range)
+	{
+		due = m_Tick + range - 1;
+	}
+
+	const int index = GetFirstSlot(level) + (int)((due >> GetShift(level)) & GetMask(level));
+	Slot& slot = m_Slots[index];
+	timer->slot = index;
+	timer->next = nullptr;
+	timer->prev = slot.tail;
+	if (slot.tail)
+	{
+		slot.tail->next = timer;
+	}
+	else
+	{
+		slot.head = timer;
+	}
+	slot.tail = timer;
+	++m_Linked;
+}
+
+void TimerWheel::Unlink(Timer* timer)
+{
+	Slot& slot = m_Slots[timer->slot];
+	(timer->prev ? timer->prev->next : slot.head) = timer->next;
+	(timer->next ? timer->next->prev : slot.tail) = timer->prev;
+	timer->slot = -1;
+	--m_Linked;
+}
+
+void TimerWheel::Cascade(int level, uint64_t index)
+{
+	Slot& slot = m_Slots[GetFirstSlot(level) + index];
+	Timer* timer = slot.head;
+	slot.head = slot.tail = nullptr;
+
+	while (timer)
+	{
+		Timer* next = timer->next;
+		--m_Linked;
+		Link(timer);
+		timer = next;
+	}
+}
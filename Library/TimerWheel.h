@@ -0,0 +1,94 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __TIMERWHEEL_H__
+#define __TIMERWHEEL_H__
+
+#include <windows.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Hierarchical timer wheel with millisecond ticks. Timers are added and cancelled in constant
+// time and are run from Advance(), so any number of pending timers needs only one OS timer to
+// call Advance() at GetNextDue(). Must only be used from one thread.
+class TimerWheel
+{
+public:
+	typedef std::function<void()> Callback;
+
+	static const uint64_t c_NoTimer = (uint64_t)-1;
+
+	TimerWheel();
+	~TimerWheel();
+
+	TimerWheel(const TimerWheel& other) = delete;
+	TimerWheel& operator=(TimerWheel other) = delete;
+
+	// Adds a timer that runs |callback| |delay| milliseconds after |now|. Returns the id of the
+	// timer, which is never 0.
+	UINT Add(uint64_t now, UINT delay, const void* owner, Callback callback);
+
+	// Returns false if the timer has already run or been cancelled.
+	bool Cancel(UINT id);
+	void CancelAll(const void* owner);
+
+	// Runs the timers that are due at or before |now| in the order they are due.
+	void Advance(uint64_t now);
+
+	// Returns the time at which Advance() needs to be called next or c_NoTimer if there are no
+	// timers. This is a time at which timers are moved between levels if the first timer is far
+	// away.
+	uint64_t GetNextDue() const;
+
+	size_t GetCount() const { return m_Timers.size(); }
+
+private:
+	struct Timer
+	{
+		Timer* prev;
+		Timer* next;
+		uint64_t due;
+		UINT id;
+		int slot;			// -1 once taken out of the wheel to be run
+		bool cancelled;
+		const void* owner;
+		Callback callback;
+	};
+
+	struct Slot
+	{
+		Timer* head;
+		Timer* tail;
+	};
+
+	// Level 0 has a slot for each of the next 256 ms. Each slot of the following levels covers
+	// all slots of the previous level.
+	static const int c_Levels = 4;
+	static const int c_Level0Bits = 8;
+	static const int c_LevelBits = 6;
+	static const int c_SlotCount = (1 << c_Level0Bits) + (c_Levels - 1) * (1 << c_LevelBits);
+
+	static int GetShift(int level) { return (level == 0) ? 0 : c_Level0Bits + (level - 1) * c_LevelBits; }
+	static int GetFirstSlot(int level) { return (level == 0) ? 0 : (1 << c_Level0Bits) + (level - 1) * (1 << c_LevelBits); }
+	static uint64_t GetMask(int level) { return (level == 0) ? (1 << c_Level0Bits) - 1 : (1 << c_LevelBits) - 1; }
+
+	void Link(Timer* timer);
+	void Unlink(Timer* timer);
+
+	// Moves the timers in |slot| of |level| to the lower levels.
+	void Cascade(int level, uint64_t index);
+
+	Slot m_Slots[c_SlotCount];
+	uint64_t m_Tick;			// Next tick to be run
+	size_t m_Linked;			// Number of timers in |m_Slots|
+	UINT m_NextId;
+	std::unordered_map<UINT, Timer*> m_Timers;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "TimerWheel.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_TimerWheel_Test)
+{
+public:
+	TEST_METHOD(TestOrder)
+	{
+		TimerWheel wheel;
+		std::wstring result;
+		auto add = [&](UINT delay, const WCHAR* name)
+		{
+			std::wstring str = name;
+			return wheel.Add(1000ULL, delay, nullptr, [&result, str]() { result += str; });
+		};
+
+		add(300U, L"C");
+		add(10U, L"A");
+		add(100000U, L"D");
+		add(10U, L"B");
+		Assert::AreEqual((size_t)4, wheel.GetCount());
+		Assert::IsTrue(wheel.GetNextDue() == 1010ULL);
+
+		wheel.Advance(1009ULL);
+		Assert::AreEqual(L"", result.c_str());
+		wheel.Advance(1010ULL);
+		Assert::AreEqual(L"AB", result.c_str());
+
+		// Far away timers are moved closer on the way.
+		uint64_t now = 1010ULL;
+		while (wheel.GetCount() > 1)
+		{
+			now = wheel.GetNextDue();
+			wheel.Advance(now);
+		}
+		Assert::AreEqual(L"ABC", result.c_str());
+		Assert::IsTrue(now == 1300ULL);
+
+		while (wheel.GetCount() > 0)
+		{
+			now = wheel.GetNextDue();
+			Assert::IsTrue(now <= 101000ULL);
+			wheel.Advance(now);
+		}
+		Assert::AreEqual(L"ABCD", result.c_str());
+		Assert::IsTrue(now == 101000ULL);
+		Assert::IsTrue(wheel.GetNextDue() == TimerWheel::c_NoTimer);
+	}
+
+	TEST_METHOD(TestLongDelay)
+	{
+		TimerWheel wheel;
+		bool done = false;
+
+		// Longer than all levels together.
+		const UINT delay = 0xF0000000U;
+		wheel.Add(0ULL, delay, nullptr, [&]() { done = true; });
+
+		uint64_t now = 0ULL;
+		while (!done)
+		{
+			const uint64_t due = wheel.GetNextDue();
+			Assert::IsTrue(due > now && due <= delay);
+			now = due;
+			wheel.Advance(now);
+		}
+		Assert::IsTrue(now == delay);
+	}
+
+	TEST_METHOD(TestCancel)
+	{
+		TimerWheel wheel;
+		int owner1 = 0;
+		int owner2 = 0;
+		std::wstring result;
+
+		const UINT a = wheel.Add(0ULL, 5U, &owner1, [&]() { result += L"A"; });
+		wheel.Add(0ULL, 5000U, &owner1, [&]() { result += L"B"; });
+		wheel.Add(0ULL, 5U, &owner2, [&]() { result += L"C"; });
+		const UINT d = wheel.Add(0ULL, 5U, &owner2, [&]() { result += L"D"; });
+		UINT f = 0U;
+		wheel.Add(0ULL, 5U, &owner2, [&]()
+		{
+			// Timers due at the same time can still be cancelled by an earlier one.
+			result += L"E";
+			Assert::IsTrue(wheel.Cancel(f));
+		});
+		f = wheel.Add(0ULL, 5U, &owner2, [&]() { result += L"F"; });
+		wheel.Add(0ULL, 5U, &owner2, [&]() { result += L"G"; });
+
+		Assert::IsTrue(wheel.Cancel(a));
+		Assert::IsFalse(wheel.Cancel(a));
+		wheel.CancelAll(&owner1);
+		Assert::IsTrue(wheel.Cancel(d));
+
+		wheel.Advance(10000ULL);
+		Assert::AreEqual(L"CEG", result.c_str());
+		Assert::AreEqual((size_t)0, wheel.GetCount());
+	}
+};
@@ -0,0 +1,47 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "UpdateScheduler.h"
+
+void UpdateScheduler::Add(Skin* skin, UINT period, uint64_t now)
+{
+	period = max(period, 1U);
+
+	Entry entry;
+	entry.due = (now / period + 1ULL) * period;
+	entry.skin = skin;
+	entry.period = period;
+	entry.generation = ++m_Generation;
+	m_Skins[skin] = entry.generation;
+
+	m_Heap.push_back(entry);
+	std::push_heap(m_Heap.begin(), m_Heap.end(), IsLater);
+
+	Compact();
+}
+
+void UpdateScheduler::Remove(Skin* skin)
+{
+	m_Skins.erase(skin);
+	Compact();
+}
+
+void UpdateScheduler::Compact()
+{
+	// Stale entries with long periods could otherwise pile up when skins are refreshed often.
+	if (m_Heap.size() <= m_Skins.size() * 2 + 16) return;
+
+	auto isStale = [&](const Entry& entry)
+	{
+		auto iter = m_Skins.find(entry.skin);
+		return iter == m_Skins.end() || iter->second != entry.generation;
+	};
+
+	m_Heap.erase(std::remove_if(m_Heap.begin(), m_Heap.end(), isStale), m_Heap.end());
+	std::make_heap(m_Heap.begin(), m_Heap.end(), IsLater);
+}
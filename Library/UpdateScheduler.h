@@ -0,0 +1,90 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __UPDATESCHEDULER_H__
+#define __UPDATESCHEDULER_H__
+
+#include <windows.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class Skin;
+
+// Periodic updates of all skins ordered by deadline so that a single timer can run them. Updates
+// are aligned to multiples of their period so that skins with the same Update run together.
+class UpdateScheduler
+{
+public:
+	static const uint64_t c_NoUpdate = (uint64_t)-1;
+
+	UpdateScheduler() : m_Generation() {}
+
+	UpdateScheduler(const UpdateScheduler& other) = delete;
+	UpdateScheduler& operator=(UpdateScheduler other) = delete;
+
+	// Updates |skin| every |period| milliseconds after |now|. Replaces the previous period.
+	void Add(Skin* skin, UINT period, uint64_t now);
+	void Remove(Skin* skin);
+
+	// Calls |func(skin)| once for each skin that is due at or before |now| in deadline order.
+	// Updates missed since then are skipped.
+	template<typename Func>
+	void Run(uint64_t now, Func func)
+	{
+		while (!m_Heap.empty() && m_Heap.front().due <= now)
+		{
+			Entry entry = m_Heap.front();
+			std::pop_heap(m_Heap.begin(), m_Heap.end(), IsLater);
+			m_Heap.pop_back();
+
+			// Skip entries of removed or replaced skins.
+			auto iter = m_Skins.find(entry.skin);
+			if (iter == m_Skins.end() || iter->second != entry.generation) continue;
+
+			// Rescheduled before calling |func| so that it can remove or replace the skin.
+			entry.due = GetNextPeriod(entry.due, entry.period, now);
+			m_Heap.push_back(entry);
+			std::push_heap(m_Heap.begin(), m_Heap.end(), IsLater);
+
+			func(entry.skin);
+		}
+	}
+
+	// Returns c_NoUpdate if there are no skins.
+	uint64_t GetNextDue() const { return m_Heap.empty() ? c_NoUpdate : m_Heap.front().due; }
+
+	size_t GetCount() const { return m_Skins.size(); }
+
+private:
+	struct Entry
+	{
+		uint64_t due;
+		Skin* skin;
+		UINT period;
+		UINT generation;
+	};
+
+	static bool IsLater(const Entry& a, const Entry& b) { return a.due > b.due; }
+
+	// Returns the first multiple of |period| after |now| counting from |due|.
+	static uint64_t GetNextPeriod(uint64_t due, UINT period, uint64_t now)
+	{
+		return (due > now) ? due : now + period - ((now - due) % period);
+	}
+
+	// Entries of removed or replaced skins stay in |m_Heap| until they are due. This removes them
+	// if there are many.
+	void Compact();
+
+	std::vector<Entry> m_Heap;
+	std::unordered_map<Skin*, UINT> m_Skins;	// Generation of the current entry of each skin
+	UINT m_Generation;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "UpdateScheduler.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_UpdateScheduler_Test)
+{
+public:
+	Skin* const a = (Skin*)1;
+	Skin* const b = (Skin*)2;
+	Skin* const c = (Skin*)3;
+
+	std::wstring Run(UpdateScheduler& scheduler, uint64_t now)
+	{
+		std::wstring result;
+		scheduler.Run(now, [&](Skin* skin) { result += (WCHAR)(L'a' + (INT_PTR)skin - 1); });
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	TEST_METHOD(TestAlignment)
+	{
+		UpdateScheduler scheduler;
+		Assert::IsTrue(scheduler.GetNextDue() == UpdateScheduler::c_NoUpdate);
+
+		// Skins with the same period are updated together.
+		scheduler.Add(a, 1000U, 1500ULL);
+		scheduler.Add(b, 1000U, 1700ULL);
+		scheduler.Add(c, 250U, 1700ULL);
+		Assert::IsTrue(scheduler.GetNextDue() == 1750ULL);
+
+		Assert::AreEqual(L"c", Run(scheduler, 1999ULL).c_str());
+		Assert::AreEqual(L"abc", Run(scheduler, 2000ULL).c_str());
+		Assert::IsTrue(scheduler.GetNextDue() == 2250ULL);
+
+		// Missed updates are skipped.
+		Assert::AreEqual(L"abc", Run(scheduler, 9100ULL).c_str());
+		Assert::IsTrue(scheduler.GetNextDue() == 9250ULL);
+		Assert::AreEqual(L"c", Run(scheduler, 9250ULL).c_str());
+	}
+
+	TEST_METHOD(TestRemove)
+	{
+		UpdateScheduler scheduler;
+		scheduler.Add(a, 1000U, 0ULL);
+		scheduler.Add(b, 1000U, 0ULL);
+		scheduler.Remove(a);
+		Assert::AreEqual((size_t)1, scheduler.GetCount());
+		Assert::AreEqual(L"b", Run(scheduler, 1000ULL).c_str());
+
+		// Only the latest period is used.
+		scheduler.Add(b, 300U, 1000ULL);
+		Assert::AreEqual(L"b", Run(scheduler, 1200ULL).c_str());
+		Assert::IsTrue(scheduler.GetNextDue() == 1500ULL);
+
+		// Skins can be removed while running.
+		scheduler.Add(a, 300U, 1000ULL);
+		std::wstring result;
+		scheduler.Run(1500ULL, [&](Skin* skin)
+		{
+			result += L'x';
+			scheduler.Remove(a);
+			scheduler.Remove(b);
+		});
+		Assert::AreEqual(L"x", result.c_str());
+		Assert::AreEqual((size_t)0, scheduler.GetCount());
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			scheduler.Add(c, 60000U, (uint64_t)i);
+		}
+		Assert::AreEqual(L"c", Run(scheduler, 60000ULL).c_str());
+	}
+};
@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool() :
+	m_Work(),
+	m_MaxWorkers(),
+	m_Func(),
+	m_Context(),
+	m_Count(),
+	m_Next(0L)
+{
+	SYSTEM_INFO systemInfo = { 0 };
+	GetSystemInfo(&systemInfo);
+	if (systemInfo.dwNumberOfProcessors > 1UL)
+	{
+		m_Work = CreateThreadpoolWork(WorkCallback, this, nullptr);
+		if (m_Work)
+		{
+			m_MaxWorkers = (UINT)systemInfo.dwNumberOfProcessors - 1U;
+		}
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	if (m_Work)
+	{
+		WaitForThreadpoolWorkCallbacks(m_Work, TRUE);
+		CloseThreadpoolWork(m_Work);
+	}
+}
+
+void WorkerPool::Run(size_t count, ItemFunc func, void* context)
+{
+	if (count == 0) return;
+
+	m_Func = func;
+	m_Context = context;
+	m_Count = count;
+	m_Next = 0L;
+
+	// The calling thread runs items as well, so a single item needs no worker.
+	const size_t workers = min(count - 1, (size_t)m_MaxWorkers);
+	for (size_t i = 0; i < workers; ++i)
+	{
+		SubmitThreadpoolWork(m_Work);
+	}
+
+	RunItems();
+
+	if (workers > 0)
+	{
+		// All items have been taken at this point, so callbacks that have not started yet are
+		// cancelled and only the running ones are waited for.
+		WaitForThreadpoolWorkCallbacks(m_Work, TRUE);
+	}
+}
+
+void WorkerPool::RunItems()
+{
+	while (true)
+	{
+		const size_t index = (size_t)(InterlockedIncrement(&m_Next) - 1L);
+		if (index >= m_Count) break;
+
+		m_Func(m_Context, index);
+	}
+}
+
+VOID CALLBACK WorkerPool::WorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
+{
+	((WorkerPool*)context)->RunItems();
+}
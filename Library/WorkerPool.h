@@ -0,0 +1,53 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __WORKERPOOL_H__
+#define __WORKERPOOL_H__
+
+#include <windows.h>
+
+// Runs batches of work items on the threads of the process-wide Windows thread pool.
+class WorkerPool
+{
+public:
+	WorkerPool();
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool& other) = delete;
+	WorkerPool& operator=(WorkerPool other) = delete;
+
+	// Calls |func(index)| for each index below |count| on the pool threads and on the calling
+	// thread. Returns after all calls have returned. Must not be called from |func|.
+	template<typename Func>
+	void ForEach(size_t count, Func func)
+	{
+		Run(count, &CallFunc<Func>, &func);
+	}
+
+	UINT GetMaxWorkers() const { return m_MaxWorkers; }
+
+private:
+	typedef void (*ItemFunc)(void* context, size_t index);
+
+	template<typename Func>
+	static void CallFunc(void* context, size_t index) { (*(Func*)context)(index); }
+
+	void Run(size_t count, ItemFunc func, void* context);
+	void RunItems();
+
+	static VOID CALLBACK WorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work);
+
+	PTP_WORK m_Work;
+	UINT m_MaxWorkers;		// Pool threads used in addition to the calling thread
+
+	ItemFunc m_Func;
+	void* m_Context;
+	size_t m_Count;
+	volatile LONG m_Next;	// Index of the next item to run
+};
+
+#endif
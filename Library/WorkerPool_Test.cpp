@@ -0,0 +1,53 @@
+/* Copyright (C) 2026 Rainmeter Project Developers
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StdAfx.h"
+#include "WorkerPool.h"
+#include "../Common/UnitTest.h"
+
+TEST_CLASS(Library_WorkerPool_Test)
+{
+public:
+	TEST_METHOD(TestForEach)
+	{
+		WorkerPool pool;
+
+		int calls = 0;
+		pool.ForEach(0, [&](size_t index) { ++calls; });
+		Assert::AreEqual(0, calls);
+
+		// Each item is run exactly once and all of them are done on return.
+		for (size_t count = 1; count <= 200; count += 13)
+		{
+			std::vector<LONG> runs(count, 0L);
+			pool.ForEach(count, [&](size_t index) { InterlockedIncrement(&runs[index]); });
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Assert::AreEqual(1L, runs[i]);
+			}
+		}
+	}
+
+	TEST_METHOD(TestSlowItems)
+	{
+		WorkerPool pool;
+
+		// Items that take longer are still done on return.
+		volatile LONG done = 0L;
+		const size_t count = pool.GetMaxWorkers() + 1;
+		pool.ForEach(count * 4, [&](size_t index)
+		{
+			if (index % 4 == 0)
+			{
+				Sleep(20UL);
+			}
+			InterlockedIncrement(&done);
+		});
+		Assert::AreEqual((LONG)(count * 4), (LONG)done);
+	}
+};
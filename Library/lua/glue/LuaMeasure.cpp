@@ -16,6 +16,11 @@
 	if (!selfData) return 0; \
 	Measure* self = *(Measure**)selfData;
 
+// Measures that were skipped with LazyMeasures=1 are updated when their value is read.
+#define DECLARE_REFRESHED_SELF(L) \
+	DECLARE_SELF(L) \
+	self->GetSkin()->RefreshMeasure(self);
+
 static int GetName(lua_State* L)
 {
 	DECLARE_SELF(L)
@@ -78,7 +83,7 @@ static int Enable(lua_State* L)
 
 static int GetValue(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 	lua_pushnumber(L, self->GetValue());
 
 	return 1;
@@ -86,7 +91,7 @@ static int GetValue(lua_State* L)
 
 static int GetRelativeValue(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 	lua_pushnumber(L, self->GetRelativeValue());
 
 	return 1;
@@ -94,7 +99,7 @@ static int GetRelativeValue(lua_State* L)
 
 static int GetValueRange(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 	lua_pushnumber(L, self->GetValueRange());
 
 	return 1;
@@ -102,7 +107,7 @@ static int GetValueRange(lua_State* L)
 
 static int GetMinValue(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 	lua_pushnumber(L, self->GetMinValue());
 
 	return 1;
@@ -110,7 +115,7 @@ static int GetMinValue(lua_State* L)
 
 static int GetMaxValue(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 	lua_pushnumber(L, self->GetMaxValue());
 
 	return 1;
@@ -118,7 +123,7 @@ static int GetMaxValue(lua_State* L)
 
 static int GetStringValue(lua_State* L)
 {
-	DECLARE_SELF(L)
+	DECLARE_REFRESHED_SELF(L)
 
 	int top = lua_gettop(L);
 	AUTOSCALE autoScale = (top > 1) ? (AUTOSCALE)(int)lua_tonumber(L, 2) : AUTOSCALE_OFF;
@@ -132,6 +137,66 @@ static int GetStringValue(lua_State* L)
 	return 1;
 }
 
+static void PushNumbers(lua_State* L, const std::vector<double>& values)
+{
+	lua_createtable(L, (int)values.size(), 0);
+	for (size_t i = 0, isize = values.size(); i < isize; ++i)
+	{
+		lua_pushnumber(L, values[i]);
+		lua_rawseti(L, -2, (int)i + 1);
+	}
+}
+
+// Longest history a script can request. Far more than the widest meter graphs.
+static const int c_MaxHistoryLength = 65536;
+
+// Returns the argument at |index| as a length clamped to [0, c_MaxHistoryLength], or -1 if the
+// argument is not a finite number.
+static int ToHistoryLength(lua_State* L, int index)
+{
+	const double value = lua_tonumber(L, index);
+	if (!std::isfinite(value)) return -1;
+	if (value <= 0.0) return 0;
+	return (value >= (double)c_MaxHistoryLength) ? c_MaxHistoryLength : (int)value;
+}
+
+// Returns the last |count| values (oldest first), or the smallest and largest values of |width|
+// buckets of them. Values are recorded from the first call onward.
+static int GetHistory(lua_State* L)
+{
+	DECLARE_SELF(L)
+	const int count = ToHistoryLength(L, 2);
+	int width = ToHistoryLength(L, 3);
+	if (count <= 0 || width < 0)
+	{
+		lua_newtable(L);
+		return 1;
+	}
+
+	// More buckets than values would only repeat values.
+	width = min(width, count);
+
+	const MeasureHistory& history = self->GetUpdateHistory((size_t)count);
+	if (width > 0)
+	{
+		std::vector<double> mins;
+		std::vector<double> maxs;
+		history.Decimate((size_t)count, (size_t)width, mins, maxs);
+		PushNumbers(L, mins);
+		PushNumbers(L, maxs);
+		return 2;
+	}
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; ++i)
+	{
+		lua_pushnumber(L, history.GetValue((size_t)count, (size_t)i));
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 void LuaScript::RegisterMeasure(lua_State* L)
 {
 	const luaL_Reg functions[] =
@@ -147,6 +212,7 @@ void LuaScript::RegisterMeasure(lua_State* L)
 		{ "GetMinValue", GetMinValue },
 		{ "GetMaxValue", GetMaxValue },
 		{ "GetStringValue", GetStringValue },
+		{ "GetHistory", GetHistory },
 		{ nullptr, nullptr }
 	};
 
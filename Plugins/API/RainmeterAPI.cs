@@ -65,6 +65,44 @@ namespace Rainmeter
         [DllImport("Rainmeter.dll", EntryPoint = "RmExecute", CharSet = CharSet.Unicode)]
         public extern static void Execute(IntPtr skin, string command);
 
+        /// <summary>
+        /// Executes a command later on the main thread without waiting for it
+        /// </summary>
+        /// <param name="skin">Pointer to current skin (See API.GetSkin)</param>
+        /// <param name="command">Bang to execute</param>
+        /// <returns>No return type</returns>
+        /// <example>
+        /// <code>
+        /// private static void WorkerThread(object data)
+        /// {
+        ///     Measure measure = (Measure)data;
+        ///     Rainmeter.API.ExecuteAsync(measure->skin, "!SetVariable Progress 50");  // Can be called from any thread
+        /// }
+        /// </code>
+        /// </example>
+        [DllImport("Rainmeter.dll", EntryPoint = "RmExecuteAsync", CharSet = CharSet.Unicode)]
+        public extern static void ExecuteAsync(IntPtr skin, string command);
+
+        /// <summary>
+        /// Executes a command after the given delay without waiting for it
+        /// </summary>
+        /// <param name="skin">Pointer to current skin (See API.GetSkin)</param>
+        /// <param name="command">Bang to execute</param>
+        /// <param name="delay">Delay in milliseconds</param>
+        /// <returns>No return type</returns>
+        /// <example>
+        /// <code>
+        /// [DllExport]
+        /// internal void ExecuteBang(IntPtr data, IntPtr args)
+        /// {
+        ///     Measure measure = (Measure)data;
+        ///     Rainmeter.API.ExecuteDelayed(measure->skin, "!HideMeter Notification", 3000);  // Same as [!Delay 3000][!HideMeter Notification]
+        /// }
+        /// </code>
+        /// </example>
+        [DllImport("Rainmeter.dll", EntryPoint = "RmExecuteDelayed", CharSet = CharSet.Unicode)]
+        public extern static void ExecuteDelayed(IntPtr skin, string command, uint delay);
+
         [DllImport("Rainmeter.dll")]
         private extern static IntPtr RmGet(IntPtr rm, RmGetType type);
 
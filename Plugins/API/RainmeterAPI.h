@@ -220,6 +220,44 @@ LIBRARY_EXPORT LPCWSTR __stdcall RmPathToAbsolute(void* rm, LPCWSTR relativePath
 /// </example>
 LIBRARY_EXPORT void __stdcall RmExecute(void* skin, LPCWSTR command);
 
+/// <summary>
+/// Executes a command later on the main thread without waiting for it
+/// </summary>
+/// <remarks>Can be called from any thread. Commands are executed in the order they were added.</remarks>
+/// <param name="skin">Pointer to current skin (See RmGetSkin)</param>
+/// <param name="command">Bang to execute</param>
+/// <returns>No return type</returns>
+/// <example>
+/// <code>
+/// unsigned __stdcall WorkerThread(void* data)
+/// {
+/// 	Measure* measure = (Measure*)data;
+/// 	RmExecuteAsync(measure->skin, L"!SetVariable Progress 50");  // Does not block until the skin is updated
+/// 	return 0;
+/// }
+/// </code>
+/// </example>
+LIBRARY_EXPORT void __stdcall RmExecuteAsync(void* skin, LPCWSTR command);
+
+/// <summary>
+/// Executes a command after the given delay without waiting for it
+/// </summary>
+/// <remarks>Can be called from any thread. Pending commands are cancelled when the skin is refreshed or closed.</remarks>
+/// <param name="skin">Pointer to current skin (See RmGetSkin)</param>
+/// <param name="command">Bang to execute</param>
+/// <param name="delay">Delay in milliseconds</param>
+/// <returns>No return type</returns>
+/// <example>
+/// <code>
+/// PLUGIN_EXPORT void ExecuteBang(void* data, LPCWSTR args)
+/// {
+/// 	Measure* measure = (Measure*)data;
+/// 	RmExecuteDelayed(measure->skin, L"!HideMeter Notification", 3000);  // Same as [!Delay 3000][!HideMeter Notification]
+/// }
+/// </code>
+/// </example>
+LIBRARY_EXPORT void __stdcall RmExecuteDelayed(void* skin, LPCWSTR command, UINT delay);
+
 /// <summary>
 /// Retrieves data from the measure or skin (use the helper functions instead)
 /// </summary>
@@ -6,20 +6,10 @@
  * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
 
 #include <string>
-#include <thread>
-#include <atomic>
-#include <mutex>
-#include <condition_variable>
-#include <chrono>
 #include <vector>
 #include <Windows.h>
 #include "../API/RainmeterAPI.h"
 
-// Copied from Rainmeter.h
-#define RAINMETER_CLASS_NAME				L"DummyRainWClass"
-#define RAINMETER_WINDOW_NAME				L"Rainmeter control window"
-#define WM_RAINMETER_EXECUTE WM_APP + 2
-
 // Copied from Rainmeter library
 std::vector<std::wstring> Tokenize(const std::wstring& str, const std::wstring& delimiters)
 {
@@ -56,21 +46,11 @@ std::vector<std::wstring> Tokenize(const std::wstring& str, const std::wstring&
 struct Action
 {
 	std::vector<std::wstring> action;
+	UINT run;	// Identifies the current run, 0 when not running
 
-	HWND rainmeterWindow;
-	void* skin;
-	std::mutex mutex;
-	std::atomic<bool> interrupt;
-	std::atomic<bool> isRunning;
-	std::condition_variable signal;
-	std::condition_variable cleanUp;
-
-	Action(HWND _hwnd, void* _skin) :
+	Action() :
 		action(),
-		rainmeterWindow(_hwnd),
-		skin(_skin),
-		interrupt(false),
-		isRunning(false)
+		run(0U)
 	{ }
 };
 
@@ -80,12 +60,17 @@ struct Measure
 	bool ignoreWarnings;
 
 	void* rm;
-	HWND mainRainmeterWindow;
+	void* skin;
+	std::wstring name;
 
-	Measure() : ignoreWarnings(false), rm(nullptr), mainRainmeterWindow(nullptr) { }
+	Measure() : ignoreWarnings(false), rm(nullptr), skin(nullptr) { }
 };
 
-void ExecuteAction(Action* action);
+// Runs are numbered across all measures so that a pending wait of a measure that has been
+// reloaded with the skin can never continue a run of the new measure.
+UINT g_LastRun = 0U;
+
+void ExecuteAction(Measure* measure, size_t index, size_t step);
 
 PLUGIN_EXPORT void Initialize(void** data, void* rm)
 {
@@ -93,15 +78,14 @@ PLUGIN_EXPORT void Initialize(void** data, void* rm)
 	*data = measure;
 
 	measure->rm = rm;
-	measure->mainRainmeterWindow = FindWindow(RAINMETER_CLASS_NAME, RAINMETER_WINDOW_NAME);
+	measure->skin = RmGetSkin(rm);
+	measure->name = RmGetMeasureName(rm);
 }
 
 PLUGIN_EXPORT void Reload(void* data, void* rm, double* maxValue)
 {
 	Measure* measure = (Measure*)data;
 
-	void* skin = RmGetSkin(rm);
-
 	size_t i = 1;
 	std::vector<std::wstring> tokens;
 	std::wstring action = RmReadString(rm, L"ActionList1", L"", FALSE);
@@ -150,13 +134,11 @@ PLUGIN_EXPORT void Reload(void* data, void* rm, double* maxValue)
 
 		if (i <= measure->list.size())
 		{
-			std::lock_guard<std::mutex> lock(measure->list[i - 1]->mutex);
 			measure->list[i - 1]->action = tokens;		// Update the command instead of creating new one
 		}
 		else
 		{
-			Action* act = new Action(measure->mainRainmeterWindow, skin);
-			std::lock_guard<std::mutex> lock(act->mutex);
+			Action* act = new Action;
 			act->action = tokens;
 			measure->list.push_back(act);
 		}
@@ -191,10 +173,12 @@ PLUGIN_EXPORT void ExecuteBang(void* data, LPCWSTR args)
 		size_t number = 0;
 		if (ParseAndValidateIndex(number, 7))
 		{
-			if (!measure->list[number]->isRunning)
+			Action* action = measure->list[number];
+			if (action->run == 0U)
 			{
-				std::thread thread(ExecuteAction, measure->list[number]);
-				thread.detach();
+				if (++g_LastRun == 0U) ++g_LastRun;
+				action->run = g_LastRun;
+				ExecuteAction(measure, number, 0);
 			}
 			else if (!measure->ignoreWarnings)
 			{
@@ -211,22 +195,26 @@ PLUGIN_EXPORT void ExecuteBang(void* data, LPCWSTR args)
 		size_t number;
 		if (ParseAndValidateIndex(number, 4))
 		{
-			measure->list[number]->interrupt = true;
-			measure->list[number]->signal.notify_all();
-
-			// Wait for thread to finish
-			{
-				std::unique_lock<std::mutex> lock(measure->list[number]->mutex);
-				measure->list[number]->cleanUp.wait(lock, [&](){ return measure->list[number]->isRunning == false; });
-			}
-
-			measure->list[number]->interrupt = false;	// reset signal for future use
+			// The pending wait, if any, is ignored when it is over.
+			measure->list[number]->run = 0U;
 		}
 		else if (!measure->ignoreWarnings)
 		{
 			RmLogF(measure->rm, LOG_WARNING, L"Invalid index '%i'", number + 1);
 		}
 	}
+	else if (_wcsnicmp(args, L"CONTINUE ", 9) == 0)
+	{
+		// Internal: scheduled by ExecuteAction() to run the rest of a list after a wait.
+		WCHAR* pos = nullptr;
+		const size_t number = wcstoul(args + 9, &pos, 10);
+		const UINT run = wcstoul(pos, &pos, 10);
+		const size_t step = wcstoul(pos, &pos, 10);
+		if (number < measure->list.size() && run != 0U && measure->list[number]->run == run)
+		{
+			ExecuteAction(measure, number, step);
+		}
+	}
 	else
 	{
 		RmLogF(measure->rm, LOG_ERROR, L"Unknown command: %s", args);
@@ -237,17 +225,9 @@ PLUGIN_EXPORT void Finalize(void* data)
 {
 	Measure* measure = (Measure*)data;
 
+	// Pending waits are cancelled by Rainmeter when the skin is refreshed or closed.
 	for (size_t i = 0; i < measure->list.size(); ++i)
 	{
-		measure->list[i]->interrupt = true;
-		measure->list[i]->signal.notify_all();
-
-		// Wait for thread to finish
-		{
-			std::unique_lock<std::mutex> lock(measure->list[i]->mutex);
-			measure->list[i]->cleanUp.wait(lock, [&](){ return measure->list[i]->isRunning == false; });
-		}
-
 		delete measure->list[i];
 	}
 
@@ -256,37 +236,31 @@ PLUGIN_EXPORT void Finalize(void* data)
 	measure = nullptr;
 }
 
-void ExecuteAction(Action* action)
+void ExecuteAction(Measure* measure, size_t index, size_t step)
 {
-	action->isRunning = true;
+	Action* action = measure->list[index];
 
-	for (size_t i = 0; i < action->action.size(); ++i)
+	for (; step < action->action.size(); ++step)
 	{
-		if (_wcsnicmp(action->action[i].c_str(), L"WAIT ", 5) == 0)
+		const std::wstring& command = action->action[step];
+		if (_wcsnicmp(command.c_str(), L"WAIT ", 5) == 0)
 		{
-			__int64 timeout = _wtoi64(action->action[i].substr(5).c_str());
+			__int64 timeout = _wtoi64(command.substr(5).c_str());
 
 			if (timeout > 0)
 			{
-				std::unique_lock<std::mutex> lock(action->mutex);
-				if (action->signal.wait_for(lock, std::chrono::milliseconds(timeout), [&](){ return action->interrupt == true; }))
-				{
-					// Skin was refreshed or closed, or stopped via command
-					action->isRunning = false;
-					lock.unlock();
-					action->cleanUp.notify_all();
-					return;
-				}
-				else
-				{
-					// Wait is done, so continue to next set of commands
-					continue;
-				}
+				// Rainmeter runs the rest of the list when the wait is over, so no thread is needed
+				// to wait for it.
+				const std::wstring continuation = L"!CommandMeasure \"" + measure->name + L"\" \"Continue " +
+					std::to_wstring(index) + L' ' + std::to_wstring(action->run) + L' ' + std::to_wstring(step + 1) + L'"';
+				RmExecuteDelayed(measure->skin, continuation.c_str(), (UINT)min(timeout, (__int64)MAXUINT));
+				return;
 			}
 		}
 
-		SendNotifyMessage(action->rainmeterWindow, WM_RAINMETER_EXECUTE, (WPARAM)action->skin, (LPARAM)action->action[i].c_str());
+		// Executed after the current command, in order with the continuation.
+		RmExecuteAsync(measure->skin, command.c_str());
 	}
 
-	action->isRunning = false;
+	action->run = 0U;
 }